@@ -28,7 +28,9 @@ function(add_resources out_var id)
   while(options)
     list(POP_FRONT options resource_id in_f_bin)
 
-    set(out_f_cpp "${CMAKE_CURRENT_BINARY_DIR}/${in_f_bin}.cpp")
+    # NB. in_f_bin can be a relative path (eg. to ../firmware), so only use its filename for the output
+    get_filename_component(out_f_name ${in_f_bin} NAME)
+    set(out_f_cpp "${CMAKE_CURRENT_BINARY_DIR}/${out_f_name}.cpp")
     add_custom_command(
       OUTPUT ${out_f_cpp}
       COMMAND xxd -i ${in_f_bin} > ${out_f_cpp}
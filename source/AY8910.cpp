@@ -408,42 +408,52 @@ sound_write_buf_pstereo( libspectrum_signed_word * out, int c )
  * a fairly short routine, and it saves messing about.
  * (XXX ummm, possibly not so true any more :-))
  */
-#define AY_GET_SUBVAL( chan ) \
-  ( level * 2 * ay_tone_tick[ chan ] / tone_count )
-
-#define AY_DO_TONE( var, chan ) \
-  ( var ) = 0;								\
-  is_low = 0;								\
-  if( level ) {								\
-    if( ay_tone_high[ chan ] )						\
-      ( var ) = ( level );						\
-    else {								\
-      ( var ) = -( level );						\
-      is_low = 1;							\
-    }									\
-  }									\
-  									\
-  ay_tone_tick[ chan ] += tone_count;					\
-  count = 0;								\
-  while( ay_tone_tick[ chan ] >= ay_tone_period[ chan ] ) {		\
-    count++;								\
-    ay_tone_tick[ chan ] -= ay_tone_period[ chan ];			\
-    ay_tone_high[ chan ] = !ay_tone_high[ chan ];			\
-    									\
-    /* has to be here, unfortunately... */				\
-    if( count == 1 && level && ay_tone_tick[ chan ] < tone_count ) {	\
-      if( is_low )							\
-        ( var ) += AY_GET_SUBVAL( chan );				\
-      else								\
-        ( var ) -= AY_GET_SUBVAL( chan );				\
-      }									\
-    }									\
-  									\
-  /* if it's changed more than once during the sample, we can't */	\
-  /* represent it faithfully. So, just hope it's a sample.      */	\
-  /* (That said, this should also help avoid aliasing noise.)   */	\
-  if( count > 1 )							\
-    ( var ) = -( level )
+#define AY_GET_SUBVAL( tick ) \
+  ( level * 2 * ( tick ) / tone_count )
+
+/* [TC] This was the AY_DO_TONE() macro. It's now only used for the rare
+ * case of a tone period expiring during the sample (see sound_ay_overlay_multi()).
+ */
+static inline int ay_do_tone( int level, unsigned int *tick, unsigned int *high,
+			      unsigned int period, unsigned int tone_count )
+{
+  int var = 0;
+  int is_low = 0;
+  int count;
+
+  if( level ) {
+    if( *high )
+      var = level;
+    else {
+      var = -level;
+      is_low = 1;
+    }
+  }
+
+  *tick += tone_count;
+  count = 0;
+  while( *tick >= period ) {
+    count++;
+    *tick -= period;
+    *high = !*high;
+
+    /* has to be here, unfortunately... */
+    if( count == 1 && level && *tick < tone_count ) {
+      if( is_low )
+        var += AY_GET_SUBVAL( *tick );
+      else
+        var -= AY_GET_SUBVAL( *tick );
+    }
+  }
+
+  /* if it's changed more than once during the sample, we can't */
+  /* represent it faithfully. So, just hope it's a sample.      */
+  /* (That said, this should also help avoid aliasing noise.)   */
+  if( count > 1 )
+    var = -level;
+
+  return var;
+}
 
 
 #if 0
@@ -471,166 +481,211 @@ sound_write_buf_pstereo( libspectrum_signed_word * out, int c )
 #define HZ_COMMON_DENOMINATOR 50
 #include "Log.h"
 
+/* [TC] The generator state of all the AY's synthesised together by
+ * sound_ay_overlay_multi(): one lane per chip for the envelope & noise
+ * generators, and one lane per channel (chip*3 + channel) for the tone
+ * generators.
+ */
+#define AY_CHAN_MAX ( AY8913::FRAME_MULTI_MAX * 3 )
+
+struct ay_lanes_tag
+{
+  /* per chip */
+  unsigned int tick_incr[ AY8913::FRAME_MULTI_MAX ];
+  unsigned int env_subcycles[ AY8913::FRAME_MULTI_MAX ];
+  unsigned int env_tick[ AY8913::FRAME_MULTI_MAX ];
+  unsigned int env_period[ AY8913::FRAME_MULTI_MAX ];
+  int env_counter[ AY8913::FRAME_MULTI_MAX ];
+  int env_slow[ AY8913::FRAME_MULTI_MAX ];
+  unsigned int tone_subcycles[ AY8913::FRAME_MULTI_MAX ];
+  unsigned int noise_tick[ AY8913::FRAME_MULTI_MAX ];
+  unsigned int noise_period[ AY8913::FRAME_MULTI_MAX ];
+  unsigned int noise_count[ AY8913::FRAME_MULTI_MAX ];
+  int noise_toggle[ AY8913::FRAME_MULTI_MAX ];
+  int noise_slow[ AY8913::FRAME_MULTI_MAX ];
+
+  /* per channel */
+  unsigned int tone_tick[ AY_CHAN_MAX ];
+  unsigned int tone_high[ AY_CHAN_MAX ];
+  unsigned int tone_period[ AY_CHAN_MAX ];
+  unsigned int tone_count[ AY_CHAN_MAX ];
+  int tone_level[ AY_CHAN_MAX ];
+  int tone_on[ AY_CHAN_MAX ];
+  int tone_slow[ AY_CHAN_MAX ];
+  int noise_mute[ AY_CHAN_MAX ];
+  int chan[ AY_CHAN_MAX ];
+};
+
 void AY8913::sound_ay_overlay( void )
 {
-  int tone_level[3];
-  int mixer, envshape;
-  int f, g, level, count;
-//  libspectrum_signed_word *ptr;
-  struct ay_change_tag *change_ptr = ay_change;
-  int changes_left = ay_change_count;
-  int reg, r;
-  int is_low;
-  int chan1, chan2, chan3;
-  unsigned int tone_count, noise_count;
+  AY8913 *chip = this;
+  sound_ay_overlay_multi( &chip, 1 );
+}
+
+/* [TC] Synthesise a frame for all the chips together. Each sample, every
+ * generator first takes its common case - the period doesn't expire during
+ * the sample - branch-free across all the lanes, so the compiler can
+ * vectorise it. The lanes where the period does expire then run FUSE's
+ * original code, so the output is sample-identical to synthesising each
+ * chip on its own. Unused lanes are left idle (no tone, and periods that
+ * never expire).
+ */
+void AY8913::sound_ay_overlay_multi( AY8913 *const chips[], int num_chips )
+{
+  struct ay_lanes_tag lanes;
+  struct ay_lanes_tag *l = &lanes;
+  struct ay_change_tag *change_ptr[ FRAME_MULTI_MAX ];
+  int changes_left[ FRAME_MULTI_MAX ];
+  int levels_dirty[ FRAME_MULTI_MAX ];
+  libspectrum_signed_word *pBuf[ AY_CHAN_MAX ];
+  const int num_chans = num_chips * 3;
+  const int framesiz = chips[0]->sound_generator_framesiz;
+  int c, g, i, f, reg, r, slow;
   libspectrum_dword sfreq, cpufreq;
 
-///* If no AY chip, don't produce any AY sound (!) */
-//  if( !machine_current->capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_AY )
-//    return;
+  _ASSERT( num_chips >= 1 && num_chips <= FRAME_MULTI_MAX );
+
+  memset( l, 0, sizeof( *l ) );
+  for( c = 0; c < FRAME_MULTI_MAX; c++ )
+    l->env_period[c] = l->noise_period[c] = (unsigned int)-1;
+  for( i = 0; i < AY_CHAN_MAX; i++ )
+    l->tone_period[i] = (unsigned int)-1;
 
 /* convert change times to sample offsets, use common denominator of 50 to
    avoid overflowing a dword */
-  sfreq = sound_generator_freq / HZ_COMMON_DENOMINATOR;
 //  cpufreq = machine_current->timings.processor_speed / HZ_COMMON_DENOMINATOR;
   cpufreq = (libspectrum_dword) (m_fCurrentCLK_AY8910 / HZ_COMMON_DENOMINATOR);	// [TC]
-  int dbgCount=0;
-  for( f = 0; f < ay_change_count; f++ )
-  {
-    ay_change[f].ofs = (USHORT) (( ay_change[f].tstates * sfreq ) / cpufreq);	// [TC] Added cast
 
-	if (ay_change[f].ofs >= sound_generator_framesiz)	// [TC] Ensure that all ay_change's get processed
-	{
-		ay_change[f].ofs = sound_generator_framesiz-1;	// [TC] - as parent, sound_frame(), just dumps outstanding changes (ay_change_count=0)
-		dbgCount++;
-	}
-  }
-#if defined(_DEBUG) && 0
-  if (dbgCount)
-  {
-	  LogOutput("ay_change: saved %d\n", dbgCount);	// [TC] previously would've been dumped!
-  }
-#endif
+  for( c = 0; c < num_chips; c++ ) {
+    AY8913 *ay = chips[c];
+    _ASSERT( ay->sound_generator_framesiz == framesiz );
 
-  libspectrum_signed_word* pBuf1 = ppSoundBuffers[0];
-  libspectrum_signed_word* pBuf2 = ppSoundBuffers[1];
-  libspectrum_signed_word* pBuf3 = ppSoundBuffers[2];
+    sfreq = ay->sound_generator_freq / HZ_COMMON_DENOMINATOR;
+    for( f = 0; f < ay->ay_change_count; f++ ) {
+      ay->ay_change[f].ofs = (USHORT) (( ay->ay_change[f].tstates * sfreq ) / cpufreq);	// [TC] Added cast
 
-//  for( f = 0, ptr = sound_buf; f < sound_generator_framesiz; f++ ) {
-  for( f = 0; f < sound_generator_framesiz; f++ ) {
+      if( ay->ay_change[f].ofs >= framesiz )	// [TC] Ensure that all ay_change's get processed
+        ay->ay_change[f].ofs = framesiz-1;	// [TC] - as parent, sound_frame(), just dumps outstanding changes (ay_change_count=0)
+    }
+
+    change_ptr[c] = ay->ay_change;
+    changes_left[c] = ay->ay_change_count;
+    levels_dirty[c] = 1;
+
+    /* gather the generator state into the lanes */
+    l->tick_incr[c] = ay->ay_tick_incr;
+    l->env_subcycles[c] = ay->ay_env_subcycles;
+    l->env_tick[c] = ay->ay_env_tick;
+    l->env_period[c] = ay->ay_env_period;
+    l->env_counter[c] = ay->env_counter;
+    l->tone_subcycles[c] = ay->ay_tone_subcycles;
+    l->noise_tick[c] = ay->ay_noise_tick;
+    l->noise_period[c] = ay->ay_noise_period;
+    l->noise_toggle[c] = ay->noise_toggle;
+
+    for( g = 0; g < 3; g++ ) {
+      i = c * 3 + g;
+      l->tone_tick[i] = ay->ay_tone_tick[g];
+      l->tone_high[i] = ay->ay_tone_high[g];
+      l->tone_period[i] = ay->ay_tone_period[g];
+      pBuf[i] = ay->ppSoundBuffers[g];
+    }
+  }
+
+  for( f = 0; f < framesiz; f++ ) {
     /* update ay registers. All this sub-frame change stuff
      * is pretty hairy, but how else would you handle the
      * samples in Robocop? :-) It also clears up some other
      * glitches.
      */
-    while( changes_left && f >= change_ptr->ofs ) {
-      sound_ay_registers[ reg = change_ptr->reg ] = change_ptr->val;
-      change_ptr++;
-      changes_left--;
-
-      /* fix things as needed for some register changes */
-      switch ( reg ) {
-      case 0:
-      case 1:
-      case 2:
-      case 3:
-      case 4:
-      case 5:
-	r = reg >> 1;
-	/* a zero-len period is the same as 1 */
-	ay_tone_period[r] = ( sound_ay_registers[ reg & ~1 ] |
-			      ( sound_ay_registers[ reg | 1 ] & 15 ) << 8 );
-	if( !ay_tone_period[r] )
-	  ay_tone_period[r]++;
-
-	/* important to get this right, otherwise e.g. Ghouls 'n' Ghosts
-	 * has really scratchy, horrible-sounding vibrato.
-	 */
-	if( ay_tone_tick[r] >= ay_tone_period[r] * 2 )
-	  ay_tone_tick[r] %= ay_tone_period[r] * 2;
-	break;
-      case 6:
-	ay_noise_tick = 0;
-	ay_noise_period = ( sound_ay_registers[ reg ] & 31 );
-	break;
-      case 11:
-      case 12:
-	/* this one *isn't* fixed-point */
-	ay_env_period =
-	  sound_ay_registers[11] | ( sound_ay_registers[12] << 8 );
-	break;
-      case 13:
-	ay_env_internal_tick = ay_env_tick = ay_env_subcycles = 0;
-	env_first = 1;
-	env_rev = 0;
-	env_counter = ( sound_ay_registers[13] & AY_ENV_ATTACK ) ? 0 : 15;
-	break;
+    for( c = 0; c < num_chips; c++ ) {
+      AY8913 *ay = chips[c];
+
+      while( changes_left[c] && f >= change_ptr[c]->ofs ) {
+        ay->sound_ay_registers[ reg = change_ptr[c]->reg ] = change_ptr[c]->val;
+        change_ptr[c]++;
+        changes_left[c]--;
+        levels_dirty[c] = 1;
+
+        /* fix things as needed for some register changes */
+        switch ( reg ) {
+        case 0:
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+        case 5:
+	  r = c * 3 + ( reg >> 1 );
+	  /* a zero-len period is the same as 1 */
+	  l->tone_period[r] = ( ay->sound_ay_registers[ reg & ~1 ] |
+				( ay->sound_ay_registers[ reg | 1 ] & 15 ) << 8 );
+	  if( !l->tone_period[r] )
+	    l->tone_period[r]++;
+
+	  /* important to get this right, otherwise e.g. Ghouls 'n' Ghosts
+	   * has really scratchy, horrible-sounding vibrato.
+	   */
+	  if( l->tone_tick[r] >= l->tone_period[r] * 2 )
+	    l->tone_tick[r] %= l->tone_period[r] * 2;
+	  break;
+        case 6:
+	  l->noise_tick[c] = 0;
+	  l->noise_period[c] = ( ay->sound_ay_registers[ reg ] & 31 );
+	  break;
+        case 11:
+        case 12:
+	  /* this one *isn't* fixed-point */
+	  l->env_period[c] =
+	    ay->sound_ay_registers[11] | ( ay->sound_ay_registers[12] << 8 );
+	  break;
+        case 13:
+	  ay->ay_env_internal_tick = l->env_tick[c] = l->env_subcycles[c] = 0;
+	  ay->env_first = 1;
+	  ay->env_rev = 0;
+	  l->env_counter[c] = ( ay->sound_ay_registers[13] & AY_ENV_ATTACK ) ? 0 : 15;
+	  break;
+        }
       }
-    }
-
-    /* the tone level if no enveloping is being used */
-    for( g = 0; g < 3; g++ )
-      tone_level[g] = ay_tone_levels[ sound_ay_registers[ 8 + g ] & 15 ];
 
-    /* envelope */
-    envshape = sound_ay_registers[13];
-    level = ay_tone_levels[ env_counter ];
+      /* the tone level: the envelope's, or the volume's if no enveloping
+       * is being used. And which of tone & noise are mixed in.
+       * (Only changes with the registers, envelope counter or noise toggle)
+       */
+      if( levels_dirty[c] ) {
+	const int level = ay->ay_tone_levels[ l->env_counter[c] ];
+	const int mixer = ay->sound_ay_registers[7];
+
+	for( g = 0; g < 3; g++ ) {
+	  const int vol = ay->sound_ay_registers[ 8 + g ];
+	  i = c * 3 + g;
+	  l->tone_level[i] = ( vol & 16 ) ? level : (int)ay->ay_tone_levels[ vol & 15 ];
+	  l->tone_on[i] = ( mixer & ( 0x01 << g ) ) == 0;
+	  l->noise_mute[i] = ( mixer & ( 0x08 << g ) ) == 0 && l->noise_toggle[c];
+	}
 
-    for( g = 0; g < 3; g++ )
-      if( sound_ay_registers[ 8 + g ] & 16 )
-	tone_level[g] = level;
+	levels_dirty[c] = 0;
+      }
+    }
 
     /* envelope output counter gets incr'd every 16 AY cycles.
-     * Has to be a while, as this is sub-output-sample res.
+     * (ie. once per noise_count)
      */
-    ay_env_subcycles += ay_tick_incr;
-    noise_count = 0;
-    while( ay_env_subcycles >= ( 16 << 16 ) ) {
-      ay_env_subcycles -= ( 16 << 16 );
-      noise_count++;
-      ay_env_tick++;
-      while( ay_env_tick >= ay_env_period ) {
-	ay_env_tick -= ay_env_period;
-
-	/* do a 1/16th-of-period incr/decr if needed */
-	if( env_first ||
-	    ( ( envshape & AY_ENV_CONT ) && !( envshape & AY_ENV_HOLD ) ) ) {
-	  if( env_rev )
-	    env_counter -= ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
-	  else
-	    env_counter += ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
-	  if( env_counter < 0 )
-	    env_counter = 0;
-	  if( env_counter > 15 )
-	    env_counter = 15;
-	}
-
-	ay_env_internal_tick++;
-	while( ay_env_internal_tick >= 16 ) {
-	  ay_env_internal_tick -= 16;
-
-	  /* end of cycle */
-	  if( !( envshape & AY_ENV_CONT ) )
-	    env_counter = 0;
-	  else {
-	    if( envshape & AY_ENV_HOLD ) {
-	      if( env_first && ( envshape & AY_ENV_ALT ) )
-		env_counter = ( env_counter ? 0 : 15 );
-	    } else {
-	      /* non-hold */
-	      if( envshape & AY_ENV_ALT )
-		env_rev = !env_rev;
-	      else
-		env_counter = ( envshape & AY_ENV_ATTACK ) ? 0 : 15;
-	    }
-	  }
-
-	  env_first = 0;
-	}
+    slow = 0;
+    for( c = 0; c < FRAME_MULTI_MAX; c++ ) {
+      const unsigned int subcycles = l->env_subcycles[c] + l->tick_incr[c];
+      const unsigned int count = subcycles >> 20;	/* / ( 16 << 16 ) */
+
+      l->env_slow[c] = count && l->env_tick[c] + count >= l->env_period[c];
+      l->env_subcycles[c] = l->env_slow[c] ? subcycles : ( subcycles & ( ( 16 << 16 ) - 1 ) );
+      l->env_tick[c] += l->env_slow[c] ? 0 : count;
+      l->noise_count[c] = count;
+      slow |= l->env_slow[c];
+    }
 
-	/* don't keep trying if period is zero */
-	if( !ay_env_period )
-	  break;
+    for( c = 0; slow && c < num_chips; c++ ) {
+      if( l->env_slow[c] ) {
+	chips[c]->sound_ay_envelope( &l->env_subcycles[c], &l->env_tick[c], l->env_period[c], &l->env_counter[c] );
+	levels_dirty[c] = 1;
       }
     }
 
@@ -639,93 +694,152 @@ void AY8913::sound_ay_overlay( void )
      * level out unmodified. This is used by some sample-playing
      * stuff.)
      */
-    chan1 = tone_level[0];
-    chan2 = tone_level[1];
-    chan3 = tone_level[2];
-    mixer = sound_ay_registers[7];
-
-    ay_tone_subcycles += ay_tick_incr;
-    tone_count = ay_tone_subcycles >> ( 3 + 16 );
-    ay_tone_subcycles &= ( 8 << 16 ) - 1;
-
-    if( ( mixer & 1 ) == 0 ) {
-      level = chan1;
-      AY_DO_TONE( chan1, 0 );
+    for( c = 0; c < FRAME_MULTI_MAX; c++ ) {
+      const unsigned int subcycles = l->tone_subcycles[c] + l->tick_incr[c];
+
+      l->tone_subcycles[c] = subcycles & ( ( 8 << 16 ) - 1 );
+      for( g = 0; g < 3; g++ )
+	l->tone_count[ c * 3 + g ] = subcycles >> ( 3 + 16 );
     }
-    if( ( mixer & 0x08 ) == 0 && noise_toggle )
-      chan1 = 0;
 
-    if( ( mixer & 2 ) == 0 ) {
-      level = chan2;
-      AY_DO_TONE( chan2, 1 );
+    slow = 0;
+    for( i = 0; i < AY_CHAN_MAX; i++ ) {
+      const int level = l->tone_level[i];
+      const unsigned int tick = l->tone_tick[i] + l->tone_count[i];
+
+      l->tone_slow[i] = l->tone_on[i] & ( tick >= l->tone_period[i] );
+      l->tone_tick[i] = ( l->tone_on[i] & !l->tone_slow[i] ) ? tick : l->tone_tick[i];
+      l->chan[i] = ( l->tone_on[i] & !l->tone_high[i] ) ? -level : level;
+      slow |= l->tone_slow[i];
     }
-    if( ( mixer & 0x10 ) == 0 && noise_toggle )
-      chan2 = 0;
 
-    if( ( mixer & 4 ) == 0 ) {
-      level = chan3;
-      AY_DO_TONE( chan3, 2 );
+    for( i = 0; slow && i < num_chans; i++ ) {
+      if( l->tone_slow[i] )
+	l->chan[i] = ay_do_tone( l->tone_level[i], &l->tone_tick[i], &l->tone_high[i], l->tone_period[i], l->tone_count[i] );
     }
-    if( ( mixer & 0x20 ) == 0 && noise_toggle )
-      chan3 = 0;
 
     /* write the sample(s) */
-	*pBuf1++ = chan1;	// [TC]
-	*pBuf2++ = chan2;	// [TC]
-	*pBuf3++ = chan3;	// [TC]
-#if 0
-    if( !sound_stereo ) {
-      /* mono */
-      ( *ptr++ ) += chan1 + chan2 + chan3;
-    } else {
-      if( !sound_stereo_ay ) {
-	/* stereo output, but mono AY sound; still,
-	 * incr separately in case of beeper pseudostereo.
-	 */
-	( *ptr++ ) += chan1 + chan2 + chan3;
-	( *ptr++ ) += chan1 + chan2 + chan3;
-      } else {
-	/* stereo with ACB/ABC AY positioning.
-	 * Here we use real stereo positions for the channels.
-	 * Just because, y'know, it's cool and stuff. No, really. :-)
-	 * This is a little tricky, as it works by delaying sounds
-	 * on the left or right channels to model the delay you get
-	 * in the real world when sounds originate at different places.
-	 */
-	GEN_STEREO( rchan1pos, chan1 );
-	GEN_STEREO( rchan2pos, chan2 );
-	GEN_STEREO( rchan3pos, chan3 );
-	( *ptr++ ) += rstereobuf_l[ rstereopos ];
-	( *ptr++ ) += rstereobuf_r[ rstereopos ];
-	rstereobuf_l[ rstereopos ] = rstereobuf_r[ rstereopos ] = 0;
-	rstereopos++;
-	if( rstereopos >= STEREO_BUF_SIZE )
-	  rstereopos = 0;
+    for( i = 0; i < num_chans; i++ )
+      pBuf[i][f] = l->noise_mute[i] ? 0 : l->chan[i];	// [TC]
+
+    /* update noise RNG/filter */
+    slow = 0;
+    for( c = 0; c < FRAME_MULTI_MAX; c++ ) {
+      l->noise_tick[c] += l->noise_count[c];
+      l->noise_slow[c] = l->noise_tick[c] >= l->noise_period[c];
+      slow |= l->noise_slow[c];
+    }
+
+    for( c = 0; slow && c < num_chips; c++ ) {
+      if( l->noise_slow[c] ) {
+	chips[c]->sound_ay_noise( &l->noise_tick[c], l->noise_period[c], &l->noise_toggle[c] );
+	levels_dirty[c] = 1;
       }
     }
-#endif
+  }
 
-    /* update noise RNG/filter */
-    ay_noise_tick += noise_count;
-    while( ay_noise_tick >= ay_noise_period ) {
-      ay_noise_tick -= ay_noise_period;
+  /* scatter the lanes back */
+  for( c = 0; c < num_chips; c++ ) {
+    AY8913 *ay = chips[c];
+
+    ay->ay_env_subcycles = l->env_subcycles[c];
+    ay->ay_env_tick = l->env_tick[c];
+    ay->ay_env_period = l->env_period[c];
+    ay->env_counter = l->env_counter[c];
+    ay->ay_tone_subcycles = l->tone_subcycles[c];
+    ay->ay_noise_tick = l->noise_tick[c];
+    ay->ay_noise_period = l->noise_period[c];
+    ay->noise_toggle = l->noise_toggle[c];
+
+    for( g = 0; g < 3; g++ ) {
+      i = c * 3 + g;
+      ay->ay_tone_tick[g] = l->tone_tick[i];
+      ay->ay_tone_high[g] = l->tone_high[i];
+      ay->ay_tone_period[g] = l->tone_period[i];
+    }
+  }
+}
 
-      if( ( rng & 1 ) ^ ( ( rng & 2 ) ? 1 : 0 ) )
-	noise_toggle = !noise_toggle;
+/* the envelope, when its period expires during the sample. Starts from
+ * this sample's subcycles (incl. ay_tick_incr).
+ */
+void AY8913::sound_ay_envelope( unsigned int *subcycles, unsigned int *tick,
+				unsigned int period, int *counter )
+{
+  const int envshape = sound_ay_registers[13];
+
+  while( *subcycles >= ( 16 << 16 ) ) {
+    *subcycles -= ( 16 << 16 );
+    ( *tick )++;
+    while( *tick >= period ) {
+      *tick -= period;
+
+      /* do a 1/16th-of-period incr/decr if needed */
+      if( env_first ||
+	  ( ( envshape & AY_ENV_CONT ) && !( envshape & AY_ENV_HOLD ) ) ) {
+	if( env_rev )
+	  *counter -= ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
+	else
+	  *counter += ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
+	if( *counter < 0 )
+	  *counter = 0;
+	if( *counter > 15 )
+	  *counter = 15;
+      }
 
-      /* rng is 17-bit shift reg, bit 0 is output.
-       * input is bit 0 xor bit 2.
-       */
-      rng |= ( ( rng & 1 ) ^ ( ( rng & 4 ) ? 1 : 0 ) ) ? 0x20000 : 0;
-      rng >>= 1;
+      ay_env_internal_tick++;
+      while( ay_env_internal_tick >= 16 ) {
+	ay_env_internal_tick -= 16;
+
+	/* end of cycle */
+	if( !( envshape & AY_ENV_CONT ) )
+	  *counter = 0;
+	else {
+	  if( envshape & AY_ENV_HOLD ) {
+	    if( env_first && ( envshape & AY_ENV_ALT ) )
+	      *counter = ( *counter ? 0 : 15 );
+	  } else {
+	    /* non-hold */
+	    if( envshape & AY_ENV_ALT )
+	      env_rev = !env_rev;
+	    else
+	      *counter = ( envshape & AY_ENV_ATTACK ) ? 0 : 15;
+	  }
+	}
+
+	env_first = 0;
+      }
 
       /* don't keep trying if period is zero */
-      if( !ay_noise_period )
+      if( !period )
 	break;
     }
   }
 }
 
+/* the noise RNG/filter, when its period expires during the sample. Starts
+ * from this sample's tick (incl. noise_count).
+ */
+void AY8913::sound_ay_noise( unsigned int *tick, unsigned int period, int *toggle )
+{
+  while( *tick >= period ) {
+    *tick -= period;
+
+    if( ( rng & 1 ) ^ ( ( rng & 2 ) ? 1 : 0 ) )
+      *toggle = !*toggle;
+
+    /* rng is 17-bit shift reg, bit 0 is output.
+     * input is bit 0 xor bit 2.
+     */
+    rng |= ( ( rng & 1 ) ^ ( ( rng & 4 ) ? 1 : 0 ) ) ? 0x20000 : 0;
+    rng >>= 1;
+
+    /* don't keep trying if period is zero */
+    if( !period )
+      break;
+  }
+}
+
 BYTE AY8913::sound_ay_read( int reg )
 {
 	reg &= 15;
@@ -926,6 +1040,19 @@ void AY8913::sound_frame( void )
   ay_change_count = 0;
 }
 
+/* [TC] sound_frame() for several AY's (of the same frame size) at once,
+ * so that they can be synthesised in parallel lanes.
+ */
+void AY8913::sound_frame_multi( AY8913 *const chips[], int num_chips )
+{
+  int c;
+
+  sound_ay_overlay_multi( chips, num_chips );
+
+  for( c = 0; c < num_chips; c++ )
+    chips[c]->ay_change_count = 0;
+}
+
 #if 0
 /* two beepers are supported - the real beeper (call with is_tape==0)
  * and a `fake' beeper which lets you hear when a tape is being played.
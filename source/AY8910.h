@@ -25,6 +25,7 @@ public:
 	void sound_ay_write( int reg, int val, libspectrum_dword now );
 	void sound_ay_reset( void );
 	void sound_frame( void );
+	static void sound_frame_multi( AY8913 *const chips[], int num_chips );
 	BYTE* GetAYRegsPtr( void ) { return &sound_ay_registers[0]; }
 	void SetFramesize(int frameSize) { sound_generator_framesiz = frameSize; }
 	void SetSoundBuffers(INT16** buffers) { ppSoundBuffers = buffers; }
@@ -32,10 +33,15 @@ public:
 	void SaveSnapshot(class YamlSaveHelper& yamlSaveHelper, const std::string& suffix);
 	bool LoadSnapshot(class YamlLoadHelper& yamlLoadHelper, const std::string& suffix);
 
+	static const int FRAME_MULTI_MAX = 4;	// Max AY's synthesised together by sound_frame_multi()
+
 private:
 	void init( void );
 	void sound_end( void );
 	void sound_ay_overlay( void );
+	static void sound_ay_overlay_multi( AY8913 *const chips[], int num_chips );
+	void sound_ay_envelope( unsigned int *subcycles, unsigned int *tick, unsigned int period, int *counter );
+	void sound_ay_noise( unsigned int *tick, unsigned int period, int *toggle );
 
 private:
 	/* foo_subcycles are fixed-point with low 16 bits as fractional part.
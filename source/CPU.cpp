@@ -96,6 +96,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "SynchronousEventManager.h"
 #include "NTSC.h"
 #include "Log.h"
+#include "PerfCounters.h"
 
 #include "z80emu.h"
 #include "Z80VICE/z80.h"
@@ -157,6 +158,7 @@ void SetMainCpu(eCpuType cpu)
 		return;
 
 	g_MainCPU = cpu;
+	CpuUpdateCoreSelection();
 }
 
 static bool IsCpu65C02(eApple2Type apple2Type)
@@ -368,7 +370,7 @@ static __forceinline void Fetch(BYTE& iOpcode, ULONG uExecutedCycles)
 #endif
 
 	iOpcode = ((PC & 0xF000) == 0xC000)
-	    ? IORead[(PC>>4) & 0xFF](PC,PC,0,0,uExecutedCycles)	// Fetch opcode from I/O memory, but params are still from mem[]
+	    ? (g_SynchronousEventMgr.SetCyclesNow(uExecutedCycles), IORead[(PC>>4) & 0xFF](PC,PC,0,0,uExecutedCycles))	// Fetch opcode from I/O memory, but params are still from mem[]
 		: *(mem+PC);
 
 #ifdef USE_SPEECH_API
@@ -440,9 +442,11 @@ static __forceinline bool NMI(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 #endif
 }
 
+// The SyncEvent list is only updated when the next event is due, not after every opcode
 static __forceinline void CheckSynchronousInterruptSources(UINT cycles, ULONG uExecutedCycles)
 {
-	g_SynchronousEventMgr.Update(cycles, uExecutedCycles);
+	if (uExecutedCycles >= g_SynchronousEventMgr.GetNextEventCycles())
+		g_SynchronousEventMgr.Update(cycles, uExecutedCycles);
 }
 
 static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn, BOOL& flagv, BOOL& flagz)
@@ -511,10 +515,13 @@ static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 #define HEATMAP_X(address)
 
 // 6502 & no debugger
-#define READ(addr) _READ_WITH_IO_F8xx(addr)
-#define WRITE(value) _WRITE_WITH_IO_F8xx(value)
+// . specialised at compile-time for the $F8xx (NSC for II/II+) & VidHD checks - see CpuUpdateCoreSelection()
+#define CPU_TEMPLATE_PARAMS template <bool kIoF8xx, bool kVidHD>
+#define READ(addr) _READ_SPECIALISED(addr)
+#define WRITE(value) _WRITE_SPECIALISED(value)
 
 #include "CPU/cpu6502.h"  // MOS 6502
+#undef CPU_TEMPLATE_PARAMS
 
 //-------
 
@@ -605,6 +612,25 @@ static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 
 //===========================================================================
 
+typedef uint32_t (*CpuCoreFunc)(uint32_t uTotalCycles, const bool bVideoUpdate);
+
+static CpuCoreFunc g_pCpu6502 = Cpu6502<true, true>;	// Safe (unspecialised) until CpuUpdateCoreSelection() is called
+
+// Select the Cpu6502 specialisation for the current h/w config:
+// . $F8xx needs to be routed via IO_F8xx() for a II/II+ with a NSC, or if a VidHD card is present (GH#827, GH#997)
+// . Otherwise $F8xx is plain memory & memVidHD is always NULL, so these per-access checks can be compiled out
+// Called whenever the config it depends on changes: CPU/model type, slot-3 card and NSC insert/remove
+void CpuUpdateCoreSelection(void)
+{
+	const bool hasVidHD = GetCardMgr().QuerySlot(SLOT3) == CT_VidHD;
+	const bool hasIoF8xx = hasVidHD || (IS_APPLE2 && MemHasNoSlotClock());
+
+	if (hasVidHD)
+		g_pCpu6502 = Cpu6502<true, true>;
+	else
+		g_pCpu6502 = hasIoF8xx ? Cpu6502<true, false> : Cpu6502<false, false>;
+}
+
 static uint32_t InternalCpuExecute(const uint32_t uTotalCycles, const bool bVideoUpdate)
 {
 	if (g_nAppMode == MODE_RUNNING || g_nAppMode == MODE_BENCHMARK)
@@ -619,7 +645,7 @@ static uint32_t InternalCpuExecute(const uint32_t uTotalCycles, const bool bVide
 		}
 
 		if (GetMainCpu() == CPU_6502)
-			return Cpu6502(uTotalCycles, bVideoUpdate);		// Apple ][, ][+, //e, Clones
+			return g_pCpu6502(uTotalCycles, bVideoUpdate);	// Apple ][, ][+, //e, Clones
 		else
 			return Cpu65C02(uTotalCycles, bVideoUpdate);	// Enhanced Apple //e
 	}
@@ -724,6 +750,7 @@ uint32_t CpuExecute(const uint32_t uCycles, const bool bVideoUpdate)
 	extern UINT64 g_timeCpu;
 	PerfMarker perfMarker(g_timeCpu);
 #endif
+	const UINT64 perfStart = PerfCounters_Now();
 
 	g_nCyclesExecuted =	0;
 	g_interruptInLastExecutionBatch = false;
@@ -737,14 +764,22 @@ uint32_t CpuExecute(const uint32_t uCycles, const bool bVideoUpdate)
 	//  >0  : Do multi-opcode emulation
 	const uint32_t uExecutedCycles = InternalCpuExecute(uCycles, bVideoUpdate);
 
-	// Update 6522s (NB. Do this before updating g_nCumulativeCycles below)
-	// . Ensures that 6522 regs are up-to-date for any potential save-state
+	// The next batch's uExecutedCycles start from 0 again
+	g_SynchronousEventMgr.EndExecute(uExecutedCycles);
+
+	// Update Mockingboards' cycle count (NB. Do this before updating g_nCumulativeCycles below)
+	// . The 6522 TIMER1/2 counters themselves are only caught-up when observed (IO access, save-state, debugger)
 	// . SyncEvent will trigger the 6522 TIMER1/2 underflow on the correct cycle
 	GetCardMgr().GetMockingboardCardMgr().UpdateCycles(uExecutedCycles);
 
 	const UINT nRemainingCycles = uExecutedCycles - g_nCyclesExecuted;
 	g_nCumulativeCycles	+= nRemainingCycles;
 
+	const UINT64 perfEnd = PerfCounters_Now();
+	PerfCounters_Add(PERF_CPU_NS, perfEnd - perfStart);
+	PerfCounters_Add(PERF_CYCLES, uExecutedCycles);
+	PerfCounters_Tick(perfEnd);
+
 	return uExecutedCycles;
 }
 
@@ -780,6 +815,8 @@ void CpuInitialize(void)
 
 	z80mem_initialize();
 	z80_reset();
+
+	CpuUpdateCoreSelection();
 }
 
 //===========================================================================
@@ -35,6 +35,7 @@ ULONG   CpuGetCyclesThisVideoFrame(ULONG nExecutedCycles);
 void    CpuCreateCriticalSection(void);
 void    CpuInitialize(void);
 void    CpuSetupBenchmark ();
+void    CpuUpdateCoreSelection(void);
 void	CpuIrqReset();
 void	CpuIrqAssert(eIRQSRC Device);
 void	CpuIrqDeassert(eIRQSRC Device);
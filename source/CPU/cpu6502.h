@@ -78,6 +78,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 //===========================================================================
 
+// Optional template parameters for compile-time specialisation (eg. template <bool kIoF8xx, bool kVidHD>)
+#ifdef CPU_TEMPLATE_PARAMS
+CPU_TEMPLATE_PARAMS
+#endif
 static uint32_t Cpu6502(uint32_t uTotalCycles, const bool bVideoUpdate)
 {
 	WORD addr;
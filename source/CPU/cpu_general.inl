@@ -67,21 +67,25 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 				regs.sp = _6502_STACK_END;										\
 		}
 
+// I/O handlers can insert/remove SyncEvents, so first tell the SynchronousEventManager the current cycle
+#define _IO_READ(addr)		(g_SynchronousEventMgr.SetCyclesNow(uExecutedCycles), IORead[(addr>>4) & 0xFF](regs.pc,addr,0,0,uExecutedCycles))
+#define _IO_WRITE(addr, a)	{ g_SynchronousEventMgr.SetCyclesNow(uExecutedCycles); IOWrite[(addr>>4) & 0xFF](regs.pc,addr,1,(BYTE)(a),uExecutedCycles); }
+
 #define _READ(addr)	(															\
 			((addr & 0xF000) == APPLE_IO_BEGIN)									\
-				? IORead[(addr>>4) & 0xFF](regs.pc,addr,0,0,uExecutedCycles)	\
+				? _IO_READ(addr)												\
 				: *(mem+addr)													\
 		)
 #define _READ_ALT(addr) (														\
 			(memreadPageType[addr >> 8] == MEM_Normal)							\
 				? *(memshadow[addr >> 8]+(addr&0xff))							\
 				: (memreadPageType[addr >> 8] == MEM_IORead)					\
-					? IORead[(addr >> 4) & 0xFF](regs.pc, addr, 0, 0, uExecutedCycles)	\
+					? _IO_READ(addr)											\
 					: MemReadFloatingBus(uExecutedCycles)						\
 		)
 #define _READ_WITH_IO_F8xx(addr) (									/* GH#827 */\
 			((addr & 0xF000) == APPLE_IO_BEGIN)									\
-				? IORead[(addr>>4) & 0xFF](regs.pc,addr,0,0,uExecutedCycles)	\
+				? _IO_READ(addr)												\
 				: (addr >= 0xF800)												\
 					? IO_F8xx(regs.pc,addr,0,0,uExecutedCycles)					\
 					: *(mem+addr)												\
@@ -100,7 +104,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 				if (page)																\
 					*(page+(addr & 0xFF)) = (BYTE)(a);									\
 				else if ((addr & 0xF000) == APPLE_IO_BEGIN)								\
-					IOWrite[(addr>>4) & 0xFF](regs.pc,addr,1,(BYTE)(a),uExecutedCycles);\
+					_IO_WRITE(addr, a)													\
 			}																			\
 		}
 #define _WRITE_ALT(a) {																	\
@@ -113,7 +117,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 						*(memVidHD + addr) = (BYTE)(a);									\
 				}																		\
 				else if ((addr & 0xF000) == APPLE_IO_BEGIN)								\
-					IOWrite[(addr>>4) & 0xFF](regs.pc,addr,1,(BYTE)(a),uExecutedCycles);\
+					_IO_WRITE(addr, a)													\
 			}																			\
 		}
 #define _WRITE_WITH_IO_F8xx(a) {											/* GH#827 */\
@@ -128,7 +132,35 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 						*(memVidHD + addr) = (BYTE)(a);									\
 				}																		\
 				else if ((addr & 0xF000) == APPLE_IO_BEGIN)								\
-					IOWrite[(addr>>4) & 0xFF](regs.pc,addr,1,(BYTE)(a),uExecutedCycles);\
+					_IO_WRITE(addr, a)													\
+			}																			\
+		}
+
+// Compile-time specialised versions of _READ_WITH_IO_F8xx/_WRITE_WITH_IO_F8xx:
+// . Used by the templated Cpu6502<kIoF8xx, kVidHD>() core, which is selected by the h/w config (see CpuUpdateCoreSelection())
+// . kIoF8xx=false: $F8xx accesses are plain memory accesses (ie. not a II/II+ with a NSC, nor a VidHD)
+// . kVidHD=false : no VidHD card, so memVidHD is always NULL
+// NB. VidHD's dual-write to memaux excludes $F8xx, so kVidHD=true implies kIoF8xx=true
+#define _READ_SPECIALISED(addr) (												\
+			((addr & 0xF000) == APPLE_IO_BEGIN)									\
+				? _IO_READ(addr)												\
+				: (kIoF8xx && addr >= 0xF800)									\
+					? IO_F8xx(regs.pc,addr,0,0,uExecutedCycles)					\
+					: *(mem+addr)												\
+		)
+#define _WRITE_SPECIALISED(a) {													\
+			if (kIoF8xx && addr >= 0xF800)										\
+				IO_F8xx(regs.pc,addr,1,(BYTE)(a),uExecutedCycles);						\
+			else {																		\
+				memdirty[addr >> 8] = 0xFF;												\
+				LPBYTE page = memwrite[addr >> 8];										\
+				if (page) {																\
+					*(page+(addr & 0xFF)) = (BYTE)(a);									\
+					if (kVidHD && memVidHD)									/* GH#997 */\
+						*(memVidHD + addr) = (BYTE)(a);									\
+				}																		\
+				else if ((addr & 0xF000) == APPLE_IO_BEGIN)								\
+					_IO_WRITE(addr, a)													\
 			}																			\
 		}
 
@@ -30,6 +30,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "StdAfx.h"
 
 #include "CardManager.h"
+#include "CPU.h"
 #include "Registry.h"
 
 #include "BreakpointCard.h"
@@ -39,6 +40,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Mockingboard.h"
 #include "MouseInterface.h"
 #include "ParallelPrinter.h"
+#include "PerfCounters.h"
 #include "SAM.h"
 #include "SerialComms.h"
 #include "SNESMAX.h"
@@ -150,6 +152,9 @@ void CardManager::Insert(UINT slot, SS_CARDTYPE type, bool updateRegistry/*=true
 	InsertInternal(slot, type);
 	if (updateRegistry)
 		RegSetConfigSlotNewCardType(slot, type);
+
+	if (slot == SLOT3)
+		CpuUpdateCoreSelection();	// VidHD
 }
 
 void CardManager::RemoveInternal(UINT slot)
@@ -293,6 +298,8 @@ void CardManager::Reset(const bool powerCycle)
 
 void CardManager::Update(const ULONG nExecutedCycles)
 {
+	PERF_SCOPE(PERF_CARD_UPDATE_NS);
+
 	for (UINT i = SLOT0; i < NUM_SLOTS; ++i)
 	{
 		if (m_slot[i])
@@ -368,6 +368,10 @@ bool ProcessCmdLine(LPSTR lpCmdLine)
 					g_cmdLine.uHarddiskNumBlocks = 0;
 			}
 		}
+		else if (strcmp(lpCmdLine, "-hdd-write-back") == 0)		// write guest changes back to HDD host directories
+		{
+			g_cmdLine.hddHostWriteBack = true;
+		}
 		else if (strcmp(lpCmdLine, "-load-state") == 0)
 		{
 			lpCmdLine = GetCurrArg(lpNextArg);
@@ -378,6 +382,10 @@ bool ProcessCmdLine(LPSTR lpCmdLine)
 		{
 			g_cmdLine.snapshotIgnoreHdcFirmware = true;
 		}
+		else if (strcmp(lpCmdLine, "-save-state-hex") == 0)	// For debugging - save memory as hex instead of compressed
+		{
+			g_cmdLine.snapshotHexMemory = true;
+		}
 		else if (strcmp(lpCmdLine, "-f") == 0 || strcmp(lpCmdLine, "-full-screen") == 0)
 		{
 			g_cmdLine.setFullScreen = 1;
@@ -47,8 +47,10 @@ struct CmdLine
 		useHdcFirmwareV2 = false;
 		szSnapshotName = NULL;
 		snapshotIgnoreHdcFirmware = false;
+		snapshotHexMemory = false;
 		szScreenshotFilename = NULL;
 		uHarddiskNumBlocks = 0;
+		hddHostWriteBack = false;
 		uRamWorksExPages = 0;
 		uSaturnBanks = 0;
 		newVideoType = -1;
@@ -103,8 +105,10 @@ struct CmdLine
 	bool driveConnected[NUM_SLOTS][NUM_DRIVES];
 	LPCSTR szImageName_harddisk[NUM_SLOTS][NUM_HARDDISKS];
 	UINT uHarddiskNumBlocks;
+	bool hddHostWriteBack;
 	LPSTR szSnapshotName;
 	bool snapshotIgnoreHdcFirmware;
+	bool snapshotHexMemory;
 	LPSTR szScreenshotFilename;
 	UINT uRamWorksExPages;
 	UINT uSaturnBanks;
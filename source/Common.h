@@ -105,6 +105,7 @@ enum AppMode_e
 #define  REGVALUE_VIDEO_REFRESH_RATE    "Video Refresh Rate"
 #define  REGVALUE_SERIAL_PORT_NAME   "Serial Port Name"
 #define  REGVALUE_ENHANCE_DISK_SPEED "Enhance Disk Speed"
+#define  REGVALUE_FAST_DISK          "Fast Disk"
 #define  REGVALUE_CUSTOM_SPEED       "Custom Speed"
 #define  REGVALUE_EMULATION_SPEED    "Emulation Speed"
 #define  REGVALUE_WINDOW_SCALE       "Window Scale"
@@ -134,6 +135,7 @@ enum AppMode_e
 #define REGVALUE_PREF_NEW_DISK_COPY_BITSY_BYE  "NewDiskCopyBitsyBye"
 #define REGVALUE_PREF_NEW_DISK_COPY_BASIC      "NewDiskCopyBASIC"
 #define REGVALUE_PREF_NEW_DISK_COPY_PRODOS_SYS "NewDiskCopyProDOS"
+#define REGVALUE_PREF_IMAGE_CACHE_DIR          "Image Cache Directory"
 
 #define WM_USER_BENCHMARK	WM_USER+1
 #define WM_USER_SAVESTATE	WM_USER+2
@@ -44,6 +44,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "../Memory.h"
 #include "../NTSC.h"
 #include "../SoundCore.h"	// SoundCore_SetFade()
+#include "../SynchronousEventManager.h"
 #include "../debugserver/DebugServerManager.h"  // Debug stream server
 
 //	#define DEBUG_COMMAND_HELP  1
@@ -256,6 +257,28 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	bool ProfileSave   ();
 	void ProfileFormat( bool bSeperateColumns, ProfileFormat_e eFormatMode );
 
+// Profile - Sampling
+	// Every N cycles (from a SyncEvent, so at full emulation speed) sample PC and the JSR call stack
+	const int  PROFILE_SAMPLE_DEFAULT_CYCLES   = 1000;	// ~1000 samples/sec @ 1MHz
+	const int  PROFILE_SAMPLE_MAX_DEPTH        = 32;
+	const int  PROFILE_SAMPLE_TOP_N            = 16;
+	const WORD PROFILE_SAMPLE_MAX_ROUTINE_SIZE = 0x400;	// PC further than this from a symbol is reported by page
+
+	const std::string g_FileNameProfileStacks = "ProfileStacks.txt"; // Folded stacks, eg: flamegraph.pl ProfileStacks.txt > Profile.svg
+
+	typedef std::vector<WORD> ProfileStack_t;	// outermost JSR target, ..., innermost JSR target, PC
+	std::map<ProfileStack_t, UINT> g_mProfileSamples;
+	UINT g_nProfileSamples = 0;
+	int  g_nProfileSampleCycles = PROFILE_SAMPLE_DEFAULT_CYCLES;
+
+	static int ProfileSample_SyncEventCallback ( int id, int cycles, ULONG uExecutedCycles );
+	SyncEvent g_ProfileSampleEvent( SYNC_EVENT_ID_PROFILE_SAMPLE, 0, ProfileSample_SyncEventCallback );
+
+	void ProfileSampleStart ( int nCycles );
+	void ProfileSampleStop  ();
+	bool ProfileSampleSave  ();
+	void ProfileSampleReport();
+
 	// TODO: Things would be much simpler if g_aProfileLine is just a container of std::string.
 	struct ProfileLine_t
 	{
@@ -822,6 +845,14 @@ Update_t CmdProfile (int nArgs)
 			g_bProfiling = 1;
 			ConsoleBufferPush( " Resetting profile data." );
 		}
+		else if (iParam == PARAM_START)
+		{
+			ProfileSampleStart( PROFILE_SAMPLE_DEFAULT_CYCLES );
+		}
+		else if (iParam == PARAM_STOP)
+		{
+			ProfileSampleStop();
+		}
 		else
 		{
 			if ((iParam != PARAM_SAVE) && (iParam != PARAM_LIST))
@@ -865,6 +896,17 @@ Update_t CmdProfile (int nArgs)
 			}
 		}
 	}
+	else if (nArgs == 2)
+	{
+		// PROFILE START #cycles
+		int iParam;
+		int nFound = FindParam( g_aArgs[ 1 ].sArg, MATCH_EXACT, iParam, _PARAM_GENERAL_BEGIN, _PARAM_GENERAL_END );
+
+		if ((! nFound) || (iParam != PARAM_START) || (! g_aArgs[ 2 ].nValue))
+			goto _Help;
+
+		ProfileSampleStart( g_aArgs[ 2 ].nValue );
+	}
 	else
 		goto _Help;
 
@@ -2550,6 +2592,36 @@ Update_t CmdGoFullSpeed (int nArgs)
 	return CmdGo(nArgs, true);
 }
 
+// Step History ___________________________________________________________________________________
+
+//===========================================================================
+static bool StepHistoryIsPCBreakpoint ()
+{
+	for (int iBreakpoint = 0; iBreakpoint < MAX_BREAKPOINTS; iBreakpoint++)
+	{
+		Breakpoint_t *pBP = &g_aBreakpoints[iBreakpoint];
+
+		if (_BreakpointValid( pBP ) && pBP->eSource == BP_SRC_REG_PC && _CheckBreakpointValue( pBP, regs.pc ))
+			return true;
+	}
+
+	return false;
+}
+
+//===========================================================================
+static Update_t StepHistoryUpdateDisplay ( int nSteps )
+{
+	if (nSteps == 0)
+		ConsoleBufferPush( "  No step history (history is reset by interrupts and paging/slot I/O)" );
+	else
+		ConsolePrintFormat( CHC_DEFAULT "  Stepped back " CHC_NUM_DEC "%d" CHC_DEFAULT " instruction(s), " CHC_NUM_DEC "%d" CHC_DEFAULT " left", nSteps, StepHistoryGetCount() );
+
+	g_nDisasmCurAddress = regs.pc;
+	DisasmCalcTopBotAddress();
+
+	return UPDATE_ALL | ConsoleUpdate();
+}
+
 //===========================================================================
 Update_t CmdStepOver (int nArgs)
 {
@@ -2734,6 +2806,33 @@ Update_t CmdTraceLine (int nArgs)
 	return UPDATE_ALL; // TODO: Verify // 0
 }
 
+//===========================================================================
+Update_t CmdTraceBack (int nArgs)
+{
+	int nSteps = nArgs ? g_aArgs[1].nValue : 1;
+	int nUndone = 0;
+
+	while (nSteps-- > 0 && StepHistoryUndo())
+		nUndone++;
+
+	return StepHistoryUpdateDisplay( nUndone );
+}
+
+//===========================================================================
+Update_t CmdGoBack (int nArgs)
+{
+	int nUndone = 0;
+
+	while (StepHistoryUndo())
+	{
+		nUndone++;
+		if (StepHistoryIsPCBreakpoint())
+			break;
+	}
+
+	return StepHistoryUpdateDisplay( nUndone );
+}
+
 
 
 
@@ -6977,7 +7076,7 @@ bool ParseAssemblyListing ( bool bBytesToMemory, bool bAddSymbols )
 					{
 						char *pAddressEnd;
 						nAddress = (uint32_t) strtol( pAddress, &pAddressEnd, 16 );
-						g_aSymbols[ SYMBOLS_SRC_2 ][ (WORD) nAddress] = sName;
+						SymbolTableInsert( SYMBOLS_SRC_2, (WORD) nAddress, sName );
 						g_nSourceAssemblySymbols++;
 					}
 				}
@@ -8852,6 +8951,180 @@ bool ProfileSave ()
 }
 
 
+
+// Profile - Sampling _____________________________________________________________________________
+
+// Called every g_nProfileSampleCycles, after an opcode has completed
+//===========================================================================
+static int ProfileSample_SyncEventCallback ( int id, int cycles, ULONG uExecutedCycles )
+{
+	if (GetActiveCpu() == CPU_Z80)
+		return g_nProfileSampleCycles;
+
+	WORD aCallees[ PROFILE_SAMPLE_MAX_DEPTH ];
+	const int nDepth = _6502_GetCallStack( aCallees, PROFILE_SAMPLE_MAX_DEPTH );
+
+	ProfileStack_t stack( nDepth + 1 );
+	for ( int iFrame = 0; iFrame < nDepth; iFrame++ )
+		stack[ iFrame ] = aCallees[ nDepth - 1 - iFrame ];	// outermost first
+	stack[ nDepth ] = regs.pc;
+
+	g_mProfileSamples[ stack ]++;
+	g_nProfileSamples++;
+
+	return g_nProfileSampleCycles;
+}
+
+//===========================================================================
+void ProfileSampleStart ( int nCycles )
+{
+	if (g_ProfileSampleEvent.m_active)
+		g_SynchronousEventMgr.Remove( SYNC_EVENT_ID_PROFILE_SAMPLE );
+
+	g_mProfileSamples.clear();
+	g_nProfileSamples = 0;
+	g_nProfileSampleCycles = nCycles;
+
+	g_ProfileSampleEvent.m_cyclesRemaining = g_nProfileSampleCycles;
+	g_ProfileSampleEvent.m_canAssertIRQ = false;
+	g_SynchronousEventMgr.Insert( &g_ProfileSampleEvent );
+
+	ConsoleBufferPushFormat( " Sampling every %d cycles. Run, then: PROFILE STOP", g_nProfileSampleCycles );
+}
+
+//===========================================================================
+void ProfileSampleStop ()
+{
+	if (! g_ProfileSampleEvent.m_active)
+	{
+		ConsoleBufferPush( " Not sampling." );
+		return;
+	}
+
+	g_SynchronousEventMgr.Remove( SYNC_EVENT_ID_PROFILE_SAMPLE );
+
+	ProfileSampleReport();
+
+	if (ProfileSampleSave())
+		ConsoleBufferPushFormat( " Saved: %s", g_FileNameProfileStacks.c_str() );
+	else
+		ConsoleBufferPush( " ERROR: Couldn't save file. (In use?)" );
+}
+
+// JSR target: exact symbol or $XXXX
+// PC: routine it is in, or $XXxx if it isn't near a symbol
+//===========================================================================
+static std::string ProfileSampleGetName ( WORD nAddress, bool bCallee )
+{
+	if (bCallee)
+	{
+		std::string sAddress;
+		return GetSymbol( nAddress, 2, sAddress );
+	}
+
+	WORD nSymbolAddress = 0;
+	std::string const* pSymbol = FindSymbolAtOrBelowAddress( nAddress, nSymbolAddress );
+	if (pSymbol && (WORD)(nAddress - nSymbolAddress) < PROFILE_SAMPLE_MAX_ROUTINE_SIZE)
+		return *pSymbol;
+
+	return StrFormat( "$%02Xxx", nAddress >> 8 );
+}
+
+//===========================================================================
+static void ProfileSampleGetFrames ( const ProfileStack_t & stack, std::vector<std::string> & vFrames )
+{
+	vFrames.clear();
+
+	const size_t nCallees = stack.size() - 1;
+	for ( size_t iFrame = 0; iFrame < nCallees; iFrame++ )
+		vFrames.push_back( ProfileSampleGetName( stack[ iFrame ], true ) );
+
+	// Don't repeat the routine we are already in
+	std::string sLeaf = ProfileSampleGetName( stack[ nCallees ], false );
+	if (vFrames.empty() || vFrames.back() != sLeaf)
+		vFrames.push_back( sLeaf );
+}
+
+// Folded stacks: one line per unique stack, "outer;...;inner count"
+//===========================================================================
+bool ProfileSampleSave ()
+{
+	const std::string sFilename = g_sProgramDir + g_FileNameProfileStacks;
+
+	FILE *hFile = fopen( sFilename.c_str(), "wt" );
+	if (! hFile)
+		return false;
+
+	std::map<std::string, UINT> mFolded;	// different PCs in the same routine fold into one line
+	std::vector<std::string> vFrames;
+
+	for ( std::map<ProfileStack_t, UINT>::const_iterator it = g_mProfileSamples.begin(); it != g_mProfileSamples.end(); ++it )
+	{
+		ProfileSampleGetFrames( it->first, vFrames );
+
+		std::string sFolded;
+		for ( size_t iFrame = 0; iFrame < vFrames.size(); iFrame++ )
+		{
+			if (iFrame)
+				sFolded += ';';
+			sFolded += vFrames[ iFrame ];
+		}
+
+		mFolded[ sFolded ] += it->second;
+	}
+
+	for ( std::map<std::string, UINT>::const_iterator it = mFolded.begin(); it != mFolded.end(); ++it )
+		fprintf( hFile, "%s %u\n", it->first.c_str(), it->second );
+
+	fclose( hFile );
+	return true;
+}
+
+// Top-N routines by self (leaf) and total (anywhere on the call stack) samples
+//===========================================================================
+void ProfileSampleReport ()
+{
+	ConsoleBufferPushFormat( " Samples: %u (every %d cycles)", g_nProfileSamples, g_nProfileSampleCycles );
+	if (! g_nProfileSamples)
+		return;
+
+	std::map<std::string, UINT> mSelf;
+	std::map<std::string, UINT> mTotal;
+	std::vector<std::string> vFrames;
+
+	for ( std::map<ProfileStack_t, UINT>::const_iterator it = g_mProfileSamples.begin(); it != g_mProfileSamples.end(); ++it )
+	{
+		ProfileSampleGetFrames( it->first, vFrames );
+
+		mSelf[ vFrames.back() ] += it->second;
+
+		// Recursion only counts once
+		std::sort( vFrames.begin(), vFrames.end() );
+		vFrames.erase( std::unique( vFrames.begin(), vFrames.end() ), vFrames.end() );
+		for ( size_t iFrame = 0; iFrame < vFrames.size(); iFrame++ )
+			mTotal[ vFrames[ iFrame ] ] += it->second;
+	}
+
+	typedef std::pair<UINT, std::string> ProfileRoutine_t;
+	std::vector<ProfileRoutine_t> vSelf;
+	for ( std::map<std::string, UINT>::const_iterator it = mSelf.begin(); it != mSelf.end(); ++it )
+		vSelf.push_back( ProfileRoutine_t( it->second, it->first ) );
+	std::sort( vSelf.begin(), vSelf.end(), std::greater<ProfileRoutine_t>() );
+
+	ConsoleBufferPushFormat( " %6s %6s  %s", "Self%", "Total%", "Routine" );
+
+	const size_t nTop = std::min<size_t>( vSelf.size(), PROFILE_SAMPLE_TOP_N );
+	for ( size_t iRoutine = 0; iRoutine < nTop; iRoutine++ )
+	{
+		const ProfileRoutine_t & routine = vSelf[ iRoutine ];
+		ConsoleBufferPushFormat( " %6.2f %6.2f  %s"
+			, 100.0 * routine.first / g_nProfileSamples
+			, 100.0 * mTotal[ routine.second ] / g_nProfileSamples
+			, routine.second.c_str() );
+	}
+}
+
+
 static void InitDisasm (void)
 {
 	g_nDisasmCurAddress = regs.pc;
@@ -8871,6 +9144,8 @@ void DebugBegin ()
 
 	GetDebuggerMemDC();
 
+	StepHistoryClear();	// the emulator has been running without recording
+
 	g_nAppMode = MODE_DEBUG;
 	GetFrame().FrameRefreshStatus(DRAW_TITLE | DRAW_DISK_STATUS);
 
@@ -9097,9 +9372,24 @@ void DebugContinueStepping (const bool bCallerWillUpdateDisplay/*=false*/)
 			UpdateLBR();
 			const WORD oldPC = regs.pc;
 
+			int nIOAddress = NO_6502_TARGET;
+			LPBYTE aOldMemWrite[ _6502_NUM_PAGES ];
+			if (GetActiveCpu() != CPU_Z80)
+			{
+				nIOAddress = StepHistoryRecord();
+				if (nIOAddress != NO_6502_TARGET)
+					memcpy( aOldMemWrite, memwrite, sizeof(aOldMemWrite) );
+			}
+			else
+			{
+				StepHistoryClear();
+			}
+
 			SingleStep(g_bGoCmd_ReinitFlag);
 			g_bGoCmd_ReinitFlag = false;
 
+			StepHistoryCheckBarrier( IsInterruptInLastExecution(), nIOAddress, aOldMemWrite );
+
 			// Debug stream: broadcast CPU state after step
 			if (DebugServer_IsStreamEnabled())
 			{
@@ -9303,6 +9593,12 @@ static void DebugEnd ()
 		ProfileFormat( true, PROFILE_FORMAT_TAB ); // Export in Excel-ready text format.
 		ProfileSave();
 	}
+
+	if (g_ProfileSampleEvent.m_active)
+	{
+		g_SynchronousEventMgr.Remove( SYNC_EVENT_ID_PROFILE_SAMPLE );
+		ProfileSampleSave();
+	}
 	
 	if (g_hTraceFile)
 	{
@@ -13,6 +13,7 @@
 #include "Debugger_Help.h"
 #include "Debugger_Display.h"
 #include "Debugger_Symbols.h"
+#include "Debugger_StepHistory.h"
 #include "Util_MemoryTextFile.h"
 #include "BreakpointCard.h"
 
@@ -483,6 +483,34 @@ WORD _6502_PeekStackReturnAddress (WORD & nStack)
 	return nAddress;
 }
 
+// Walk the stack from the top (innermost) looking for JSR return addresses, ie. pushed PC+2 where (PC) == JSR
+// NB. This is heuristic: data pushed with PHA can look like a return address, and RTS tricks are not followed
+// Returns the number of JSR targets in pCallees_, innermost first
+//===========================================================================
+int _6502_GetCallStack ( WORD * pCallees_, const int nMaxDepth )
+{
+	int nDepth = 0;
+
+	WORD nSP = (regs.sp & 0xFF) + 1;
+	while ((nSP < 0xFF) && (nDepth < nMaxDepth))
+	{
+		const WORD nReturn = ReadByteFromMemory( _6502_STACK_BEGIN + nSP ) | (ReadByteFromMemory( _6502_STACK_BEGIN + nSP + 1 ) << 8);
+		const WORD nJSR = nReturn - 2;
+
+		if ((nJSR < APPLE_IO_BEGIN || nJSR > APPLE_IO_END) && ReadByteFromMemory( nJSR ) == OPCODE_JSR)
+		{
+			pCallees_[ nDepth++ ] = ReadWordFromMemory( nJSR + 1 );
+			nSP += 2;
+		}
+		else
+		{
+			nSP += 1;
+		}
+	}
+
+	return nDepth;
+}
+
 // == Opcodes ===
 
 //===========================================================================
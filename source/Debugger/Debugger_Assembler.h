@@ -195,6 +195,7 @@ extern	int g_aAssemblerFirstDirective[ NUM_ASSEMBLERS ];
 	int  _6502_FindStackReturnAddress (const WORD nAddress);
 	WORD _6502_GetStackReturnAddress ();
 	WORD _6502_PeekStackReturnAddress (WORD & nStack);
+	int  _6502_GetCallStack (WORD * pCallees_, const int nMaxDepth);
 
 	// Opcodes
 	int  _6502_GetOpmodeOpbyte( const int iAddress, int & iOpmode_, int & nOpbytes_, const DisasmData_t** pData = NULL );
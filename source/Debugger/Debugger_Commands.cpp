@@ -67,6 +67,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 		{"T"           , CmdTrace             , CMD_TRACE                , "Trace current instruction"  },
 		{"TF"          , CmdTraceFile         , CMD_TRACE_FILE           , "Save trace to filename [with video scanner info]" },
 		{"TL"          , CmdTraceLine         , CMD_TRACE_LINE           , "Trace (with cycle counting)" },
+		{"TB"          , CmdTraceBack         , CMD_TRACE_BACK           , "Step back instruction(s)"   },
+		{"GB"          , CmdGoBack            , CMD_GO_BACK              , "Step back until PC breakpoint" },
 		{"U"           , CmdUnassemble        , CMD_UNASSEMBLE           , "Disassemble instructions"   },
 //		{"WAIT"        , CmdWait              , CMD_WAIT                 , "Run until
 	// Bookmarks
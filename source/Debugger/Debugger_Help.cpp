@@ -792,6 +792,12 @@ Update_t CmdHelpSpecific (int nArgs)
 				, g_aParameters[ PARAM_LIST  ].m_sName
 			);
 			ConsoleBufferPush( " No arguments resets the profile." );
+			ConsoleColorizePrintFormat( " Usage: [%s [#cycles] | %s]"
+				, g_aParameters[ PARAM_START ].m_sName
+				, g_aParameters[ PARAM_STOP  ].m_sName
+			);
+			ConsoleBufferPush( "  Start: sample PC & JSR call stack every #cycles (default #1000) at full speed" );
+			ConsoleBufferPush( "  Stop: list top routines (by symbol) & save folded stacks to ProfileStacks.txt" );
 			break;
 	// Registers
 		case CMD_REGISTER_SET:
@@ -839,6 +845,17 @@ Update_t CmdHelpSpecific (int nArgs)
 			ConsoleBufferPush( "  Traces into current instruction" );
 			ConsoleBufferPush( "  with cycle counting." );
 			break;
+		case CMD_TRACE_BACK:
+			ConsoleColorizePrint( " Usage: [#]" );
+			ConsoleBufferPush( "  Undoes the last # stepped instruction(s): registers & RAM." );
+			ConsoleBufferPush( "  I/O, video & cycle count are not rewound." );
+			ConsoleBufferPush( "  History starts when the debugger is entered and is reset" );
+			ConsoleBufferPush( "  by interrupts and paging/slot I/O." );
+			break;
+		case CMD_GO_BACK:
+			ConsoleBufferPush( "  Steps back until a PC breakpoint matches (or no history left)." );
+			ConsoleBufferPush( "  See TB." );
+			break;
 	// Bookmarks
 		case CMD_BOOKMARK:
 		case CMD_BOOKMARK_ADD:
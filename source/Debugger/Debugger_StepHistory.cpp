@@ -0,0 +1,154 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2024, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Debugger Step History (TB/GB)
+ *
+ * . the old regs and the old value of every byte the instruction could write
+ * . pointers are into the physical write destination (memwrite), so undo is independent of the current paging
+ * . only contiguous while stepping: cleared when entering the debugger, on interrupts and on I/O that changes paging or may DMA
+ *
+ * Author: Various
+ */
+
+#include "StdAfx.h"
+
+#include "Debug.h"
+#include "Debugger_StepHistory.h"
+
+#include "../CPU.h"
+#include "../Memory.h"
+
+	struct StepUndo_t
+	{
+		static const int MAX_WRITES = 4;	// 3 stack bytes (BRK) + 1 target
+
+		regsrec regs;
+		int     nWrites;
+		LPBYTE  pWrite[ MAX_WRITES ];
+		BYTE    nOldValue[ MAX_WRITES ];
+	};
+
+	static const int MAX_STEP_HISTORY = 0x4000;
+	static StepUndo_t g_aStepHistory[ MAX_STEP_HISTORY ];
+	static int        g_iStepHistoryHead  = 0; // next free entry
+	static int        g_nStepHistoryCount = 0;
+
+//===========================================================================
+void StepHistoryClear ()
+{
+	g_iStepHistoryHead = 0;
+	g_nStepHistoryCount = 0;
+}
+
+//===========================================================================
+int StepHistoryGetCount ()
+{
+	return g_nStepHistoryCount;
+}
+
+//===========================================================================
+static void StepHistoryAddWrite ( StepUndo_t & undo, int nAddress )
+{
+	if (nAddress == NO_6502_TARGET)
+		return;
+
+	nAddress &= _6502_MEM_END;
+	const LPBYTE pPage = memwrite[ nAddress >> 8 ];
+	if (!pPage)	// ROM or I/O
+		return;
+
+	undo.pWrite   [ undo.nWrites ] = pPage + (nAddress & 0xFF);
+	undo.nOldValue[ undo.nWrites ] = *undo.pWrite[ undo.nWrites ];
+	undo.nWrites++;
+}
+
+// Pre: called just before SingleStep()
+// Returns the I/O or slot memory address accessed by the instruction (or NO_6502_TARGET), for StepHistoryCheckBarrier()
+//===========================================================================
+int StepHistoryRecord ()
+{
+	StepUndo_t & undo = g_aStepHistory[ g_iStepHistoryHead ];
+	undo.regs = regs;
+	undo.nWrites = 0;
+
+	int aTarget[ 3 ];
+	_6502_GetTargets( regs.pc, &aTarget[0], &aTarget[1], &aTarget[2], NULL, true, false );
+
+	// Pushes (PHA/PHP/JSR/BRK) write at most 3 bytes below SP
+	for (int iStack = 0; iStack < 3; iStack++)
+		StepHistoryAddWrite( undo, _6502_STACK_BEGIN + ((regs.sp - iStack) & 0xFF) );
+
+	StepHistoryAddWrite( undo, aTarget[2] );
+
+	g_iStepHistoryHead = (g_iStepHistoryHead + 1) % MAX_STEP_HISTORY;
+	if (g_nStepHistoryCount < MAX_STEP_HISTORY)
+		g_nStepHistoryCount++;
+
+	for (int iTarget = 0; iTarget < 3; iTarget++)
+	{
+		const int nAddress = aTarget[ iTarget ];
+		if (nAddress != NO_6502_TARGET && (nAddress & _6502_MEM_END) >= APPLE_IO_BEGIN && (nAddress & _6502_MEM_END) < 0xD000)
+			return nAddress & _6502_MEM_END;
+	}
+
+	return NO_6502_TARGET;
+}
+
+// Clear the history if the last instruction had side-effects that can't be undone
+//===========================================================================
+void StepHistoryCheckBarrier ( const bool bInterrupt, const int nIOAddress, const LPBYTE * pOldMemWrite )
+{
+	if (bInterrupt)
+	{
+		StepHistoryClear();
+		return;
+	}
+
+	if (nIOAddress == NO_6502_TARGET)
+		return;
+
+	// Slot I/O ($C090-$C0FF) & ROM: cards may DMA to memory (eg. HDD) or bank-switch (eg. Saturn)
+	// Soft-switches: may have changed paging, so the recorded pointers are stale for earlier steps
+	if (nIOAddress >= 0xC090 || memcmp( pOldMemWrite, memwrite, sizeof(memwrite) ) != 0)
+		StepHistoryClear();
+}
+
+// Returns false if there's no history left
+//===========================================================================
+bool StepHistoryUndo ()
+{
+	if (g_nStepHistoryCount == 0)
+		return false;
+
+	g_iStepHistoryHead = (g_iStepHistoryHead + MAX_STEP_HISTORY - 1) % MAX_STEP_HISTORY;
+	g_nStepHistoryCount--;
+
+	const StepUndo_t & undo = g_aStepHistory[ g_iStepHistoryHead ];
+
+	// Restore in reverse order, in case the same byte was recorded twice
+	for (int iWrite = undo.nWrites - 1; iWrite >= 0; iWrite--)
+		*undo.pWrite[ iWrite ] = undo.nOldValue[ iWrite ];
+
+	regs = undo.regs;
+	return true;
+}
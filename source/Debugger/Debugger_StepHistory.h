@@ -0,0 +1,8 @@
+#pragma once
+
+// Step history (for TB/GB): one undo record per single-stepped instruction
+	void StepHistoryClear ();
+	int  StepHistoryRecord ();
+	void StepHistoryCheckBarrier ( const bool bInterrupt, const int nIOAddress, const LPBYTE * pOldMemWrite );
+	bool StepHistoryUndo ();
+	int  StepHistoryGetCount ();
@@ -33,6 +33,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "../Windows/AppleWin.h"
 #include "../Core.h"
 
+#include <set>
+#include <unordered_map>
+
 	// 2.6.2.13 Added: Can now enable/disable selected symbol table(s) !
 	// Allow the user to disable/enable symbol tables
 	// xxx1xxx symbol table is active (are displayed in disassembly window, etc.)
@@ -73,6 +76,33 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	SymbolTable_t g_aSymbols[ NUM_SYMBOL_TABLES ];
 	int           g_nSymbolsLoaded = 0;  // on Last Load
 
+// Lookup indexes over all the active symbol tables, so a lookup doesn't have to search every table
+// . Address: 64K direct index to the symbol (in the map) & its table; user tables win, same as the search order
+// . Nearest: 64K direct index to the closest symbol address at or below
+// . Name   : case-insensitive name to every address & table with that name, best first (same precedence as searching the tables)
+// Adding, renaming & removing a symbol update the address & name indexes in place.
+// Clearing or activating a table rebuilds them on next use.
+	struct SymbolIndexNameOrder_t
+	{
+		// highest table, then lowest address
+		bool operator() ( const std::pair<WORD, int> & a, const std::pair<WORD, int> & b ) const
+		{
+			if (a.second != b.second)
+				return a.second > b.second;
+			return a.first < b.first;
+		}
+	};
+	typedef std::set<std::pair<WORD, int>, SymbolIndexNameOrder_t> SymbolIndexName_t;
+
+	static std::string const*  g_aSymbolIndex[ _6502_MEM_LEN ];
+	static BYTE                g_aSymbolIndexTable[ _6502_MEM_LEN ];
+	static WORD                g_aSymbolIndexNearest[ _6502_MEM_LEN ];
+	static std::unordered_map<std::string, SymbolIndexName_t> g_mSymbolIndexName;
+
+	static bool g_bSymbolIndexValid        = false;
+	static bool g_bSymbolIndexNearestValid = false;
+	static int  g_bSymbolIndexTables       = 0; // g_bDisplaySymbolTables when built
+
 // Utils _ ________________________________________________________________________________________
 
 	std::string _CmdSymbolsInfoHeader( int iTable, int nDisplaySize = 0 );
@@ -135,69 +165,218 @@ int GetSymbolTableFromCommand()
 	return (g_iCommand - CMD_SYMBOLS_ROM);
 }
 
-// @param iTable_ Which symbol table the symbol is in if any.  If none will be NUM_SYMBOL_TABLES
+// Symbol Index ___________________________________________________________________________________
+
 //===========================================================================
-std::string const* FindSymbolFromAddress (WORD nAddress, int * iTable_ )
+static std::string _SymbolIndexNameKey ( const char* pSymbol )
 {
-	// Bugfix/User feature: User symbols should be searched first
-	int iTable = NUM_SYMBOL_TABLES;
-	if (iTable_)
+	std::string sKey( pSymbol );
+	for (size_t i = 0; i < sKey.size(); i++)
+		sKey[i] = (char) toupper( (unsigned char) sKey[i] );
+	return sKey;
+}
+
+//===========================================================================
+static void _SymbolIndexAddName ( const std::string & sSymbol, WORD nAddress, int iTable )
+{
+	g_mSymbolIndexName[ _SymbolIndexNameKey( sSymbol.c_str() ) ].insert( std::make_pair( nAddress, iTable ) );
+}
+
+//===========================================================================
+static void _SymbolIndexRemoveName ( const std::string & sSymbol, WORD nAddress, int iTable )
+{
+	std::unordered_map<std::string, SymbolIndexName_t>::iterator iName = g_mSymbolIndexName.find( _SymbolIndexNameKey( sSymbol.c_str() ) );
+	if (iName == g_mSymbolIndexName.end())
+		return;
+
+	iName->second.erase( std::make_pair( nAddress, iTable ) );
+	if (iName->second.empty())
+		g_mSymbolIndexName.erase( iName );
+}
+
+//===========================================================================
+static bool _SymbolIndexIsActive ( int iTable )
+{
+	return (g_bDisplaySymbolTables & (1 << iTable)) != 0;
+}
+
+//===========================================================================
+static void _SymbolIndexUpdate ()
+{
+	if (g_bSymbolIndexTables != g_bDisplaySymbolTables)
 	{
-		*iTable_ = iTable;
+		g_bSymbolIndexTables = g_bDisplaySymbolTables;
+		SymbolsInvalidateIndex();
 	}
 
-	while (iTable-- > 0)
-	{
-		if (! g_aSymbols[iTable].size())
-			continue;
+	if (g_bSymbolIndexValid)
+		return;
 
-		if (! (g_bDisplaySymbolTables & (1 << iTable)))
+	memset( g_aSymbolIndex, 0, sizeof(g_aSymbolIndex) );
+	g_mSymbolIndexName.clear();
+
+	for (int iTable = 0; iTable < NUM_SYMBOL_TABLES; iTable++)
+	{
+		if (! _SymbolIndexIsActive( iTable ))
 			continue;
 
-		std::map<WORD, std::string>::iterator iSymbols = g_aSymbols[iTable].find(nAddress);
-		if (g_aSymbols[iTable].find(nAddress) != g_aSymbols[iTable].end())
+		for (SymbolTable_t::const_iterator iSymbol = g_aSymbols[iTable].begin(); iSymbol != g_aSymbols[iTable].end(); ++iSymbol)
 		{
-			if (iTable_)
-			{
-				*iTable_ = iTable;
-			}
-			return &iSymbols->second;
+			g_aSymbolIndex[ iSymbol->first ] = &iSymbol->second;
+			g_aSymbolIndexTable[ iSymbol->first ] = (BYTE) iTable;
+			_SymbolIndexAddName( iSymbol->second, iSymbol->first, iTable );
 		}
-	}	
-	return NULL;
+	}
+
+	g_bSymbolIndexValid = true;
 }
 
 //===========================================================================
-bool FindAddressFromSymbol ( const char* pSymbol, WORD * pAddress_, int * iTable_ )
+static void _SymbolIndexUpdateNearest ()
 {
-	// Bugfix/User feature: User symbols should be searched first
-	for (int iTable = NUM_SYMBOL_TABLES; iTable-- > 0; )
+	_SymbolIndexUpdate();
+
+	if (g_bSymbolIndexNearestValid)
+		return;
+
+	WORD nNearest = 0;
+	for (UINT nAddress = 0; nAddress < _6502_MEM_LEN; nAddress++)
 	{
-		if (! g_aSymbols[iTable].size())
-			continue;
+		if (g_aSymbolIndex[ nAddress ])
+			nNearest = (WORD) nAddress;
+		g_aSymbolIndexNearest[ nAddress ] = nNearest;
+	}
 
-		if (! (g_bDisplaySymbolTables & (1 << iTable)))
-			continue;
+	g_bSymbolIndexNearestValid = true;
+}
+
+//===========================================================================
+void SymbolsInvalidateIndex ()
+{
+	g_bSymbolIndexValid = false;
+	g_bSymbolIndexNearestValid = false;
+}
+
+// All additions to the symbol tables go through here, to keep the index in sync
+//===========================================================================
+void SymbolTableInsert ( SymbolTable_Index_e eSymbolTable, WORD nAddress, const char* pSymbolName )
+{
+	_SymbolIndexUpdate();	// bring the index up to date first, so it can be updated in place
+
+	SymbolTable_t & table = g_aSymbols[ eSymbolTable ];
+	std::pair<SymbolTable_t::iterator, bool> result = table.insert( std::make_pair( nAddress, std::string() ) );
+	const bool bActive = _SymbolIndexIsActive( eSymbolTable );
+
+	if (result.second)
+		g_bSymbolIndexNearestValid = false;	// new address
+	else if (bActive)
+		_SymbolIndexRemoveName( result.first->second, nAddress, eSymbolTable );	// renamed
 
-		SymbolTable_t :: iterator  iSymbol = g_aSymbols[iTable].begin();
-		while (iSymbol != g_aSymbols[iTable].end())
+	result.first->second = pSymbolName;
+
+	if (! bActive)
+		return;
+
+	if (! g_aSymbolIndex[ nAddress ] || (eSymbolTable >= g_aSymbolIndexTable[ nAddress ]))
+	{
+		g_aSymbolIndex[ nAddress ] = &result.first->second;
+		g_aSymbolIndexTable[ nAddress ] = (BYTE) eSymbolTable;
+	}
+
+	_SymbolIndexAddName( result.first->second, nAddress, eSymbolTable );
+}
+
+// All removals of a single symbol go through here, to keep the index in sync
+//===========================================================================
+void SymbolTableErase ( SymbolTable_Index_e eSymbolTable, WORD nAddress )
+{
+	_SymbolIndexUpdate();
+
+	SymbolTable_t & table = g_aSymbols[ eSymbolTable ];
+	SymbolTable_t::iterator iSymbol = table.find( nAddress );
+	if (iSymbol == table.end())
+		return;
+
+	if (_SymbolIndexIsActive( eSymbolTable ))
+	{
+		_SymbolIndexRemoveName( iSymbol->second, nAddress, eSymbolTable );
+
+		if (g_aSymbolIndex[ nAddress ] == &iSymbol->second)
 		{
-			if (!_stricmp( iSymbol->second.c_str(), pSymbol))
+			// Fall back to the next table with a symbol at this address
+			g_aSymbolIndex[ nAddress ] = NULL;
+			for (int iTable = eSymbolTable - 1; iTable >= 0; iTable--)
 			{
-				if (pAddress_)
-				{
-					*pAddress_ = iSymbol->first;
-				}
-				if (iTable_)
+				if (! _SymbolIndexIsActive( iTable ))
+					continue;
+
+				SymbolTable_t::const_iterator iOther = g_aSymbols[ iTable ].find( nAddress );
+				if (iOther != g_aSymbols[ iTable ].end())
 				{
-					*iTable_ = iTable;
+					g_aSymbolIndex[ nAddress ] = &iOther->second;
+					g_aSymbolIndexTable[ nAddress ] = (BYTE) iTable;
+					break;
 				}
-				return true;
 			}
-			iSymbol++;
+
+			if (! g_aSymbolIndex[ nAddress ])
+				g_bSymbolIndexNearestValid = false;
 		}
 	}
-	return false;
+
+	table.erase( iSymbol );
+}
+
+// @param iTable_ Which symbol table the symbol is in if any.  If none will be NUM_SYMBOL_TABLES
+//===========================================================================
+std::string const* FindSymbolFromAddress (WORD nAddress, int * iTable_ )
+{
+	_SymbolIndexUpdate();
+
+	std::string const* pSymbol = g_aSymbolIndex[ nAddress ];
+
+	if (iTable_)
+	{
+		*iTable_ = pSymbol ? g_aSymbolIndexTable[ nAddress ] : NUM_SYMBOL_TABLES;
+	}
+
+	return pSymbol;
+}
+
+// Closest symbol at or below the address, eg. to attribute an address to the routine it is in
+// NB. User symbols win a tie (same as FindSymbolFromAddress())
+//===========================================================================
+std::string const* FindSymbolAtOrBelowAddress (WORD nAddress, WORD & nSymbolAddress_)
+{
+	_SymbolIndexUpdateNearest();
+
+	const WORD nNearest = g_aSymbolIndexNearest[ nAddress ];
+	std::string const* pSymbol = g_aSymbolIndex[ nNearest ];
+	if (pSymbol)
+		nSymbolAddress_ = nNearest;
+
+	return pSymbol;
+}
+
+//===========================================================================
+bool FindAddressFromSymbol ( const char* pSymbol, WORD * pAddress_, int * iTable_ )
+{
+	_SymbolIndexUpdate();
+
+	std::unordered_map<std::string, SymbolIndexName_t>::const_iterator iName = g_mSymbolIndexName.find( _SymbolIndexNameKey( pSymbol ) );
+	if (iName == g_mSymbolIndexName.end())
+		return false;
+
+	const std::pair<WORD, int> & best = *iName->second.begin();
+	if (pAddress_)
+	{
+		*pAddress_ = best.first;
+	}
+	if (iTable_)
+	{
+		*iTable_ = best.second;
+	}
+	return true;
 }
 
 
@@ -746,7 +925,7 @@ int ParseSymbolTable(const std::string & pPathFileName, SymbolTable_Index_e eSym
 	
 			// else // It is not a bug to have duplicate addresses by different names
 
-			g_aSymbols[ eSymbolTableWrite ] [ (WORD) nAddress ] = sName;
+			SymbolTableInsert( eSymbolTableWrite, (WORD) nAddress, sName );
 			nSymbolsLoaded++; // TODO: FIXME: BUG: This is the total symbols read, not added
 		}
 		fclose(hFile);
@@ -875,7 +1054,8 @@ Update_t CmdSymbolsLoad (int nArgs)
 Update_t _CmdSymbolsClear( SymbolTable_Index_e eSymbolTable )
 {
 	g_aSymbols[ eSymbolTable ].clear();
-	
+	SymbolsInvalidateIndex();
+
 	return UPDATE_SYMBOLS;
 }
 
@@ -910,7 +1090,7 @@ void SymbolUpdate ( SymbolTable_Index_e eSymbolTable, const char *pSymbolName, W
 					ConsoleBufferPush( " Removing symbol." );
 				}
 
-				g_aSymbols[ eSymbolTable ].erase( nAddressPrev );
+				SymbolTableErase( eSymbolTable, nAddressPrev );
 
 				if (bUpdateSymbol)
 				{
@@ -941,7 +1121,7 @@ void SymbolUpdate ( SymbolTable_Index_e eSymbolTable, const char *pSymbolName, W
 				// TODO: Probably should check if same name?
 			}
 #endif
-			g_aSymbols[ eSymbolTable ][ nAddress ] = pSymbolName;
+			SymbolTableInsert( eSymbolTable, nAddress, pSymbolName );
 
 			// 2.9.1.26: When adding symbols list the address first then the name for readability
 			// Tell user symbol was added
@@ -20,5 +20,9 @@
 	bool FindAddressFromSymbol(const char* pSymbol, WORD* pAddress_ = NULL, int* iTable_ = NULL);
 	WORD GetAddressFromSymbol(const char* symbol); // HACK: returns 0 if symbol not found
 	void SymbolUpdate(SymbolTable_Index_e eSymbolTable, const char* pSymbolName, WORD nAddrss, bool bRemoveSymbol, bool bUpdateSymbol);
+	void SymbolTableInsert(SymbolTable_Index_e eSymbolTable, WORD nAddress, const char* pSymbolName);
+	void SymbolTableErase(SymbolTable_Index_e eSymbolTable, WORD nAddress);
+	void SymbolsInvalidateIndex();
 	std::string const* FindSymbolFromAddress(WORD nAdress, int* iTable_ = NULL);
+	std::string const* FindSymbolAtOrBelowAddress(WORD nAddress, WORD& nSymbolAddress_);
 	std::string const& GetSymbol(WORD nAddress, int nBytes, std::string& strAddressBuf);
@@ -355,6 +355,8 @@
 		, CMD_TRACE
 		, CMD_TRACE_FILE
 		, CMD_TRACE_LINE
+		, CMD_TRACE_BACK
+		, CMD_GO_BACK
 		, CMD_UNASSEMBLE
 // Bookmarks
 		, CMD_BOOKMARK
@@ -675,6 +677,8 @@
 	Update_t CmdTrace              (int nArgs);  // alias for CmdStepIn
 	Update_t CmdTraceFile          (int nArgs);
 	Update_t CmdTraceLine          (int nArgs);
+	Update_t CmdTraceBack          (int nArgs);
+	Update_t CmdGoBack             (int nArgs);
 	Update_t CmdUnassemble         (int nArgs); // code dump, aka, Unassemble
 // Bookmarks
 	Update_t CmdBookmark           (int nArgs);
@@ -39,6 +39,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "DiskImage.h"
 #include "Log.h"
 #include "Memory.h"
+#include "PerfCounters.h"
 #include "Registry.h"
 #include "SaveState.h"
 #include "YamlHelper.h"
@@ -70,6 +71,14 @@ Disk2InterfaceCard::Disk2InterfaceCard(UINT slot) :
 	m_diskLastCycle = 0;
 	m_diskLastReadLatchCycle = 0;
 	m_enhanceDisk = true;
+	m_fastDisk = false;
+	m_fastDiskResumePC = 0;
+	m_fastDiskA = 0;
+	m_fastDiskY = 0;
+	m_fastDiskSEI = false;
+	m_fastDiskDrive = 0;
+	m_fastDiskSEICycle = 0;
+	m_fastDiskDoneCycle = 0;
 	m_is13SectorFirmware = false;
 	m_force13SectorFirmware = false;
 	m_deferredStepperEvent = false;
@@ -77,6 +86,7 @@ Disk2InterfaceCard::Disk2InterfaceCard(UINT slot) :
 	m_deferredStepperCumulativeCycles = 0;
 
 	ResetLogicStateSequencer();
+	InitWOZReadTables();
 
 	// Debug:
 #if LOG_DISK_NIBBLES_USE_RUNTIME_VAR
@@ -99,6 +109,8 @@ Disk2InterfaceCard::~Disk2InterfaceCard(void)
 
 bool Disk2InterfaceCard::GetEnhanceDisk(void) { return m_enhanceDisk; }
 void Disk2InterfaceCard::SetEnhanceDisk(bool bEnhanceDisk) { m_enhanceDisk = bEnhanceDisk; }
+bool Disk2InterfaceCard::GetFastDisk(void) { return m_fastDisk; }
+void Disk2InterfaceCard::SetFastDisk(bool bFastDisk) { m_fastDisk = bFastDisk; FastDiskCancel(); }
 
 UINT   Disk2InterfaceCard::GetCurrentBitOffset  (void) { return m_floppyDrive[m_currDrive].m_disk.m_bitOffset; }
 double Disk2InterfaceCard::GetCurrentExtraCycles(void) { return m_floppyDrive[m_currDrive].m_disk.m_extraCycles; }
@@ -1059,6 +1071,9 @@ void Disk2InterfaceCard::UpdateLatchForEmptyDrive(FloppyDrive* pDrive)
 
 void __stdcall Disk2InterfaceCard::ReadWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG uExecutedCycles)
 {
+	if (m_fastDiskPC && FastDiskPending(pc))
+		return;
+
 	FloppyDrive* pDrive = &m_floppyDrive[m_currDrive];
 	FloppyDisk* pFloppy = &pDrive->m_disk;
 
@@ -1117,6 +1132,9 @@ void __stdcall Disk2InterfaceCard::ReadWrite(WORD pc, WORD addr, BYTE bWrite, BY
 			return;	// Early return so don't update: m_diskLastReadLatchCycle & pFloppy->byte
 		}
 
+		if (m_fastDisk && FastDiskRead(pc, *pFloppy))
+			return;
+
 		m_floppyLatch = *(pFloppy->m_trackimage + pFloppy->m_byte);
 		m_diskLastReadLatchCycle = g_nCumulativeCycles;
 
@@ -1173,6 +1191,446 @@ void __stdcall Disk2InterfaceCard::ReadWrite(WORD pc, WORD addr, BYTE bWrite, BY
 
 //===========================================================================
 
+// Fast disk:
+// . Opt-in. Recognise the standard DOS 3.3 RWTS and ProDOS Disk II driver routines when they poll the data latch,
+//   then run their search & decode loops natively on the track's nibbles, instead of emulating the LDA/BPL polling
+//   loop (and its processing) for each nibble.
+// . Routines are identified by their code, with the absolute addresses of their buffers & variables masked out,
+//   so relocated copies also match (eg. DOS 3.3's RWTS at $3700 whilst booting, then at $B700).
+// . The guest resumes after the native loops, with A, Y & its variables exactly as the 6502 code would have left them,
+//   so the routine's own checks (eg. checksum & epilogue) and exits still run as normal.
+// . Authentic speed: the latch reads as "not ready" until the disk would have spun past the nibbles consumed,
+//   so the guest spends the same number of cycles as when reading each nibble. ProDOS's RDADR16 runs SEI once it has
+//   found the prologue, so IRQs are masked from that cycle on, as for the 6502 code.
+// . Enhanced speed: the guest resumes immediately (enhanced reads don't wait for the disk to spin either).
+// . Scope: only DOS 3.3's RDADR16 & READ16 and ProDOS's RDADR16. Not handled, so using the normal emulation:
+//   - Writes (DOS 3.3's WRITE16 & ProDOS's): these are cycle-counted, not polling loops, so there is no spin to skip.
+//   - ProDOS's data field read: unlike READ16, it decodes straight into the caller's buffer through operands that it
+//     patches before each read, so it would need its own native decoder.
+//   - Anything else (eg. custom loaders, copy-protection, .woz images).
+
+enum FastDiskRoutine_e {FD_RDADR16, FD_READ16};
+
+struct FastDiskRoutine
+{
+	FastDiskRoutine_e type;
+	const char* name;
+	const short* code;		// -1: any byte (ie. an absolute address)
+	UINT codeSize;
+	UINT latchReadPC;		// offset of the PC after the routine's 1st "LDA $C08C,X" (ie. the one that is trapped)
+	UINT errorPC;			// offset to resume at, for the routine to fail (SEC : RTS)
+	UINT donePC;			// offset to resume at, after the native loops
+	UINT var[4];			// offsets of the instructions (zp or abs) that store the routine's variables
+	bool isProDOS;			// absolute (not zp) variables, and SEI once the address field's prologue has been found
+};
+
+static const short kFastDiskAny = -1;
+
+// DOS 3.3 RWTS: RDADR16 ($B944). var = {counter, checksum, odd 4&4 byte, fields (abs,Y)}
+static const short g_fastDiskDOS33RDADR16[] =
+{
+	0xA0,0xFC, 0x84,0x26, 0xC8, 0xD0,0x04, 0xE6,0x26, 0xF0,0xF3, 0xBD,0x8C,0xC0, 0x10,0xFB,
+	0xC9,0xD5, 0xD0,0xF0, 0xEA, 0xBD,0x8C,0xC0, 0x10,0xFB, 0xC9,0xAA, 0xD0,0xF2, 0xA0,0x03,
+	0xBD,0x8C,0xC0, 0x10,0xFB, 0xC9,0x96, 0xD0,0xE7, 0xA9,0x00, 0x85,0x27, 0xBD,0x8C,0xC0,
+	0x10,0xFB, 0x2A, 0x85,0x26, 0xBD,0x8C,0xC0, 0x10,0xFB, 0x25,0x26, 0x99,0x2C,0x00, 0x45,
+	0x27, 0x88, 0x10,0xE7, 0xA8, 0xD0,0xB7,
+};
+
+// DOS 3.3 RWTS: READ16 ($B8DC). var = {temp Y, nibble translate table (abs,Y), NBUF2 (abs,Y), NBUF1 (abs,Y)}
+static const short g_fastDiskDOS33READ16[] =
+{
+	0xA0,0x20, 0x88, 0xF0,0x61, 0xBD,0x8C,0xC0, 0x10,0xFB, 0x49,0xD5, 0xD0,0xF4, 0xEA, 0xBD,
+	0x8C,0xC0, 0x10,0xFB, 0xC9,0xAA, 0xD0,0xF2, 0xA0,0x56, 0xBD,0x8C,0xC0, 0x10,0xFB, 0xC9,
+	0xAD, 0xD0,0xE7, 0xA9,0x00, 0x88, 0x84,0x26, 0xBC,0x8C,0xC0, 0x10,0xFB, 0x59,0x00,kFastDiskAny,
+	0xA4,0x26, 0x99,0x00,kFastDiskAny, 0xD0,0xEE, 0x84,0x26, 0xBC,0x8C,0xC0, 0x10,0xFB, 0x59,0x00,
+	kFastDiskAny, 0xA4,0x26, 0x99,0x00,kFastDiskAny, 0xC8, 0xD0,0xEE, 0xBC,0x8C,0xC0, 0x10,0xFB, 0xD9,
+	0x00,kFastDiskAny,
+};
+
+// ProDOS: Disk II driver's RDADR16 ($D398 for ProDOS 8 v2.4.3). Same as DOS 3.3's, but with absolute variables & SEI
+#define ABS_ANY kFastDiskAny,kFastDiskAny
+static const short g_fastDiskProDOSRDADR16[] =
+{
+	0xA0,0xFC, 0x8C,ABS_ANY, 0xC8, 0xD0,0x05, 0xEE,ABS_ANY, 0xF0,0x56, 0xBD,0x8C,0xC0,
+	0x10,0xFB, 0xC9,0xD5, 0xD0,0xEF, 0xEA, 0xBD,0x8C,0xC0, 0x10,0xFB, 0xC9,0xAA, 0xD0,0xF2,
+	0xA0,0x03, 0xBD,0x8C,0xC0, 0x10,0xFB, 0xC9,0x96, 0xD0,0xE7, 0x78, 0xA9,0x00, 0x8D,ABS_ANY,
+	0xBD,0x8C,0xC0, 0x10,0xFB, 0x2A, 0x8D,ABS_ANY, 0xBD,0x8C,0xC0, 0x10,0xFB, 0x2D,ABS_ANY,
+	0x99,ABS_ANY, 0x4D,ABS_ANY, 0x88, 0x10,0xE3, 0xA8, 0xD0,0x15,
+};
+#undef ABS_ANY
+
+static const FastDiskRoutine g_fastDiskRoutines[] =
+{
+	{FD_RDADR16, "DOS 3.3 RDADR16", g_fastDiskDOS33RDADR16, sizeof(g_fastDiskDOS33RDADR16) / sizeof(g_fastDiskDOS33RDADR16[0]), 0x0E, 0x07, 0x44, {0x02, 0x2B, 0x33, 0x3C}, false},
+	{FD_READ16, "DOS 3.3 READ16", g_fastDiskDOS33READ16, sizeof(g_fastDiskDOS33READ16) / sizeof(g_fastDiskDOS33READ16[0]), 0x08, 0x02, 0x4E, {0x26, 0x2D, 0x32, 0x43}, false},
+	{FD_RDADR16, "ProDOS RDADR16", g_fastDiskProDOSRDADR16, sizeof(g_fastDiskProDOSRDADR16) / sizeof(g_fastDiskProDOSRDADR16[0]), 0x10, 0x08, 0x4B, {0x02, 0x2E, 0x37, 0x42}, true},
+};
+
+static bool FastDiskMatch(const FastDiskRoutine& routine, const WORD start)
+{
+	for (UINT i = 0; i < routine.codeSize; i++)
+	{
+		if (routine.code[i] != kFastDiskAny && routine.code[i] != ReadByteFromMemory(start + i))
+			return false;
+	}
+
+	return true;
+}
+
+// Pre: addr is an STA/STY instruction: zero-page, absolute or absolute,Y
+static WORD FastDiskVarAddr(const WORD addr)
+{
+	const BYTE opcode = ReadByteFromMemory(addr);
+	const bool isZeroPage = ((opcode >> 2) & 7) == 1;
+	return isZeroPage ? ReadByteFromMemory(addr + 1) : ReadWordFromMemory(addr + 1);
+}
+
+// The nibbles as seen by the guest's "LDA $C08C,X : BPL" polling loops
+class FastDiskTrack
+{
+public:
+	FastDiskTrack(const FloppyDisk& floppy)
+		: m_floppy(floppy), m_byte(floppy.m_byte), m_count(0), m_maxCount(floppy.m_nibbles * 2)
+	{
+	}
+
+	// Returns 0 if the routine has read for too long (eg. no sync'd nibbles on this track)
+	BYTE Read(void)
+	{
+		while (m_count < m_maxCount)
+		{
+			const BYTE nibble = m_floppy.m_trackimage[m_byte];
+			if (++m_byte >= m_floppy.m_nibbles)
+				m_byte = 0;
+			m_count++;
+
+			if (nibble & 0x80)
+				return nibble;
+		}
+
+		return 0;
+	}
+
+	bool IsOverrun(void) { return m_count >= m_maxCount; }
+	int GetByte(void) { return m_byte; }
+	UINT GetCount(void) { return m_count; }
+
+private:
+	const FloppyDisk& m_floppy;
+	int m_byte;
+	UINT m_count;
+	const UINT m_maxCount;
+};
+
+struct FastDiskResult
+{
+	WORD resumePC;
+	BYTE a;
+	BYTE y;
+	BYTE lastNibble;
+	bool sei;
+	UINT seiCycles;		// for the 6502 code to have run its SEI (if sei)
+	UINT cycles;		// for the 6502 code to have run up to resumePC
+	std::vector<std::pair<WORD, BYTE>> writes;
+};
+
+// Cycles for "LDA $C08C,X : BPL" when the nibble is ready
+static const UINT kFastDiskReadCycles = 4 + 2;
+
+// RDADR16: find the next address field (D5 AA 96), then decode its 4&4 volume, track, sector & checksum
+static bool FastDiskRDADR16(const FastDiskRoutine& routine, const WORD start, FastDiskTrack& track, FastDiskResult& result)
+{
+	const WORD counterAddr = FastDiskVarAddr(start + routine.var[0]);
+	const WORD checksumAddr = FastDiskVarAddr(start + routine.var[1]);
+	const WORD oddAddr = FastDiskVarAddr(start + routine.var[2]);
+	const WORD fieldsAddr = FastDiskVarAddr(start + routine.var[3]);
+	const UINT varCycles = routine.isProDOS ? 4 : 3;	// abs or zp
+
+	BYTE y = regs.y;
+	BYTE counter = ReadByteFromMemory(counterAddr);
+	BYTE a = 0;
+	UINT cycles = 0;
+
+	while (true)
+	{
+		a = track.Read();
+		cycles += kFastDiskReadCycles;
+		if (track.IsOverrun())
+			return false;
+
+		bool found = false;
+		while (a == 0xD5)
+		{
+			a = track.Read();
+			cycles += 2 + 2 + 2 + kFastDiskReadCycles + 2;	// CMP #$D5, BNE, NOP, read, CMP #$AA
+			if (a != 0xAA)
+			{
+				cycles += 3;
+				continue;	// compare with $D5 again
+			}
+
+			y = 3;
+			a = track.Read();
+			cycles += 2 + 2 + kFastDiskReadCycles + 2;		// BNE, LDY #3, read, CMP #$96
+			found = (a == 0x96);
+			cycles += found ? 2 : 3;
+		}
+
+		if (found)
+			break;
+
+		cycles += 2 + 3 + 2;	// CMP #$D5, BNE, INY
+		if (++y != 0)
+		{
+			cycles += 3;
+			continue;
+		}
+
+		cycles += 2;
+		if (++counter == 0)
+		{
+			// Resume at "INC counter : BEQ error" to fail
+			result.writes.push_back(std::make_pair(counterAddr, (BYTE)0xFF));
+			result.resumePC = start + routine.errorPC;
+			result.a = a;
+			result.y = y;
+			result.lastNibble = a;
+			result.sei = false;
+			result.cycles = cycles;
+			return true;
+		}
+		cycles += varCycles + 2 + 2;	// INC, BEQ
+	}
+
+	result.writes.push_back(std::make_pair(counterAddr, counter));
+
+	// 4&4: ROL's carry is always set, as CMP #$96 set it, and then every odd byte has b7 set
+	a = 0;
+	cycles += routine.isProDOS ? 2 : 0;	// SEI
+	result.seiCycles = cycles;
+	cycles += 2;	// LDA #0
+	BYTE nibble = 0;
+	for (int i = 3; i >= 0; i--)
+	{
+		result.writes.push_back(std::make_pair(checksumAddr, a));
+		const BYTE odd = (track.Read() << 1) | 1;
+		result.writes.push_back(std::make_pair(oddAddr, odd));
+		nibble = track.Read();
+		const BYTE field = nibble & odd;
+		result.writes.push_back(std::make_pair((WORD)(fieldsAddr + i), field));
+		a ^= field;
+		// STA, read, ROL, STA, read, AND, STA abs,Y, EOR, DEY, BPL
+		cycles += varCycles + kFastDiskReadCycles + 2 + varCycles + kFastDiskReadCycles + varCycles + 5 + varCycles + 2 + (i ? 3 : 2);
+	}
+
+	if (track.IsOverrun())
+		return false;
+
+	// Resume at "TAY : BNE error" to check the checksum, then the epilogue
+	result.resumePC = start + routine.donePC;
+	result.a = a;
+	result.y = 0xFF;
+	result.lastNibble = nibble;
+	result.sei = routine.isProDOS;
+	result.cycles = cycles;
+	return true;
+}
+
+// READ16: find the data field (D5 AA AD), then read its 342 6&2 nibbles into NBUF2 & NBUF1
+static bool FastDiskREAD16(const FastDiskRoutine& routine, const WORD start, FastDiskTrack& track, FastDiskResult& result)
+{
+	const WORD tempAddr = FastDiskVarAddr(start + routine.var[0]);
+	const WORD tableAddr = FastDiskVarAddr(start + routine.var[1]);
+	const WORD nbuf2Addr = FastDiskVarAddr(start + routine.var[2]);
+	const WORD nbuf1Addr = FastDiskVarAddr(start + routine.var[3]);
+
+	BYTE y = regs.y;
+	BYTE a = 0;
+	UINT cycles = 0;
+
+	while (true)
+	{
+		a = track.Read() ^ 0xD5;
+		cycles += kFastDiskReadCycles + 2;	// read, EOR #$D5
+		if (track.IsOverrun())
+			return false;
+
+		bool found = false;
+		while (a == 0)
+		{
+			a = track.Read();
+			cycles += 2 + 2 + kFastDiskReadCycles + 2;	// BNE, NOP, read, CMP #$AA
+			if (a == 0xAA)
+			{
+				y = 0x56;
+				a = track.Read();
+				cycles += 2 + 2 + kFastDiskReadCycles + 2;	// BNE, LDY #$56, read, CMP #$AD
+				found = (a == 0xAD);
+			}
+			if (!found)
+			{
+				a ^= 0xD5;	// compare with $D5 again
+				cycles += 3 + 2;	// BNE, EOR #$D5
+			}
+		}
+
+		if (found)
+			break;
+
+		cycles += 3;	// BNE
+		if (--y == 0)
+		{
+			// Resume at "DEY : BEQ error" to fail
+			result.resumePC = start + routine.errorPC;
+			result.a = a;
+			result.y = 1;
+			result.lastNibble = a ^ 0xD5;
+			result.sei = false;
+			result.cycles = cycles;
+			return true;
+		}
+		cycles += 2 + 2;	// DEY, BEQ
+	}
+
+	BYTE table[256] = {0};
+	for (UINT i = 0x80; i < 0x100; i++)
+		table[i] = ReadByteFromMemory(tableAddr + i);
+
+	a = 0;
+	y = 0x56;
+	cycles += 2 + 2;	// BNE, LDA #0
+	do
+	{
+		y--;
+		a ^= table[track.Read()];
+		result.writes.push_back(std::make_pair((WORD)(nbuf2Addr + y), a));
+		cycles += 2 + 3 + kFastDiskReadCycles + 4 + 3 + 5 + (y ? 3 : 2);	// DEY, STY, read, EOR, LDY, STA, BNE
+	}
+	while (y != 0);
+
+	do
+	{
+		a ^= table[track.Read()];
+		result.writes.push_back(std::make_pair((WORD)(nbuf1Addr + y), a));
+		y++;
+		cycles += 3 + kFastDiskReadCycles + 4 + 3 + 5 + 2 + (y ? 3 : 2);	// STY, read, EOR, LDY, STA, INY, BNE
+	}
+	while (y != 0);
+
+	result.writes.push_back(std::make_pair(tempAddr, (BYTE)0xFF));
+	y = track.Read();	// checksum
+	cycles += kFastDiskReadCycles;
+
+	if (track.IsOverrun())
+		return false;
+
+	// Resume at "CMP table,Y : BNE error" to check the checksum, then the epilogue
+	result.resumePC = start + routine.donePC;
+	result.a = a;
+	result.y = y;
+	result.lastNibble = y;
+	result.sei = false;
+	result.cycles = cycles;
+	return true;
+}
+
+// Pre: non-.woz image, read mode, drive spinning, and the authentic mode's spin has been applied to floppy.m_byte
+// Returns true if the latch read was the start of a recognised routine, which has now been run natively
+bool Disk2InterfaceCard::FastDiskRead(WORD pc, FloppyDisk& floppy)
+{
+	for (UINT i = 0; i < sizeof(g_fastDiskRoutines) / sizeof(g_fastDiskRoutines[0]); i++)
+	{
+		const FastDiskRoutine& routine = g_fastDiskRoutines[i];
+		const WORD start = pc - routine.latchReadPC;
+		if (!FastDiskMatch(routine, start))
+			continue;
+
+		FastDiskTrack track(floppy);
+		FastDiskResult result;
+		const bool ok = (routine.type == FD_RDADR16) ? FastDiskRDADR16(routine, start, track, result)
+													 : FastDiskREAD16(routine, start, track, result);
+		if (!ok)
+			return false;	// Fallback to reading each nibble
+
+		LOG_DISK("fast disk: %s at %04X: %d nibbles, resume at %04X\n", routine.name, start, track.GetCount(), result.resumePC);
+
+#if LOG_DISK_NIBBLES_READ
+		// Pass the consumed nibbles to the log's nibble reader, as if the 6502 had read each one
+		for (UINT j = 0, byte = floppy.m_byte; j < track.GetCount(); j++)
+		{
+			if (floppy.m_trackimage[byte] & 0x80)
+				m_formatTrack.DecodeLatchNibbleRead(floppy.m_trackimage[byte]);
+			if (++byte >= (UINT)floppy.m_nibbles)
+				byte = 0;
+		}
+#endif
+
+		floppy.m_byte = track.GetByte();
+		m_shiftReg = result.lastNibble;
+		m_diskLastReadLatchCycle = g_nCumulativeCycles;
+		GetFrame().FrameDrawDiskStatus();
+
+		m_fastDiskPC = pc;
+		m_fastDiskResumePC = result.resumePC;
+		m_fastDiskA = result.a;
+		m_fastDiskY = result.y;
+		m_fastDiskSEI = result.sei;
+		m_fastDiskDrive = m_currDrive;
+		m_fastDiskSEICycle = g_nCumulativeCycles + (m_enhanceDisk || !result.sei ? 0 : result.seiCycles);
+		m_fastDiskDoneCycle = g_nCumulativeCycles + (m_enhanceDisk ? 0 : result.cycles);
+		m_fastDiskWrites.swap(result.writes);	// Written to memory when the routine completes (not now, as the 6502 is still in its first loop)
+
+		return FastDiskPending(pc);
+	}
+
+	return false;
+}
+
+// Returns true if this latch read is for the routine that was run natively (ie. the guest is in its polling loop)
+bool Disk2InterfaceCard::FastDiskPending(WORD pc)
+{
+	if (pc != m_fastDiskPC || m_currDrive != m_fastDiskDrive)
+	{
+		FastDiskCancel();	// eg. interrupted, then drive switched
+		return false;
+	}
+
+	// Keep the interrupt state that the routine would have at this point: IRQs can be taken whilst it searches
+	// for the prologue, but not once it has run its SEI
+	if (m_fastDiskSEI && g_nCumulativeCycles >= m_fastDiskSEICycle)
+		regs.ps |= AF_INTERRUPT;
+
+	if (g_nCumulativeCycles < m_fastDiskDoneCycle)
+	{
+		m_floppyLatch = 0x00;	// Not ready: so "BPL" loops
+		return true;
+	}
+
+	// The "LDA $C08C,X" completes with the routine's A, then resumes after its loops
+	for (UINT i = 0; i < m_fastDiskWrites.size(); i++)
+		WriteByteToMemory(m_fastDiskWrites[i].first, m_fastDiskWrites[i].second);
+	m_fastDiskWrites.clear();
+
+	m_floppyLatch = m_fastDiskA;
+	regs.y = m_fastDiskY;
+	regs.pc = m_fastDiskResumePC;
+
+	m_fastDiskPC = 0;
+	m_diskLastCycle = g_nCumulativeCycles;
+	m_diskLastReadLatchCycle = g_nCumulativeCycles;
+	return true;
+}
+
+void Disk2InterfaceCard::FastDiskCancel(void)
+{
+	// NB. The disk has already spun past the routine's nibbles, so just continue from there
+	m_fastDiskPC = 0;
+	m_fastDiskWrites.clear();	// The guest will see a read error and retry
+	m_diskLastCycle = g_nCumulativeCycles;
+}
+
+//===========================================================================
+
 void Disk2InterfaceCard::ResetLogicStateSequencer(void)
 {
 	m_shiftReg = 0;
@@ -1304,9 +1762,14 @@ void Disk2InterfaceCard::AddJitter(int phase, FloppyDisk& floppy)
 // Example of high sync FF/10 run-lengths for tracks 33.0+:
 // . Accolade Comics:114, Silent Service:117, Wings of Fury:140, Wizardry I:127, Wizardry III:283
 // NB. Restrict to higher FF/10 run-lengths to limit the titles affected by this jitter.
+bool Disk2InterfaceCard::IsTrackSeamJitterEnabled(float phasePrecise, FloppyDisk& floppy)
+{
+	return phasePrecise >= (33.0 * 2) && floppy.m_longestSyncFFRunLength > 110;
+}
+
 void Disk2InterfaceCard::AddTrackSeamJitter(float phasePrecise, FloppyDisk& floppy)
 {
-	if (phasePrecise >= (33.0 * 2) && floppy.m_longestSyncFFRunLength > 110)
+	if (IsTrackSeamJitterEnabled(phasePrecise, floppy))
 	{
 		if (floppy.m_bitOffset == floppy.m_longestSyncFFBitOffsetStart)
 		{
@@ -1420,6 +1883,12 @@ void Disk2InterfaceCard::DataLatchReadWOZ(WORD pc, WORD addr, UINT bitCellRemain
 
 	for (UINT i = 0; i < bitCellRemainder; i++)
 	{
+#if !LOG_DISK_ENABLED
+		i += DataLatchReadWOZBulk(drive, floppy, bitCellRemainder - i);
+		if (i == bitCellRemainder)
+			break;
+#endif
+
 		BYTE n = floppy.m_trackimage[floppy.m_byte];
 
 		drive.m_headWindow <<= 1;
@@ -1495,6 +1964,190 @@ void Disk2InterfaceCard::DataLatchReadWOZ(WORD pc, WORD addr, UINT bitCellRemain
 #endif
 }
 
+// Fast path for DataLatchReadWOZ(): read 4 bit-cells per step, using tables built from the bit-at-a-time sequencer above.
+// . g_WOZHeadWindowOutput[]: old head window (4 bits) + 4 new bit-cells -> the 4 output bits (or, a random bit is needed).
+// . g_WOZLatchSteps[][][]: latch delay + shift register + 4 output bits -> new state, and the latch updates.
+// Returns the number of bit-cells read (a multiple of 4). It stops where the bit-at-a-time path is needed:
+// MC3470 random bits, the track's end/seam, or an unexpected latch delay.
+
+struct WOZLatchStep
+{
+	BYTE shiftReg;
+	BYTE latchDelayIdx;
+	BYTE latch;				// last value latched (if WOZ_LATCH_UPDATED)
+	BYTE nibble;			// nibble latched (if WOZ_LATCH_NIBBLE)
+	BYTE flags;
+	BYTE dbgLatchDelayedInc;
+};
+
+enum
+{
+	WOZ_LATCH_UPDATED		= 1<<0,
+	WOZ_LATCH_NIBBLE		= 1<<1,
+	WOZ_LATCH_DBG_RESET		= 1<<2,	// m_dbgLatchDelayedCnt = 0 (before adding dbgLatchDelayedInc)
+};
+
+static const int WOZ_RANDOM_BIT = 0xFF;
+static const int g_WOZLatchDelays[] = {0, 3, 4, 7};	// all the latch delays the sequencer produces
+static const UINT NUM_WOZ_LATCH_DELAYS = sizeof(g_WOZLatchDelays) / sizeof(g_WOZLatchDelays[0]);
+
+static BYTE g_WOZHeadWindowOutput[256];
+static WOZLatchStep g_WOZLatchSteps[NUM_WOZ_LATCH_DELAYS][256][16];
+static bool g_WOZReadTablesInit = false;
+
+void Disk2InterfaceCard::InitWOZReadTables(void)
+{
+	if (g_WOZReadTablesInit)
+		return;
+
+	for (UINT window = 0; window < 256; window++)
+	{
+		BYTE output = 0;
+		for (int i = 3; i >= 0; i--)
+		{
+			const BYTE headWindow = (window >> i) & 0xf;
+			if (!headWindow)
+			{
+				output = WOZ_RANDOM_BIT;
+				break;
+			}
+			output = (output << 1) | ((headWindow >> 1) & 1);
+		}
+		g_WOZHeadWindowOutput[window] = output;
+	}
+
+	for (UINT delayIdx = 0; delayIdx < NUM_WOZ_LATCH_DELAYS; delayIdx++)
+	{
+		for (UINT shiftReg = 0; shiftReg < 256; shiftReg++)
+		{
+			for (UINT output = 0; output < 16; output++)
+			{
+				// Same as the per bit-cell sequencing in DataLatchReadWOZ()
+				BYTE reg = shiftReg;
+				int latchDelay = g_WOZLatchDelays[delayIdx];
+				WOZLatchStep step = {0};
+
+				for (int i = 3; i >= 0; i--)
+				{
+					reg = (reg << 1) | ((output >> i) & 1);
+
+					if (latchDelay)
+					{
+						latchDelay -= 4;
+						if (latchDelay < 0)
+							latchDelay = 0;
+
+						if (reg)
+						{
+							step.flags |= WOZ_LATCH_DBG_RESET;
+							step.dbgLatchDelayedInc = 0;
+						}
+						else
+						{
+							latchDelay += 4;
+							step.dbgLatchDelayedInc++;
+						}
+					}
+
+					if (!latchDelay)
+					{
+						step.flags |= WOZ_LATCH_UPDATED;
+						step.latch = reg;
+
+						if (reg & 0x80)
+						{
+							step.flags |= WOZ_LATCH_NIBBLE;
+							step.nibble = reg;
+							latchDelay = 7;
+							reg = 0;
+						}
+					}
+				}
+
+				step.shiftReg = reg;
+				for (UINT j = 0; j < NUM_WOZ_LATCH_DELAYS; j++)
+				{
+					if (g_WOZLatchDelays[j] == latchDelay)
+						step.latchDelayIdx = j;
+				}
+
+				g_WOZLatchSteps[delayIdx][shiftReg][output] = step;
+			}
+		}
+	}
+
+	g_WOZReadTablesInit = true;
+}
+
+UINT Disk2InterfaceCard::DataLatchReadWOZBulk(FloppyDrive& drive, FloppyDisk& floppy, const UINT bitCells)
+{
+	if (floppy.m_bitCount == 0)
+		return 0;
+
+	UINT delayIdx = 0;
+	while (delayIdx < NUM_WOZ_LATCH_DELAYS && g_WOZLatchDelays[delayIdx] != m_latchDelay)
+		delayIdx++;
+	if (delayIdx == NUM_WOZ_LATCH_DELAYS)
+		return 0;	// eg. from an old save-state
+
+	// Stop before IncBitStream() would wrap, and before the track seam's jitter point
+	const UINT startBitOffset = floppy.m_bitOffset;
+	UINT lastBitOffset = std::min(startBitOffset + bitCells, floppy.m_bitCount - 1);
+	if (IsTrackSeamJitterEnabled(drive.m_phasePrecise, floppy) && floppy.m_longestSyncFFBitOffsetStart > (int)startBitOffset)
+		lastBitOffset = std::min(lastBitOffset, (UINT)floppy.m_longestSyncFFBitOffsetStart - 1);
+
+	UINT bitOffset = startBitOffset;
+	BYTE headWindow = drive.m_headWindow;
+	BYTE shiftReg = m_shiftReg;
+
+	while (bitOffset + 4 <= lastBitOffset)
+	{
+		// Next 4 bit-cells (MSB first)
+		const UINT byte = bitOffset / 8;
+		const UINT shift = bitOffset & 7;
+		UINT bits = floppy.m_trackimage[byte] << 8;
+		if (shift > 4)
+			bits |= floppy.m_trackimage[byte + 1];
+		bits = (bits >> (12 - shift)) & 0xf;
+
+		const BYTE output = g_WOZHeadWindowOutput[((headWindow & 0xf) << 4) | bits];
+		if (output == WOZ_RANDOM_BIT)
+			break;
+
+		const WOZLatchStep& step = g_WOZLatchSteps[delayIdx][shiftReg][output];
+
+		headWindow = (headWindow << 4) | bits;
+		shiftReg = step.shiftReg;
+		delayIdx = step.latchDelayIdx;
+		if (step.flags & WOZ_LATCH_UPDATED)
+			m_floppyLatch = step.latch;
+		if (step.flags & WOZ_LATCH_DBG_RESET)
+			m_dbgLatchDelayedCnt = 0;
+		m_dbgLatchDelayedCnt += step.dbgLatchDelayedInc;
+
+#if LOG_DISK_NIBBLES_READ
+		if (step.flags & WOZ_LATCH_NIBBLE)
+			m_formatTrack.DecodeLatchNibbleRead(step.nibble);
+#endif
+
+		bitOffset += 4;
+	}
+
+	if (bitOffset == startBitOffset)
+		return 0;
+
+	drive.m_headWindow = headWindow;
+	m_shiftReg = shiftReg;
+	m_latchDelay = g_WOZLatchDelays[delayIdx];
+
+	floppy.m_bitOffset = bitOffset;
+	if (floppy.m_initialBitOffset > startBitOffset && floppy.m_initialBitOffset <= bitOffset)
+		floppy.m_revs++;
+	UpdateBitStreamOffsets(floppy);
+
+	return bitOffset - startBitOffset;
+}
+
 void Disk2InterfaceCard::DataLoadWriteWOZ(WORD pc, WORD addr, UINT bitCellRemainder)
 {
 	_ASSERT(m_seqFunc.function == dataLoadWrite);
@@ -1815,6 +2468,7 @@ void Disk2InterfaceCard::ResetSwitches(void)
 	m_floppyMotorOn = 0;
 	m_magnetStates = 0;
 	m_seqFunc.function = readSequencing;
+	FastDiskCancel();
 }
 
 //===========================================================================
@@ -2122,6 +2776,7 @@ void Disk2InterfaceCard::SetSequencerFunction(WORD addr, ULONG executedCycles)
 
 BYTE __stdcall Disk2InterfaceCard::IORead(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles)
 {
+	PERF_SCOPE(PERF_DISK_NS);
 	CpuCalcCycles(nExecutedCycles);	// g_nCumulativeCycles needed by most Disk I/O functions
 
 	UINT uSlot = ((addr & 0xff) >> 4) - 8;
@@ -2169,6 +2824,7 @@ BYTE __stdcall Disk2InterfaceCard::IORead(WORD pc, WORD addr, BYTE bWrite, BYTE
 
 BYTE __stdcall Disk2InterfaceCard::IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles)
 {
+	PERF_SCOPE(PERF_DISK_NS);
 	CpuCalcCycles(nExecutedCycles);	// g_nCumulativeCycles needed by most Disk I/O functions
 
 	UINT uSlot = ((addr & 0xff) >> 4) - 8;
@@ -2226,7 +2882,8 @@ BYTE __stdcall Disk2InterfaceCard::IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE
 // 7: Deprecated SS_YAML_KEY_LSS_RESET_SEQUENCER, SS_YAML_KEY_DISK_ACCESSED
 // 8: Added: deferred stepper: event, address & cycle
 // 9: Added: absolute path
-static const UINT kUNIT_VERSION = 9;
+// 10: Added: fast disk's pending read
+static const UINT kUNIT_VERSION = 10;
 
 #define SS_YAML_VALUE_CARD_DISK2 "Disk]["
 
@@ -2246,6 +2903,17 @@ static const UINT kUNIT_VERSION = 9;
 #define SS_YAML_KEY_DEFERRED_STEPPER_EVENT "Deferred Stepper Event"
 #define SS_YAML_KEY_DEFERRED_STEPPER_ADDRESS "Deferred Stepper Address"
 #define SS_YAML_KEY_DEFERRED_STEPPER_CYCLE "Deferred Stepper Cycle"
+#define SS_YAML_KEY_FAST_DISK "Fast Disk"
+#define SS_YAML_KEY_FAST_DISK_PC "PC"
+#define SS_YAML_KEY_FAST_DISK_RESUME_PC "Resume PC"
+#define SS_YAML_KEY_FAST_DISK_A "A"
+#define SS_YAML_KEY_FAST_DISK_Y "Y"
+#define SS_YAML_KEY_FAST_DISK_SEI "SEI"
+#define SS_YAML_KEY_FAST_DISK_DRIVE "Drive"
+#define SS_YAML_KEY_FAST_DISK_SEI_CYCLE "SEI Cycle"
+#define SS_YAML_KEY_FAST_DISK_DONE_CYCLE "Done Cycle"
+#define SS_YAML_KEY_FAST_DISK_NUM_WRITES "Num Writes"
+#define SS_YAML_KEY_FAST_DISK_WRITES "Writes"
 
 #define SS_YAML_KEY_DISK2UNIT "Unit"
 #define SS_YAML_KEY_DRIVE_CONNECTED "Drive Connected"
@@ -2313,6 +2981,39 @@ void Disk2InterfaceCard::SaveSnapshotDriveUnit(YamlSaveHelper& yamlSaveHelper, U
 	SaveSnapshotFloppy(yamlSaveHelper, unit);
 }
 
+// Only saved if the guest is in the polling loop of a routine that was run natively
+// . each deferred memory write is saved as 3 bytes: addr (lo), addr (hi), value
+void Disk2InterfaceCard::SaveSnapshotFastDisk(YamlSaveHelper& yamlSaveHelper)
+{
+	if (!m_fastDiskPC)
+		return;
+
+	YamlSaveHelper::Label label(yamlSaveHelper, "%s:\n", SS_YAML_KEY_FAST_DISK);
+	yamlSaveHelper.SaveHexUint16(SS_YAML_KEY_FAST_DISK_PC, m_fastDiskPC);
+	yamlSaveHelper.SaveHexUint16(SS_YAML_KEY_FAST_DISK_RESUME_PC, m_fastDiskResumePC);
+	yamlSaveHelper.SaveHexUint8(SS_YAML_KEY_FAST_DISK_A, m_fastDiskA);
+	yamlSaveHelper.SaveHexUint8(SS_YAML_KEY_FAST_DISK_Y, m_fastDiskY);
+	yamlSaveHelper.SaveBool(SS_YAML_KEY_FAST_DISK_SEI, m_fastDiskSEI);
+	yamlSaveHelper.SaveUint(SS_YAML_KEY_FAST_DISK_DRIVE, m_fastDiskDrive);
+	yamlSaveHelper.SaveHexUint64(SS_YAML_KEY_FAST_DISK_SEI_CYCLE, m_fastDiskSEICycle);
+	yamlSaveHelper.SaveHexUint64(SS_YAML_KEY_FAST_DISK_DONE_CYCLE, m_fastDiskDoneCycle);
+	yamlSaveHelper.SaveUint(SS_YAML_KEY_FAST_DISK_NUM_WRITES, m_fastDiskWrites.size());
+
+	if (!m_fastDiskWrites.empty())
+	{
+		std::vector<BYTE> writes;
+		for (UINT i = 0; i < m_fastDiskWrites.size(); i++)
+		{
+			writes.push_back(m_fastDiskWrites[i].first & 0xff);
+			writes.push_back(m_fastDiskWrites[i].first >> 8);
+			writes.push_back(m_fastDiskWrites[i].second);
+		}
+
+		YamlSaveHelper::Label image(yamlSaveHelper, "%s:\n", SS_YAML_KEY_FAST_DISK_WRITES);
+		yamlSaveHelper.SaveMemory(&writes[0], writes.size());
+	}
+}
+
 void Disk2InterfaceCard::SaveSnapshot(YamlSaveHelper& yamlSaveHelper)
 {
 	YamlSaveHelper::Slot slot(yamlSaveHelper, GetSnapshotCardName(), m_slot, kUNIT_VERSION);
@@ -2332,6 +3033,7 @@ void Disk2InterfaceCard::SaveSnapshot(YamlSaveHelper& yamlSaveHelper)
 	yamlSaveHelper.SaveHexUint16(SS_YAML_KEY_DEFERRED_STEPPER_ADDRESS, m_deferredStepperAddress);			// v8
 	yamlSaveHelper.SaveHexUint64(SS_YAML_KEY_DEFERRED_STEPPER_CYCLE, m_deferredStepperCumulativeCycles);	// v8
 	m_formatTrack.SaveSnapshot(yamlSaveHelper);	// v2
+	SaveSnapshotFastDisk(yamlSaveHelper);		// v10
 
 	SaveSnapshotDriveUnit(yamlSaveHelper, DRIVE_1);
 	SaveSnapshotDriveUnit(yamlSaveHelper, DRIVE_2);
@@ -2492,6 +3194,42 @@ void Disk2InterfaceCard::LoadSnapshotDriveUnit(YamlLoadHelper& yamlLoadHelper, U
 	}
 }
 
+void Disk2InterfaceCard::LoadSnapshotFastDisk(YamlLoadHelper& yamlLoadHelper)
+{
+	if (!yamlLoadHelper.GetSubMap(SS_YAML_KEY_FAST_DISK))
+		return;
+
+	m_fastDiskPC = yamlLoadHelper.LoadUint(SS_YAML_KEY_FAST_DISK_PC);
+	m_fastDiskResumePC = yamlLoadHelper.LoadUint(SS_YAML_KEY_FAST_DISK_RESUME_PC);
+	m_fastDiskA = yamlLoadHelper.LoadUint(SS_YAML_KEY_FAST_DISK_A);
+	m_fastDiskY = yamlLoadHelper.LoadUint(SS_YAML_KEY_FAST_DISK_Y);
+	m_fastDiskSEI = yamlLoadHelper.LoadBool(SS_YAML_KEY_FAST_DISK_SEI);
+	m_fastDiskDrive = yamlLoadHelper.LoadUint(SS_YAML_KEY_FAST_DISK_DRIVE);
+	m_fastDiskSEICycle = yamlLoadHelper.LoadUint64(SS_YAML_KEY_FAST_DISK_SEI_CYCLE);
+	m_fastDiskDoneCycle = yamlLoadHelper.LoadUint64(SS_YAML_KEY_FAST_DISK_DONE_CYCLE);
+	const UINT numWrites = yamlLoadHelper.LoadUint(SS_YAML_KEY_FAST_DISK_NUM_WRITES);
+
+	if (m_fastDiskDrive >= NUM_DRIVES)
+		throw std::runtime_error("Fast Disk: invalid drive");
+
+	if (numWrites)
+	{
+		std::vector<BYTE> writes;
+		if (!yamlLoadHelper.GetSubMap(SS_YAML_KEY_FAST_DISK_WRITES))
+			throw std::runtime_error("Fast Disk: missing writes");
+		yamlLoadHelper.LoadMemory(writes, numWrites * 3);
+		yamlLoadHelper.PopMap();
+
+		if (writes.size() != numWrites * 3)
+			throw std::runtime_error("Fast Disk: mismatched number of writes");
+
+		for (UINT i = 0; i < numWrites; i++)
+			m_fastDiskWrites.push_back(std::make_pair((WORD)(writes[i*3] | (writes[i*3+1] << 8)), writes[i*3+2]));
+	}
+
+	yamlLoadHelper.PopMap();
+}
+
 bool Disk2InterfaceCard::LoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT version)
 {
 	if (version < 1 || version > kUNIT_VERSION)
@@ -2502,6 +3240,8 @@ bool Disk2InterfaceCard::LoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT versi
 	m_enhanceDisk		= yamlLoadHelper.LoadBool(SS_YAML_KEY_ENHANCE_DISK);
 	m_floppyLatch		= yamlLoadHelper.LoadUint(SS_YAML_KEY_FLOPPY_LATCH);
 	m_floppyMotorOn		= yamlLoadHelper.LoadBool(SS_YAML_KEY_FLOPPY_MOTOR_ON);
+	m_fastDiskPC		= 0;
+	m_fastDiskWrites.clear();
 
 	if (version >= 2)
 	{
@@ -2547,6 +3287,11 @@ bool Disk2InterfaceCard::LoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT versi
 		m_deferredStepperCumulativeCycles = yamlLoadHelper.LoadUint64(SS_YAML_KEY_DEFERRED_STEPPER_CYCLE);
 	}
 
+	if (version >= 10)
+	{
+		LoadSnapshotFastDisk(yamlLoadHelper);
+	}
+
 	// Eject all disks first in case Drive-2 contains disk to be inserted into Drive-1
 	for (UINT i=0; i<NUM_DRIVES; i++)
 	{
@@ -194,6 +194,8 @@ public:
 
 	bool GetEnhanceDisk(void);
 	void SetEnhanceDisk(bool bEnhanceDisk);
+	bool GetFastDisk(void);
+	void SetFastDisk(bool bFastDisk);
 
 	static BYTE __stdcall IORead(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
 	static BYTE __stdcall IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
@@ -213,6 +215,8 @@ private:
 	void UpdateBitStreamOffsets(FloppyDisk& floppy);
 	__forceinline void IncBitStream(FloppyDisk& floppy);
 	void DataLatchReadWOZ(WORD pc, WORD addr, UINT bitCellRemainder);
+	UINT DataLatchReadWOZBulk(FloppyDrive& drive, FloppyDisk& floppy, const UINT bitCells);
+	static void InitWOZReadTables(void);
 	void DataLoadWriteWOZ(WORD pc, WORD addr, UINT bitCellRemainder);
 	void DataShiftWriteWOZ(WORD pc, WORD addr, ULONG uExecutedCycles);
 	void SetSequencerFunction(WORD addr, ULONG executedCycles);
@@ -221,6 +225,9 @@ private:
 	bool GetFirmware(WORD lpNameId, BYTE* pDst);
 	void InitFirmware(LPBYTE pCxRomPeripheral);
 	void UpdateLatchForEmptyDrive(FloppyDrive* pDrive);
+	bool FastDiskRead(WORD pc, FloppyDisk& floppy);
+	bool FastDiskPending(WORD pc);
+	void FastDiskCancel(void);
 	void InsertSyncEvent(void);
 	static int SyncEventCallback(int id, int cycles, ULONG uExecutedCycles);
 	void ControlStepperDeferred(void);
@@ -229,13 +236,16 @@ private:
 	void PreJitterCheck(int phase, BYTE latch);
 	void AddJitter(int phase, FloppyDisk& floppy);
 	void AddTrackSeamJitter(float phasePrecise, FloppyDisk& floppy);
+	bool IsTrackSeamJitterEnabled(float phasePrecise, FloppyDisk& floppy);
 
 	void SaveSnapshotFloppy(YamlSaveHelper& yamlSaveHelper, UINT unit);
 	void SaveSnapshotDriveUnit(YamlSaveHelper& yamlSaveHelper, UINT unit);
+	void SaveSnapshotFastDisk(YamlSaveHelper& yamlSaveHelper);
 	bool LoadSnapshotFloppy(YamlLoadHelper& yamlLoadHelper, UINT unit, UINT version, std::vector<BYTE>& track);
 	bool LoadSnapshotDriveUnitv3(YamlLoadHelper& yamlLoadHelper, UINT unit, UINT version, std::vector<BYTE>& track);
 	bool LoadSnapshotDriveUnitv4(YamlLoadHelper& yamlLoadHelper, UINT unit, UINT version, std::vector<BYTE>& track);
 	void LoadSnapshotDriveUnit(YamlLoadHelper& yamlLoadHelper, UINT unit, UINT version);
+	void LoadSnapshotFastDisk(YamlLoadHelper& yamlLoadHelper);
 
 	void __stdcall ControlStepper(WORD, WORD address, BYTE, BYTE, ULONG uExecutedCycles);
 	void __stdcall ControlMotor(WORD, WORD address, BYTE, BYTE, ULONG uExecutedCycles);
@@ -273,6 +283,18 @@ private:
 	FormatTrack m_formatTrack;
 	bool m_enhanceDisk;
 
+	// Fast disk (see FastDiskRead()):
+	bool m_fastDisk;
+	WORD m_fastDiskPC;		// PC of the latch read that is waiting for the disk to spin (or 0)
+	WORD m_fastDiskResumePC;
+	BYTE m_fastDiskA;
+	BYTE m_fastDiskY;
+	bool m_fastDiskSEI;
+	WORD m_fastDiskDrive;
+	unsigned __int64 m_fastDiskSEICycle;	// when the routine's SEI would have run (if m_fastDiskSEI)
+	unsigned __int64 m_fastDiskDoneCycle;
+	std::vector<std::pair<WORD, BYTE>> m_fastDiskWrites;	// the routine's memory writes, deferred until it completes
+
 	static const UINT SPINNING_CYCLES = 1000*1000;		// 1M cycles = ~1.000s
 	static const UINT WRITELIGHT_CYCLES = 1000*1000;	// 1M cycles = ~1.000s
 	static const UINT MOTOR_ON_UNTIL_LSS_STABLE_CYCLES = 0x2EC;	// ~0x2EC-0x990 cycles (depending on card). See GH#864
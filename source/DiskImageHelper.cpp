@@ -41,6 +41,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Log.h"
 #include "Memory.h"
 #include "Interface.h"
+#include "Registry.h"
+#include "StrFormat.h"
+
+#include <sys/stat.h>
+
+static CDecompressedImageCache sg_DecompressedImageCache;
 
 ImageInfo::ImageInfo()
 {
@@ -225,6 +231,8 @@ bool CImageBase::WriteImageData(ImageInfo* pImageInfo, LPBYTE pSrcBuffer, const
 	}
 	else if (pImageInfo->FileType == eFileGZip)
 	{
+		sg_DecompressedImageCache.Erase(pImageInfo->szFilename);
+
 		// Write entire compressed image each time (dirty track change or dirty disk removal or a HDD block is written)
 		gzFile hGZFile = gzopen(pImageInfo->szFilename.c_str(), "wb");
 		if (hGZFile == NULL)
@@ -249,6 +257,8 @@ bool CImageBase::WriteImageData(ImageInfo* pImageInfo, LPBYTE pSrcBuffer, const
 		if (pImageInfo->uNumEntriesInZip > 1)
 			return false;
 
+		sg_DecompressedImageCache.Erase(pImageInfo->szFilename);
+
 		zipFile hZipFile = zipOpen(pImageInfo->szFilename.c_str(), APPEND_STATUS_CREATE);
 		if (hZipFile == NULL)
 			return false;
@@ -1622,40 +1632,265 @@ void CImageHelperBase::GetCharLowerExt2(char* pszExt, LPCTSTR pszImageFilename,
 
 //-----------------
 
-ImageError_e CImageHelperBase::CheckGZipFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo)
+// NB. "\n" can't be part of a pathname, so can separate the fields
+std::string CDecompressedImageCache::GetArchiveKey(LPCTSTR pszArchiveFilename)
+{
+	char szPathname[MAX_PATH] = { 0 };
+	DWORD uNameLen = GetFullPathName(pszArchiveFilename, MAX_PATH, szPathname, NULL);
+	if (uNameLen == 0 || uNameLen >= MAX_PATH)
+		return std::string();
+
+	struct stat fileStat;
+	if (stat(szPathname, &fileStat) != 0)
+		return std::string();
+
+	return StrFormat("%s\n%llu\n%llu\n", szPathname, (unsigned long long)fileStat.st_size, (unsigned long long)fileStat.st_mtime);
+}
+
+// Returns a copy of the cached image (the caller owns it, as for any other pImageBuffer), or NULL if not cached
+BYTE* CDecompressedImageCache::Lookup(const std::string& key, UINT& uSize)
+{
+	if (key.empty())
+		return NULL;
+
+	std::vector<BYTE> loaded;
+	const std::vector<BYTE>* pData = NULL;
+
+	auto it = m_index.find(key);
+	if (it != m_index.end())
+	{
+		m_entries.splice(m_entries.begin(), m_entries, it->second);	// now the most recently used
+		pData = &it->second->second;
+	}
+	else
+	{
+		if (!LoadCacheFile(key, loaded))
+			return NULL;
+		pData = &loaded;
+	}
+
+	uSize = (UINT) pData->size();
+	BYTE* pImageBuffer = new BYTE[uSize];
+	memcpy(pImageBuffer, &(*pData)[0], uSize);
+
+	if (!loaded.empty())
+		Add(key, loaded);
+
+	return pImageBuffer;
+}
+
+void CDecompressedImageCache::Insert(const std::string& key, const BYTE* pData, const UINT uSize)
+{
+	if (key.empty() || uSize == 0 || m_index.find(key) != m_index.end())
+		return;
+
+	std::vector<BYTE> data(pData, pData + uSize);
+	SaveCacheFile(key, data);
+	Add(key, data);
+}
+
+// Called before an archive is re-written
+void CDecompressedImageCache::Erase(const std::string& archivePathname)
+{
+	const std::string prefix = archivePathname + "\n";
+
+	for (EntryList::iterator it = m_entries.begin(); it != m_entries.end(); )
+	{
+		if (it->first.compare(0, prefix.size(), prefix) != 0)
+		{
+			++it;
+			continue;
+		}
+
+		const std::string filename = GetCacheFilename(it->first);
+		if (!filename.empty())
+			remove(filename.c_str());
+
+		m_uTotalSize -= (UINT) it->second.size();
+		m_index.erase(it->first);
+		it = m_entries.erase(it);
+	}
+}
+
+// NB. takes the contents of data
+void CDecompressedImageCache::Add(const std::string& key, std::vector<BYTE>& data)
+{
+	if (data.size() > kMaxTotalSize)
+		return;
+
+	m_entries.push_front(Entry(key, std::vector<BYTE>()));
+	m_entries.front().second.swap(data);
+	m_index[key] = m_entries.begin();
+	m_uTotalSize += (UINT) m_entries.front().second.size();
+
+	while (m_uTotalSize > kMaxTotalSize)
+	{
+		m_uTotalSize -= (UINT) m_entries.back().second.size();
+		m_index.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+}
+
+// Returns "" if the cache isn't persisted
+std::string CDecompressedImageCache::GetCacheFilename(const std::string& key)
+{
+	char szDirectory[MAX_PATH] = { 0 };
+	RegLoadString(REG_PREFS, REGVALUE_PREF_IMAGE_CACHE_DIR, 1, szDirectory, MAX_PATH, "");
+
+	std::string directory = szDirectory;
+	if (directory.empty())
+		return directory;
+
+	if (directory.back() != PATH_SEPARATOR)
+		directory += PATH_SEPARATOR;
+
+	// 64-bit FNV-1a hash of the key
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < key.size(); i++)
+		hash = (hash ^ (BYTE)key[i]) * 0x100000001b3ULL;
+
+	return directory + StrFormat("%016llx.bin", (unsigned long long)hash);
+}
+
+// File: "AWIC", key length (4 bytes, little-endian), key, decompressed image
+// NB. the key is stored & checked, since the filename is only a hash of it
+bool CDecompressedImageCache::LoadCacheFile(const std::string& key, std::vector<BYTE>& data)
+{
+	const std::string filename = GetCacheFilename(key);
+	if (filename.empty())
+		return false;
+
+	FILE* hFile = fopen(filename.c_str(), "rb");
+	if (!hFile)
+		return false;
+
+	bool bRes = false;
+	BYTE header[8];
+	if (fread(header, 1, sizeof(header), hFile) == sizeof(header) && memcmp(header, "AWIC", 4) == 0)
+	{
+		const UINT uKeySize = header[4] | (header[5] << 8) | (header[6] << 16) | (header[7] << 24);
+		std::string fileKey(uKeySize == key.size() ? uKeySize : 0, '\0');
+
+		if (uKeySize == key.size() && fread(&fileKey[0], 1, uKeySize, hFile) == uKeySize && fileKey == key)
+		{
+			fseek(hFile, 0, SEEK_END);
+			const long uDataOffset = sizeof(header) + uKeySize;
+			const long uFileSize = ftell(hFile);
+			if (uFileSize > uDataOffset && uFileSize - uDataOffset <= (long)kMaxTotalSize)
+			{
+				data.resize(uFileSize - uDataOffset);
+				fseek(hFile, uDataOffset, SEEK_SET);
+				bRes = fread(&data[0], 1, data.size(), hFile) == data.size();
+			}
+		}
+	}
+
+	fclose(hFile);
+
+	if (!bRes)
+		data.clear();
+
+	return bRes;
+}
+
+void CDecompressedImageCache::SaveCacheFile(const std::string& key, const std::vector<BYTE>& data)
+{
+	const std::string filename = GetCacheFilename(key);
+	if (filename.empty())
+		return;
+
+	// Write to a temporary file first, so that a partly written file is never used
+	const std::string tempFilename = filename + ".tmp";
+	FILE* hFile = fopen(tempFilename.c_str(), "wb");
+	if (!hFile)
+		return;
+
+	const UINT uKeySize = (UINT) key.size();
+	const BYTE header[8] = { 'A', 'W', 'I', 'C', (BYTE)uKeySize, (BYTE)(uKeySize >> 8), (BYTE)(uKeySize >> 16), (BYTE)(uKeySize >> 24) };
+
+	bool bRes = fwrite(header, 1, sizeof(header), hFile) == sizeof(header);
+	bRes = bRes && fwrite(key.c_str(), 1, uKeySize, hFile) == uKeySize;
+	bRes = bRes && fwrite(&data[0], 1, data.size(), hFile) == data.size();
+	bRes = (fclose(hFile) == 0) && bRes;
+
+	if (bRes)
+	{
+		remove(filename.c_str());
+		bRes = rename(tempFilename.c_str(), filename.c_str()) == 0;
+	}
+
+	if (!bRes)
+	{
+		remove(tempFilename.c_str());
+		LogFileOutput("Image cache: failed to write %s\n", filename.c_str());
+	}
+}
+
+//-----------------
+
+ImageError_e CImageHelperBase::DecompressGZipFile(LPCTSTR pszImageFilename, std::vector<BYTE>& data)
 {
 	gzFile hGZFile = gzopen(pszImageFilename, "rb");
 	if (hGZFile == NULL)
 		return eIMAGE_ERROR_UNABLE_TO_OPEN_GZ;
 
-	// determine uncompressed file length
-	UINT fileSize = 0;
+	// Decompress in a single pass (the uncompressed length isn't known up-front)
+	bool bTooBig = false;
+	int nLen = 0;
 	{
 		const UINT tempBufferSize = 256 * 1024;
 		BYTE* tempBuffer = new BYTE[tempBufferSize];
-		while (int len = gzread(hGZFile, tempBuffer, tempBufferSize))
-			fileSize += len;
+		while ((nLen = gzread(hGZFile, tempBuffer, tempBufferSize)) > 0)
+		{
+			if (data.size() + nLen > GetMaxImageSize())
+			{
+				bTooBig = true;
+				break;
+			}
+			data.insert(data.end(), tempBuffer, tempBuffer + nLen);
+		}
 		delete[] tempBuffer;
-		int res = gzrewind(hGZFile);
-		if (res != 0)
-			return eIMAGE_ERROR_GZ;
 	}
 
-	if (fileSize == 0 || fileSize > GetMaxImageSize())
-		return eIMAGE_ERROR_BAD_SIZE;
-
-	pImageInfo->pImageBuffer = new BYTE[fileSize];
-
-	int nLen = gzread(hGZFile, pImageInfo->pImageBuffer, fileSize);
 	int nRes = gzclose(hGZFile);	// close before returning (due to error) to avoid resource leak
 	hGZFile = NULL;
 
-	if (nLen <= 0)
+	if (bTooBig || data.empty())
 		return eIMAGE_ERROR_BAD_SIZE;
 
-	if (nRes != Z_OK)
+	if (nLen < 0 || nRes != Z_OK)
 		return eIMAGE_ERROR_GZ;
 
+	return eIMAGE_ERROR_NONE;
+}
+
+ImageError_e CImageHelperBase::CheckGZipFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo)
+{
+	const std::string cacheKey = CDecompressedImageCache::GetArchiveKey(pszImageFilename);
+
+	UINT uCachedSize = 0;
+	pImageInfo->pImageBuffer = sg_DecompressedImageCache.Lookup(cacheKey, uCachedSize);
+	int nLen = (int) uCachedSize;
+
+	if (pImageInfo->pImageBuffer)
+	{
+		if (uCachedSize > GetMaxImageSize())	// eg. cached for the other (floppy or hard disk) helper
+			return eIMAGE_ERROR_BAD_SIZE;
+	}
+	else
+	{
+		std::vector<BYTE> data;
+		ImageError_e Err = DecompressGZipFile(pszImageFilename, data);
+		if (Err != eIMAGE_ERROR_NONE)
+			return Err;
+
+		sg_DecompressedImageCache.Insert(cacheKey, &data[0], (UINT) data.size());
+
+		nLen = (int) data.size();
+		pImageInfo->pImageBuffer = new BYTE[nLen];
+		memcpy(pImageInfo->pImageBuffer, &data[0], nLen);
+	}
+
 	//
 
 	// Strip .gz then try to determine the file's extension and convert it to lowercase
@@ -1693,6 +1928,7 @@ ImageError_e CImageHelperBase::CheckZipFile(LPCTSTR pszImageFilename, ImageInfo*
 	ImageInfo* pImageInfo2 = NULL;
 	CImageBase* pImageType = NULL;
 	UINT numValidImages = 0;
+	const std::string archiveKey = CDecompressedImageCache::GetArchiveKey(pszImageFilename);
 
 	try
 	{
@@ -1704,7 +1940,8 @@ ImageError_e CImageHelperBase::CheckZipFile(LPCTSTR pszImageFilename, ImageInfo*
 		if (nRes != UNZ_OK)
 			throw eIMAGE_ERROR_ZIP;
 
-		for (UINT n=0; n<global_info.number_entry; n++)
+		// NB. only need to know if there's more than one valid image (see ImageIsMultiFileZip()), so stop decompressing after the 2nd one
+		for (UINT n=0; n<global_info.number_entry && numValidImages < 2; n++)
 		{
 			if (n)
 			{
@@ -1728,21 +1965,32 @@ ImageError_e CImageHelperBase::CheckZipFile(LPCTSTR pszImageFilename, ImageInfo*
 
 			//
 
-			nRes = unzOpenCurrentFile(hZipFile);
-			if (nRes != UNZ_OK)
-				throw eIMAGE_ERROR_ZIP;
+			const std::string cacheKey = archiveKey.empty() ? archiveKey : archiveKey + szFilename;
+
+			UINT uCachedSize = 0;
+			BYTE* pImageBuffer = sg_DecompressedImageCache.Lookup(cacheKey, uCachedSize);
+			int nLen = (int) uCachedSize;
 
-			BYTE* pImageBuffer = new BYTE[uFileSize];
-			int nLen = unzReadCurrentFile(hZipFile, pImageBuffer, uFileSize);
-			if (nLen < 0)
+			if (!pImageBuffer)
 			{
-				unzCloseCurrentFile(hZipFile);	// Must CloseCurrentFile before Close
-				throw eIMAGE_ERROR_UNSUPPORTED;
-			}
+				nRes = unzOpenCurrentFile(hZipFile);
+				if (nRes != UNZ_OK)
+					throw eIMAGE_ERROR_ZIP;
 
-			nRes = unzCloseCurrentFile(hZipFile);
-			if (nRes != UNZ_OK)
-				throw eIMAGE_ERROR_ZIP;
+				pImageBuffer = new BYTE[uFileSize];
+				nLen = unzReadCurrentFile(hZipFile, pImageBuffer, uFileSize);
+				if (nLen < 0)
+				{
+					unzCloseCurrentFile(hZipFile);	// Must CloseCurrentFile before Close
+					throw eIMAGE_ERROR_UNSUPPORTED;
+				}
+
+				nRes = unzCloseCurrentFile(hZipFile);
+				if (nRes != UNZ_OK)
+					throw eIMAGE_ERROR_ZIP;
+
+				sg_DecompressedImageCache.Insert(cacheKey, pImageBuffer, nLen);
+			}
 
 			// Determine the file's extension and convert it to lowercase
 			char szExt[_MAX_EXT] = "";
@@ -1886,11 +2134,16 @@ ImageError_e CImageHelperBase::CheckNormalFile(LPCTSTR pszImageFilename, ImageIn
 		bool bTempDetectBuffer;
 		const UINT uDetectSize = GetMinDetectSize(dwSize, &bTempDetectBuffer);
 
-		pImageInfo->pImageBuffer = new BYTE [dwSize];
+		// If the image isn't kept in memory, then only read what Detect() needs (eg. just the header of a 32MB HDV)
+		const UINT uReadSize = bTempDetectBuffer ? std::min<UINT>(uDetectSize, dwSize) : dwSize;
+
+		pImageInfo->pImageBuffer = new BYTE [bTempDetectBuffer ? uDetectSize : dwSize];
+		if (bTempDetectBuffer)
+			memset(pImageInfo->pImageBuffer, 0, uDetectSize);
 
 		DWORD dwBytesRead;
-		BOOL bRes = ReadFile(hFile, pImageInfo->pImageBuffer, dwSize, &dwBytesRead, NULL);
-		if (!bRes || dwSize != dwBytesRead)
+		BOOL bRes = ReadFile(hFile, pImageInfo->pImageBuffer, uReadSize, &dwBytesRead, NULL);
+		if (!bRes || uReadSize != dwBytesRead)
 		{
 			delete [] pImageInfo->pImageBuffer;
 			pImageInfo->pImageBuffer = NULL;
@@ -2095,6 +2348,17 @@ CImageBase* CDiskImageHelper::Detect(LPBYTE pImage, uint32_t dwSize, const char*
 		}
 	}
 
+	if (imageType == eImageUNKNOWN)
+	{
+		// Fast path: a signature identifies the format, without trying the content heuristics of the other formats
+		CImageBase* pSignatureImage = GetImage(DetectSignature(pImage, dwSize));
+		if (pSignatureImage && !(*pszExt && strstr(pSignatureImage->GetRejectExtensions(), pszExt)))
+		{
+			if (pSignatureImage->Detect(pImage, dwSize, pszExt) == eMatch)
+				imageType = pSignatureImage->GetType();
+		}
+	}
+
 	if (imageType == eImageUNKNOWN)
 	{
 		for (UINT uLoop=0; uLoop < GetNumImages() && imageType == eImageUNKNOWN; uLoop++)
@@ -2102,6 +2366,9 @@ CImageBase* CDiskImageHelper::Detect(LPBYTE pImage, uint32_t dwSize, const char*
 			if (*pszExt && strstr(GetImage(uLoop)->GetRejectExtensions(), pszExt))
 				continue;
 
+			if (HasSignature(GetImage(uLoop)->GetType()))
+				continue;	// Already tried above
+
 			eDetectResult Result = GetImage(uLoop)->Detect(pImage, dwSize, pszExt);
 			if (Result == eMatch)
 				imageType = GetImage(uLoop)->GetType();
@@ -2158,6 +2425,32 @@ CImageBase* CDiskImageHelper::Detect(LPBYTE pImage, uint32_t dwSize, const char*
 	return pImageType;
 }
 
+// Formats that are identified by a signature at the start of the image
+eImageType CDiskImageHelper::DetectSignature(const LPBYTE pImage, const uint32_t dwSize)
+{
+	if (dwSize >= sizeof(CWOZHelper::WOZHeader))
+	{
+		const CWOZHelper::WOZHeader* pWozHdr = (const CWOZHelper::WOZHeader*) pImage;
+		if (pWozHdr->id1 == CWOZHelper::ID1_WOZ1 && pWozHdr->id2 == CWOZHelper::ID2)
+			return eImageWOZ1;
+		if (pWozHdr->id1 == CWOZHelper::ID1_WOZ2 && pWozHdr->id2 == CWOZHelper::ID2)
+			return eImageWOZ2;
+	}
+
+	if (dwSize > 13 && !strncmp((const char*)pImage, "SIMSYSTEM_IIE", 13))
+		return eImageIIE;
+
+	if (dwSize >= sizeof(DWORD) && *(LPDWORD)pImage == 0x214C470A)	// "!LG\x0A"
+		return eImagePRG;
+
+	return eImageUNKNOWN;
+}
+
+bool CDiskImageHelper::HasSignature(const eImageType Type)
+{
+	return Type == eImageWOZ1 || Type == eImageWOZ2 || Type == eImageIIE || Type == eImagePRG;
+}
+
 CImageBase* CDiskImageHelper::GetImageForCreation(const char* pszExt, uint32_t* pCreateImageSize)
 {
 	// WE CREATE ONLY DOS ORDER (DO), 6656-NIBBLE (NIB) OR WOZ2 (WOZ) FORMAT FILES
@@ -4,6 +4,9 @@
 #include "DiskImage.h"
 #include "minizip/zip.h"
 
+#include <list>
+#include <unordered_map>
+
 #define GZ_SUFFIX ".gz"
 #define GZ_SUFFIX_LEN (sizeof(GZ_SUFFIX)-1)
 
@@ -361,6 +364,37 @@ private:
 
 //-------------------------------------
 
+// Decompressed images from .gz/.zip archives, so that re-inserting or swapping a disk doesn't decompress it again
+// . Keyed by the archive's pathname, size & modification time, and the member's name
+// . An LRU bounded in size, and optionally also persisted as files in a folder (see REGVALUE_PREF_IMAGE_CACHE_DIR)
+class CDecompressedImageCache
+{
+public:
+	CDecompressedImageCache(void) : m_uTotalSize(0) {}
+
+	static std::string GetArchiveKey(LPCTSTR pszArchiveFilename);
+	BYTE* Lookup(const std::string& key, UINT& uSize);
+	void Insert(const std::string& key, const BYTE* pData, const UINT uSize);
+	void Erase(const std::string& archivePathname);
+
+private:
+	typedef std::pair<std::string, std::vector<BYTE>> Entry;
+	typedef std::list<Entry> EntryList;
+
+	void Add(const std::string& key, std::vector<BYTE>& data);
+	std::string GetCacheFilename(const std::string& key);
+	bool LoadCacheFile(const std::string& key, std::vector<BYTE>& data);
+	void SaveCacheFile(const std::string& key, const std::vector<BYTE>& data);
+
+	static const UINT kMaxTotalSize = 64 * 1024 * 1024;
+
+	EntryList m_entries;	// most recently used first
+	std::unordered_map<std::string, EntryList::iterator> m_index;
+	UINT m_uTotalSize;
+};
+
+//-------------------------------------
+
 class CImageHelperBase
 {
 public:
@@ -387,6 +421,7 @@ public:
 
 protected:
 	ImageError_e CheckGZipFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo);
+	ImageError_e DecompressGZipFile(LPCTSTR pszImageFilename, std::vector<BYTE>& data);
 	ImageError_e CheckZipFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo, std::string& strFilenameInZip);
 	ImageError_e CheckNormalFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo, const bool bCreateIfNecessary);
 	void GetCharLowerExt(char* pszExt, LPCTSTR pszImageFilename, const UINT uExtSize);
@@ -435,6 +470,8 @@ public:
 
 private:
 	void SkipMacBinaryHdr(LPBYTE& pImage, uint32_t& dwSize, uint32_t& dwOffset);
+	static eImageType DetectSignature(const LPBYTE pImage, const uint32_t dwSize);
+	static bool HasSignature(const eImageType Type);
 
 private:
 	CMacBinaryHelper m_MacBinaryHelper;
@@ -153,7 +153,7 @@ Overview
 
 
 HarddiskInterfaceCard::HarddiskInterfaceCard(UINT slot) :
-	Card(CT_GenericHDD, slot), m_userNumBlocks(0), m_isFirmwareV1or2(false), m_useHdcFirmwareV1(false), m_useHdcFirmwareV2(false), m_useHdcFirmwareMode(HdcDefault)
+	Card(CT_GenericHDD, slot), m_userNumBlocks(0), m_isFirmwareV1or2(false), m_useHdcFirmwareV1(false), m_useHdcFirmwareV2(false), m_useHdcFirmwareMode(HdcDefault), m_hostVolumeWriteBack(false)
 {
 	if (m_slot != SLOT5 && m_slot != SLOT7)	// fixme
 		ThrowErrorInvalidSlot();
@@ -192,8 +192,14 @@ HarddiskInterfaceCard::~HarddiskInterfaceCard(void)
 void HarddiskInterfaceCard::Reset(const bool powerCycle)
 {
 	for (UINT i = 0; i < NUM_HARDDISKS; i++)
+	{
 		m_hardDiskDrive[i].m_error = 0;
 
+		// Pick up any host-side changes (new/resized files) once no guest OS can be relying on the old layout
+		if (powerCycle && m_hardDiskDrive[i].m_hostVolume)
+			m_hardDiskDrive[i].m_hostVolume->Rescan();
+	}
+
 	m_fifoIdx = 0;
 }
 
@@ -259,6 +265,12 @@ void HarddiskInterfaceCard::CleanupDriveInternal(const int iDrive)
 		m_hardDiskDrive[iDrive].m_imagehandle = NULL;
 	}
 
+	if (m_hardDiskDrive[iDrive].m_hostVolume)
+	{
+		delete m_hardDiskDrive[iDrive].m_hostVolume;	// NB. Flushes any outstanding guest writes to the host directory
+		m_hardDiskDrive[iDrive].m_hostVolume = NULL;
+	}
+
 	m_hardDiskDrive[iDrive].m_imageloaded = false;
 
 	m_hardDiskDrive[iDrive].m_imagename.clear();
@@ -352,6 +364,9 @@ const std::string& HarddiskInterfaceCard::GetFullName(const int iDrive)
 
 const std::string& HarddiskInterfaceCard::HarddiskGetFullPathName(const int iDrive)
 {
+	if (m_hardDiskDrive[iDrive].m_hostVolume)
+		return m_hardDiskDrive[iDrive].m_hostVolume->GetPathname();
+
 	return ImageGetPathname(m_hardDiskDrive[iDrive].m_imagehandle);
 }
 
@@ -385,6 +400,37 @@ void HarddiskInterfaceCard::GetFilenameAndPathForSaveState(std::string& filename
 	}
 }
 
+// Once the guest has stopped writing to a host directory's volume, write its changes back to the host
+// . not after each write, as a guest's update of a file (data, index, bitmap & directory blocks) spans several writes
+void HarddiskInterfaceCard::Update(const ULONG nExecutedCycles)
+{
+	const UINT64 kHostVolumeSyncDelayCycles = 1000*1000;	// ~1s
+
+	for (UINT i = 0; i < NUM_HARDDISKS; i++)
+	{
+		HardDiskDrive& drive = m_hardDiskDrive[i];
+		if (drive.m_hostVolume && drive.m_hostVolume->IsSyncPending() &&
+			(g_nCumulativeCycles - drive.m_hostVolumeWriteCycle) >= kHostVolumeSyncDelayCycles)
+		{
+			drive.m_hostVolume->Flush();
+		}
+	}
+}
+
+void HarddiskInterfaceCard::SetHostVolumeWriteBack(const bool writeBack)
+{
+	m_hostVolumeWriteBack = writeBack;
+
+	for (UINT i = 0; i < NUM_HARDDISKS; i++)
+	{
+		if (m_hardDiskDrive[i].m_hostVolume)
+		{
+			m_hardDiskDrive[i].m_hostVolume->SetWriteBack(writeBack);
+			m_hardDiskDrive[i].m_bWriteProtected = !writeBack;
+		}
+	}
+}
+
 //===========================================================================
 
 void HarddiskInterfaceCard::Destroy(void)
@@ -431,15 +477,32 @@ bool HarddiskInterfaceCard::Insert(const int iDrive, const std::string& pathname
 		}
 	}
 
-	const bool bCreateIfNecessary = false;		// NB. Don't allow creation of HDV files
-	const bool bExpectFloppy = false;
-	const bool bIsHarddisk = true;
-	ImageError_e Error = ImageOpen(pathname,
-		&m_hardDiskDrive[iDrive].m_imagehandle,
-		&m_hardDiskDrive[iDrive].m_bWriteProtected,
-		bCreateIfNecessary,
-		m_hardDiskDrive[iDrive].m_strFilenameInZip,	// TODO: Use this
-		bExpectFloppy);
+	ImageError_e Error = eIMAGE_ERROR_NONE;
+
+	if (ProDOS_HostVolume::IsHostDirectory(pathname))
+	{
+		// A host directory: present it as a ProDOS volume (write-protected, unless write-back is enabled)
+		const BYTE* pBootBlocks = GetFrame().GetResource(IDR_BOOT_SECTOR_PRODOS243, "FIRMWARE", ProDOS_HostVolume::kBootBlocksSize);
+		m_hardDiskDrive[iDrive].m_hostVolume = new ProDOS_HostVolume(pathname, pBootBlocks, m_hostVolumeWriteBack);
+		m_hardDiskDrive[iDrive].m_bWriteProtected = !m_hostVolumeWriteBack;
+		if (!m_hardDiskDrive[iDrive].m_hostVolume->Open())
+		{
+			delete m_hardDiskDrive[iDrive].m_hostVolume;
+			m_hardDiskDrive[iDrive].m_hostVolume = NULL;
+			Error = eIMAGE_ERROR_UNABLE_TO_OPEN;
+		}
+	}
+	else
+	{
+		const bool bCreateIfNecessary = false;		// NB. Don't allow creation of HDV files
+		const bool bExpectFloppy = false;
+		Error = ImageOpen(pathname,
+			&m_hardDiskDrive[iDrive].m_imagehandle,
+			&m_hardDiskDrive[iDrive].m_bWriteProtected,
+			bCreateIfNecessary,
+			m_hardDiskDrive[iDrive].m_strFilenameInZip,	// TODO: Use this
+			bExpectFloppy);
+	}
 
 	m_hardDiskDrive[iDrive].m_imageloaded = (Error == eIMAGE_ERROR_NONE);
 
@@ -622,13 +685,13 @@ BYTE __stdcall HarddiskInterfaceCard::IORead(WORD pc, WORD addr, BYTE bWrite, BY
 		break;
 	case 0x9:
 		if (pHDD->m_imageloaded)
-			r = (BYTE)(pCard->GetImageSizeInBlocks(pHDD->m_imagehandle, true) & 0x00ff);
+			r = (BYTE)(pCard->GetImageSizeInBlocks(pHDD, true) & 0x00ff);
 		else
 			r = 0;
 		break;
 	case 0xa:
 		if (pHDD->m_imageloaded)
-			r = (BYTE)((pCard->GetImageSizeInBlocks(pHDD->m_imagehandle, true) & 0xff00) >> 8);
+			r = (BYTE)((pCard->GetImageSizeInBlocks(pHDD, true) & 0xff00) >> 8);
 		else
 			r = 0;
 		break;
@@ -670,7 +733,7 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD, const ULONG nExecute
 	switch (m_command)
 	{
 	case BLK_Cmd_Status:
-		if (ImageGetImageSize(pHDD->m_imagehandle) == 0)
+		if (GetImageSize(pHDD) == 0)
 			pHDD->m_error = DEVICE_IO_ERROR;
 		LOG_DISK("ST-BLK: %02X\n", pHDD->m_error);
 		break;
@@ -685,11 +748,11 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD, const ULONG nExecute
 	case SP_Cmd_readblock:
 		LOG_DISK("RD: %08X (to addr: %04X)\n", pHDD->m_diskblock, pHDD->m_memblock);
 		pHDD->m_status_next = DISK_STATUS_READ;
-		if ((pHDD->m_diskblock * HD_BLOCK_SIZE) < ImageGetImageSize(pHDD->m_imagehandle))
+		if ((pHDD->m_diskblock * HD_BLOCK_SIZE) < GetImageSize(pHDD))
 		{
 			bool breakpointHit = false;
 
-			bool bRes = ImageReadBlock(pHDD->m_imagehandle, pHDD->m_diskblock, pHDD->m_buf);
+			bool bRes = ReadBlock(pHDD, pHDD->m_diskblock, pHDD->m_buf);
 			if (bRes)
 			{
 				pHDD->m_buf_ptr = 0;
@@ -761,7 +824,7 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD, const ULONG nExecute
 		{
 			pHDD->m_status_next = DISK_STATUS_WRITE;
 			bool bRes = true;
-			const bool bAppendBlocks = (pHDD->m_diskblock * HD_BLOCK_SIZE) >= ImageGetImageSize(pHDD->m_imagehandle);
+			const bool bAppendBlocks = (pHDD->m_diskblock * HD_BLOCK_SIZE) >= GetImageSize(pHDD);
 			bool breakpointHit = false;
 
 			if (bAppendBlocks)
@@ -769,10 +832,10 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD, const ULONG nExecute
 				memset(pHDD->m_buf, 0, HD_BLOCK_SIZE);
 
 				// Inefficient (especially for gzip/zip files!)
-				UINT uBlock = ImageGetImageSize(pHDD->m_imagehandle) / HD_BLOCK_SIZE;
+				UINT uBlock = GetImageSize(pHDD) / HD_BLOCK_SIZE;
 				while (uBlock < pHDD->m_diskblock)
 				{
-					bRes = ImageWriteBlock(pHDD->m_imagehandle, uBlock++, pHDD->m_buf);
+					bRes = WriteBlock(pHDD, uBlock++, pHDD->m_buf);
 					_ASSERT(bRes);
 					if (!bRes)
 						break;
@@ -816,7 +879,7 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD, const ULONG nExecute
 			}
 
 			if (bRes)
-				bRes = ImageWriteBlock(pHDD->m_imagehandle, pHDD->m_diskblock, pHDD->m_buf);
+				bRes = WriteBlock(pHDD, pHDD->m_diskblock, pHDD->m_buf);
 
 			if (bRes)
 			{
@@ -838,13 +901,13 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD, const ULONG nExecute
 	case BLK_Cmd_Format:
 	case SP_Cmd_format:
 		LOG_DISK("FORMAT: write-protected=%d\n", pHDD->m_bWriteProtected);
-		if (pHDD->m_bWriteProtected)
+		if (pHDD->m_bWriteProtected || pHDD->m_hostVolume)	// Don't allow a format to wipe a host directory
 		{
 			pHDD->m_error = NOWRITE;
 		}
 		else
 		{
-			const UINT numBlocks = GetImageSizeInBlocks(pHDD->m_imagehandle);
+			const UINT numBlocks = GetImageSizeInBlocks(pHDD);
 			memset(pHDD->m_buf, 0, HD_BLOCK_SIZE);
 			bool res = false;
 			m_notBusyCycle = g_nCumulativeCycles;
@@ -852,7 +915,7 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD, const ULONG nExecute
 			for (UINT block = 0; block < numBlocks; block++)
 			{
 				// Inefficient (especially for gzip/zip files!)
-				res = ImageWriteBlock(pHDD->m_imagehandle, block, pHDD->m_buf);
+				res = WriteBlock(pHDD, block, pHDD->m_buf);
 				_ASSERT(res);
 				if (!res)
 					break;
@@ -1113,7 +1176,7 @@ BYTE HarddiskInterfaceCard::SmartPortCmdStatus(HardDiskDrive* pHDD, const ULONG
 			if (pHDD->m_bWriteProtected) generalStatus |= (1 << 2);
 			status.push_back(generalStatus);
 
-			const UINT imageSizeInBlocks = isImageLoaded ? GetImageSizeInBlocks(pHDD->m_imagehandle) : 0;
+			const UINT imageSizeInBlocks = isImageLoaded ? GetImageSizeInBlocks(pHDD) : 0;
 			status.push_back(imageSizeInBlocks & 0xff);			// num blocks (lo)
 			status.push_back((imageSizeInBlocks >> 8) & 0xff);	// num blocks (med)
 			status.push_back((imageSizeInBlocks >> 16) & 0xff);	// num blocks (hi)
@@ -1177,11 +1240,38 @@ BYTE HarddiskInterfaceCard::SmartPortCmdStatus(HardDiskDrive* pHDD, const ULONG
 
 //===========================================================================
 
-UINT HarddiskInterfaceCard::GetImageSizeInBlocks(ImageInfo* const pImageInfo, const bool is16bit/*=false*/)
+UINT HarddiskInterfaceCard::GetImageSize(HardDiskDrive* pHDD)
+{
+	if (pHDD->m_hostVolume)
+		return pHDD->m_hostVolume->GetNumBlocks() * HD_BLOCK_SIZE;
+
+	return ImageGetImageSize(pHDD->m_imagehandle);
+}
+
+bool HarddiskInterfaceCard::ReadBlock(HardDiskDrive* pHDD, const UINT block, LPBYTE pBlockBuffer)
+{
+	if (pHDD->m_hostVolume)
+		return pHDD->m_hostVolume->ReadBlock(block, pBlockBuffer);
+
+	return ImageReadBlock(pHDD->m_imagehandle, block, pBlockBuffer);
+}
+
+bool HarddiskInterfaceCard::WriteBlock(HardDiskDrive* pHDD, const UINT block, LPBYTE pBlockBuffer)
+{
+	if (pHDD->m_hostVolume)
+	{
+		pHDD->m_hostVolumeWriteCycle = g_nCumulativeCycles;
+		return pHDD->m_hostVolume->WriteBlock(block, pBlockBuffer);
+	}
+
+	return ImageWriteBlock(pHDD->m_imagehandle, block, pBlockBuffer);
+}
+
+UINT HarddiskInterfaceCard::GetImageSizeInBlocks(HardDiskDrive* pHDD, const bool is16bit/*=false*/)
 {
 	if (m_userNumBlocks != 0)
 		return m_userNumBlocks;
-	UINT numberOfBlocks = (pImageInfo ? pImageInfo->uImageSize : 0) / HD_BLOCK_SIZE;
+	UINT numberOfBlocks = GetImageSize(pHDD) / HD_BLOCK_SIZE;
 	if (numberOfBlocks > kHarddiskMaxNumBlocks)
 		numberOfBlocks = kHarddiskMaxNumBlocks;
 	if (is16bit && numberOfBlocks > 0xffff)
@@ -1266,7 +1356,7 @@ void HarddiskInterfaceCard::SaveSnapshotHDDUnit(YamlSaveHelper& yamlSaveHelper,
 
 	YamlSaveHelper::Label label(yamlSaveHelper, "%s%d:\n", SS_YAML_KEY_HDDUNIT, baseUnitNum + unit);
 	yamlSaveHelper.SaveString(SS_YAML_KEY_FILENAME, m_hardDiskDrive[unit].m_fullname);
-	yamlSaveHelper.SaveString(SS_YAML_KEY_ABSOLUTE_PATH, ImageGetPathname(m_hardDiskDrive[unit].m_imagehandle));
+	yamlSaveHelper.SaveString(SS_YAML_KEY_ABSOLUTE_PATH, HarddiskGetFullPathName(unit));
 	yamlSaveHelper.SaveHexUint8(SS_YAML_KEY_ERROR, m_hardDiskDrive[unit].m_error);
 	yamlSaveHelper.SaveHexUint16(SS_YAML_KEY_MEMBLOCK, m_hardDiskDrive[unit].m_memblock);
 	yamlSaveHelper.SaveHexUint32(SS_YAML_KEY_DISKBLOCK, m_hardDiskDrive[unit].m_diskblock);
@@ -1284,6 +1374,13 @@ void HarddiskInterfaceCard::SaveSnapshotHDDUnit(YamlSaveHelper& yamlSaveHelper,
 
 void HarddiskInterfaceCard::SaveSnapshot(YamlSaveHelper& yamlSaveHelper)
 {
+	// A host directory's volume isn't saved (it's rescanned on load), so the guest's writes must be on the host
+	for (UINT i = 0; i < NUM_HARDDISKS; i++)
+	{
+		if (m_hardDiskDrive[i].m_hostVolume && !m_hardDiskDrive[i].m_hostVolume->Flush())
+			throw std::runtime_error("HDD: failed to write back to host directory: " + HarddiskGetFullPathName(i));
+	}
+
 	YamlSaveHelper::Slot slot(yamlSaveHelper, GetSnapshotCardName(), m_slot, kUNIT_VERSION);
 
 	YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
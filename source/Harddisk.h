@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "DiskImage.h"
 #include "DiskImageHelper.h"
 #include "MemoryDefs.h"	// APPLE_SLOT_SIZE
+#include "ProDOS_HostVolume.h"
 
 enum HardDrive_e
 {
@@ -61,6 +62,8 @@ public:
 		m_fullname.clear();
 		m_strFilenameInZip.clear();
 		m_imagehandle = NULL;
+		m_hostVolume = NULL;
+		m_hostVolumeWriteCycle = 0;
 		m_bWriteProtected = false;
 		//
 		m_error = 0;
@@ -78,6 +81,8 @@ public:
 	std::string m_fullname;	// <FILENAME.EXT> or <FILENAME.zip>
 	std::string m_strFilenameInZip;					// ""             or <FILENAME.EXT> [not used]
 	ImageInfo* m_imagehandle;			// Init'd by HD_Insert() -> ImageOpen()
+	ProDOS_HostVolume* m_hostVolume;	// Init'd by HD_Insert() if it's a host directory (then m_imagehandle is NULL)
+	UINT64 m_hostVolumeWriteCycle;		// Cycle of the guest's last write to m_hostVolume
 	bool m_bWriteProtected;			// Needed for ImageOpen() [otherwise not used]
 	//
 	BYTE m_error;		// NB. Firmware requires that b0=0 (OK) or b0=1 (Error)
@@ -98,7 +103,7 @@ public:
 	virtual ~HarddiskInterfaceCard(void);
 
 	virtual void Reset(const bool powerCycle);
-	virtual void Update(const ULONG nExecutedCycles) {}
+	virtual void Update(const ULONG nExecutedCycles);
 
 	virtual void InitializeIO(LPBYTE pCxRomPeripheral);
 	virtual void Destroy(void);
@@ -113,6 +118,7 @@ public:
 	void UseHdcFirmwareV1(void) { m_useHdcFirmwareV1 = true; }
 	void UseHdcFirmwareV2(void) { m_useHdcFirmwareV2 = true; }
 	void SetHdcFirmwareMode(HdcMode hdcMode) { m_useHdcFirmwareMode = hdcMode; }
+	void SetHostVolumeWriteBack(const bool writeBack);
 
 	void GetLightStatus(Disk_Status_e* pDisk1Status);
 	bool ImageSwap(void);
@@ -140,7 +146,10 @@ private:
 	BYTE CmdStatus(HardDiskDrive* pHDD);
 	void SetIdString(std::vector<BYTE>& status, const std::string& idStr);
 	BYTE SmartPortCmdStatus(HardDiskDrive* pHDD, const ULONG nExecutedCycles);
-	UINT GetImageSizeInBlocks(ImageInfo* const pImageInfo, const bool is16bit = false);
+	UINT GetImageSize(HardDiskDrive* pHDD);
+	bool ReadBlock(HardDiskDrive* pHDD, const UINT block, LPBYTE pBlockBuffer);
+	bool WriteBlock(HardDiskDrive* pHDD, const UINT block, LPBYTE pBlockBuffer);
+	UINT GetImageSizeInBlocks(HardDiskDrive* pHDD, const bool is16bit = false);
 	void SaveSnapshotHDDUnit(YamlSaveHelper& yamlSaveHelper, const UINT unit);
 	bool LoadSnapshotHDDUnit(YamlLoadHelper& yamlLoadHelper, const UINT unit, const UINT version);
 
@@ -156,6 +165,7 @@ private:
 	bool m_useHdcFirmwareV1;
 	bool m_useHdcFirmwareV2;
 	HdcMode m_useHdcFirmwareMode;
+	bool m_hostVolumeWriteBack;	// Write guest changes back to host directories (else they're write-protected)
 
 	bool m_saveDiskImage;	// Save the DiskImage name to Registry
 
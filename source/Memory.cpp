@@ -42,6 +42,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Log.h"
 #include "NTSC.h"
 #include "NoSlotClock.h"
+#include "PerfCounters.h"
 #include "Pravets.h"
 #include "Registry.h"
 #include "Speaker.h"
@@ -1458,6 +1459,7 @@ static void UpdatePaging(BOOL initialize)
 		// . Page1 (stack) : memdirty[1] is NOT set when the 6502 CPU writes to this page with JSR, PHA, etc.
 		// Ultimately this is an optimisation (due to Page1 writes not setting memdirty[1]) and Page0 could be optimised to also not set memdirty[0].
 
+		UINT numPagesCopied = 0;
 		for (UINT page = _6502_ZERO_PAGE; page < _6502_NUM_PAGES; page++)
 		{
 			if (initialize || (oldshadow[page] != memshadow[page]))
@@ -1467,11 +1469,15 @@ static void UpdatePaging(BOOL initialize)
 				{
 					*(memdirty+page) &= ~1;
 					memcpy(oldshadow[page],mem+(page << 8),_6502_PAGE_SIZE);
+					numPagesCopied++;
 				}
 
 				memcpy(mem+(page << 8),memshadow[page],_6502_PAGE_SIZE);
+				numPagesCopied++;
 			}
 		}
+
+		PerfCounters_Add(PERF_BANKSWITCH_COPIES, numPagesCopied);
 	}
 	else
 	{
@@ -2719,12 +2725,14 @@ void MemInsertNoSlotClock(void)
 	if (!MemHasNoSlotClock())
 		g_NoSlotClock = new CNoSlotClock;
 	g_NoSlotClock->Reset();
+	CpuUpdateCoreSelection();
 }
 
 void MemRemoveNoSlotClock(void)
 {
 	delete g_NoSlotClock;
 	g_NoSlotClock = NULL;
+	CpuUpdateCoreSelection();
 }
 
 //===========================================================================
@@ -2753,7 +2761,8 @@ static const UINT kUNIT_AUXSLOT_VER = 2;
 // 2: Added: RGB card state
 // 3: Extended: RGB card state ('80COL changed')
 // 4: Support aux empty or aux 1KiB card
-static const UINT kUNIT_CARD_VER = 4;
+// 5: Aux memory banks can be compressed blocks
+static const UINT kUNIT_CARD_VER = 5;
 
 #define SS_YAML_VALUE_CARD_EMPTY "Empty"
 #define SS_YAML_VALUE_CARD_80COL "80 Column"
@@ -2794,12 +2803,12 @@ static void MemSaveSnapshotMemory(YamlSaveHelper& yamlSaveHelper, bool bIsMainMe
 	if (bIsMainMem)
 	{
 		YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", MemGetSnapshotMainMemStructName().c_str());
-		yamlSaveHelper.SaveMemory(pMemBase, size);
+		yamlSaveHelper.SaveMemory(pMemBase, size, 0, true);	// Unit Apple2 v10
 	}
 	else
 	{
 		YamlSaveHelper::Label state(yamlSaveHelper, "%s%02X:\n", MemGetSnapshotAuxMemStructName().c_str(), bank-1);
-		yamlSaveHelper.SaveMemory(pMemBase, size);
+		yamlSaveHelper.SaveMemory(pMemBase, size, 0, true);	// Aux card v5
 	}
 }
 
@@ -2916,7 +2925,7 @@ bool MemLoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT unitVersion)
 
 	memset(memmain+0xC000, 0, LanguageCardSlot0::kMemBankSize);	// Clear it, as high 16K may not be in the save-state's "Main Memory" (eg. the case of II+ Saturn replacing //e LC)
 
-	yamlLoadHelper.LoadMemory(memmain, _6502_MEM_LEN);
+	yamlLoadHelper.LoadMemory(memmain, _6502_MEM_LEN, 0, unitVersion >= 10);
 	if (unitVersion == 1 && IsApple2PlusOrClone(GetApple2Type()))
 	{
 		// v1 for II/II+ doesn't have a dedicated slot-0 LC, instead the 16K is stored as the top 16K of memmain
@@ -2992,7 +3001,7 @@ void MemSaveSnapshotAux(YamlSaveHelper& yamlSaveHelper)
 	}
 }
 
-static SS_CARDTYPE MemLoadSnapshotAuxCommon(YamlLoadHelper& yamlLoadHelper, const std::string& card)
+static SS_CARDTYPE MemLoadSnapshotAuxCommon(YamlLoadHelper& yamlLoadHelper, const std::string& card, const UINT cardVersion)
 {
 	g_uMaxExBanks = 1;	// Must be at least 1 (for aux mem) - regardless of Apple2 type!
 	g_uActiveBank = 0;
@@ -3066,7 +3075,7 @@ static SS_CARDTYPE MemLoadSnapshotAuxCommon(YamlLoadHelper& yamlLoadHelper, cons
 			if (!yamlLoadHelper.GetSubMap(auxMemName))
 				throw std::runtime_error("Memory: Missing map name: " + auxMemName);
 
-			yamlLoadHelper.LoadMemory(pBank, _6502_MEM_LEN);
+			yamlLoadHelper.LoadMemory(pBank, _6502_MEM_LEN, 0, cardVersion >= 5);
 
 			yamlLoadHelper.PopMap();
 		}
@@ -3083,13 +3092,15 @@ static SS_CARDTYPE MemLoadSnapshotAuxCommon(YamlLoadHelper& yamlLoadHelper, cons
 static void MemLoadSnapshotAuxVer1(YamlLoadHelper& yamlLoadHelper)
 {
 	std::string card = yamlLoadHelper.LoadString(SS_YAML_KEY_CARD);
-	MemLoadSnapshotAuxCommon(yamlLoadHelper, card);
+	MemLoadSnapshotAuxCommon(yamlLoadHelper, card, 1);
 }
 
 static void MemLoadSnapshotAuxVer2(YamlLoadHelper& yamlLoadHelper)
 {
 	std::string card = yamlLoadHelper.LoadString(SS_YAML_KEY_CARD);
 	UINT cardVersion = yamlLoadHelper.LoadUint(SS_YAML_KEY_VERSION);
+	if (cardVersion > kUNIT_CARD_VER)
+		throw std::runtime_error(SS_YAML_KEY_UNIT ": AuxSlot: Card version mismatch");
 
 	if (card != SS_YAML_VALUE_CARD_EMPTY)
 	{
@@ -3097,7 +3108,7 @@ static void MemLoadSnapshotAuxVer2(YamlLoadHelper& yamlLoadHelper)
 			throw std::runtime_error(SS_YAML_KEY_UNIT ": Expected sub-map name: " SS_YAML_KEY_STATE);
 	}
 
-	SS_CARDTYPE cardType = MemLoadSnapshotAuxCommon(yamlLoadHelper, card);
+	SS_CARDTYPE cardType = MemLoadSnapshotAuxCommon(yamlLoadHelper, card, cardVersion);
 
 	if (card == SS_YAML_VALUE_CARD_EXTENDED80COL || card == SS_YAML_VALUE_CARD_RAMWORKSIII)
 		RGB_LoadSnapshot(yamlLoadHelper, cardVersion);
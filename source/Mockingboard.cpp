@@ -65,6 +65,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 MockingboardCard::MockingboardCard(UINT slot, SS_CARDTYPE type) : Card(type, slot), m_MBSubUnit{ {slot, type}, {slot, type} }
 {
 	m_lastCumulativeCycle = 0;
+	m_timerCyclesPending = 0;
 	m_lastAYUpdateCycle = 0;
 
 	for (UINT i = 0; i < NUM_VOICES; i++)
@@ -505,14 +506,7 @@ UINT MockingboardCard::MB_Update(void)
 
 	if (nNumSamples)
 	{
-		for (BYTE subunit = 0; subunit < NUM_SUBUNITS_PER_MB; subunit++)
-		{
-			for (BYTE ay = 0; ay < NUM_AY8913_PER_SUBUNIT; ay++)
-			{
-				const UINT chip = subunit * NUM_AY8913_PER_SUBUNIT + ay;
-				AY8910Update(subunit, ay, &m_ppAYVoiceBuffer[chip * NUM_VOICES_PER_AY8913], nNumSamples);
-			}
-		}
+		AY8910UpdateAll(nNumSamples);
 
 		// Echo+ right speaker is also output to left speaker
 		if (m_isPhasorCard && m_phasorMode == PH_EchoPlus)
@@ -564,6 +558,8 @@ void MockingboardCard::Destroy(void)
 
 void MockingboardCard::Reset(const bool powerCycle)	// CTRL+RESET or power-cycle
 {
+	SyncTimers();	// The 6522 TIMER1/2 counters aren't reset by CTRL+RESET, so apply the cycles they're owed first
+
 	SetPhasorMode(PH_Mockingboard);		// + re-init's AY CLK
 
 	for (BYTE subunit = 0; subunit < NUM_SUBUNITS_PER_MB; subunit++)
@@ -612,6 +608,7 @@ BYTE __stdcall MockingboardCard::IORead(WORD PC, WORD nAddr, BYTE bWrite, BYTE n
 BYTE MockingboardCard::IOReadInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles)
 {
 	GetCardMgr().GetMockingboardCardMgr().UpdateCycles(nExecutedCycles);
+	SyncTimers();
 
 #ifdef _DEBUG
 	if (!IS_APPLE2 && MemCheckINTCXROM())
@@ -679,6 +676,7 @@ BYTE __stdcall MockingboardCard::IOWrite(WORD PC, WORD nAddr, BYTE bWrite, BYTE
 BYTE MockingboardCard::IOWriteInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles)
 {
 	GetCardMgr().GetMockingboardCardMgr().UpdateCycles(nExecutedCycles);
+	SyncTimers();
 
 #ifdef _DEBUG
 	if (!IS_APPLE2 && MemCheckINTCXROM())
@@ -901,6 +899,7 @@ void MockingboardCard::CheckCumulativeCycles(void)
 // Called by: ResetState() and Snapshot_LoadState_v2()
 void MockingboardCard::SetCumulativeCycles(void)
 {
+	SyncTimers();	// Don't lose any pending cycles (NB. leaves m_timerCyclesPending == 0)
 	m_lastCumulativeCycle = g_nCumulativeCycles;
 }
 
@@ -926,13 +925,31 @@ void MockingboardCard::UpdateCycles(ULONG executedCycles)
 		return;
 
 	m_lastCumulativeCycle = g_nCumulativeCycles;
-	_ASSERT(uCycles < 0x10000 || g_nAppMode == MODE_BENCHMARK);
-	USHORT nClocks = (USHORT)uCycles;
 
-	for (UINT i = 0; i < NUM_SUBUNITS_PER_MB; i++)
+	// The 6522 timers are only brought up-to-date when they can be observed (see SyncTimers()),
+	// so an idle card just accumulates cycles here
+	m_timerCyclesPending += uCycles;
+}
+
+// Apply any pending cycles to the 6522 TIMER1/2 counters
+// Called by:
+// . IORead() / IOWrite() for this card
+// . MB_SyncEventCallback() on a TIMER1/2 underflow for this card
+// . SaveSnapshot() and GetSnapshotForDebugger()
+// . Reset(), SetCumulativeCycles() and LoadSnapshot(), before the pending count is rebased
+void MockingboardCard::SyncTimers(void)
+{
+	while (m_timerCyclesPending)
 	{
-		m_MBSubUnit[i].sy6522.UpdateTimer1(nClocks);
-		m_MBSubUnit[i].sy6522.UpdateTimer2(nClocks);
+		// NB. An active TIMER1/2 underflow will have already triggered a SyncEvent (so a sync), so >0xFFFF cycles only occurs for inactive timers
+		const USHORT nClocks = (USHORT) std::min(m_timerCyclesPending, (UINT64)0xFFFF);
+		m_timerCyclesPending -= nClocks;
+
+		for (UINT i = 0; i < NUM_SUBUNITS_PER_MB; i++)
+		{
+			m_MBSubUnit[i].sy6522.UpdateTimer1(nClocks);
+			m_MBSubUnit[i].sy6522.UpdateTimer2(nClocks);
+		}
 	}
 }
 
@@ -951,6 +968,7 @@ int MockingboardCard::MB_SyncEventCallbackInternal(int id, int /*cycles*/, ULONG
 	//UpdateCycles(uExecutedCycles);	// Underflow: so keep TIMER1/2 counters in sync
 	// Update all MBs, so that m_lastCumulativeCycle remains in sync for all
 	GetCardMgr().GetMockingboardCardMgr().UpdateCycles(uExecutedCycles);	// Underflow: so keep TIMER1/2 counters in sync
+	SyncTimers();
 
 	MB_SUBUNIT* pMB = &m_MBSubUnit[(id & 0xf) / SY6522::kNumTimersPer6522];
 
@@ -1009,6 +1027,8 @@ void MockingboardCard::SetVolume(uint32_t volume, uint32_t volumeMax)
 
 void MockingboardCard::GetSnapshotForDebugger(DEBUGGER_MB_CARD* const pMBForDebugger)
 {
+	SyncTimers();
+
 	pMBForDebugger->type = QueryType();
 
 	for (UINT i = 0; i < NUM_SUBUNITS_PER_MB; i++)
@@ -1071,14 +1091,26 @@ void MockingboardCard::AY8910UpdateSetCycles()
 	m_lastAYUpdateCycle = g_nCumulativeCycles;
 }
 
-void MockingboardCard::AY8910Update(BYTE subunit, BYTE ay, INT16** buffer, int nNumSamples)
+// Synthesise all the AY's together, so that their channels are generated in parallel lanes
+void MockingboardCard::AY8910UpdateAll(int nNumSamples)
 {
-	_ASSERT(subunit < NUM_SUBUNITS_PER_MB && ay < NUM_AY8913_PER_SUBUNIT);
+	static_assert(NUM_AY8913 <= AY8913::FRAME_MULTI_MAX, "Too many AY's for sound_frame_multi()");
 	AY8910UpdateSetCycles();
 
-	m_MBSubUnit[subunit].ay8913[ay].SetFramesize(nNumSamples);
-	m_MBSubUnit[subunit].ay8913[ay].SetSoundBuffers(buffer);
-	m_MBSubUnit[subunit].ay8913[ay].sound_frame();
+	AY8913* chips[NUM_AY8913];
+
+	for (UINT subunit = 0; subunit < NUM_SUBUNITS_PER_MB; subunit++)
+	{
+		for (UINT ay = 0; ay < NUM_AY8913_PER_SUBUNIT; ay++)
+		{
+			const UINT chip = subunit * NUM_AY8913_PER_SUBUNIT + ay;
+			chips[chip] = &m_MBSubUnit[subunit].ay8913[ay];
+			chips[chip]->SetFramesize(nNumSamples);
+			chips[chip]->SetSoundBuffers(&m_ppAYVoiceBuffer[chip * NUM_VOICES_PER_AY8913]);
+		}
+	}
+
+	AY8913::sound_frame_multi(chips, NUM_AY8913);
 }
 
 void MockingboardCard::AY8910_InitAll(int nClock, int nSampleRate)
@@ -1202,6 +1234,8 @@ std::string MockingboardCard::GetSnapshotCardNameSDMusic(void)
 
 void MockingboardCard::SaveSnapshot(YamlSaveHelper& yamlSaveHelper)
 {
+	SyncTimers();
+
 	if (QueryType() == CT_Phasor)
 		return Phasor_SaveSnapshot(yamlSaveHelper);
 
@@ -1243,6 +1277,8 @@ bool MockingboardCard::LoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT version
 	if (version < 1 || version > kUNIT_VERSION)
 		throw std::runtime_error("Card: wrong version");
 
+	SyncTimers();	// Apply any pending cycles to the old 6522 state, before it's replaced
+
 	if (QueryType() == CT_Phasor)
 		return Phasor_LoadSnapshot(yamlLoadHelper, version);
 
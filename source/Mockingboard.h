@@ -31,6 +31,7 @@ public:
 	void ReinitializeClock(void);
 	void MuteControl(bool mute);
 	void UpdateCycles(ULONG executedCycles);
+	void SyncTimers(void);
 	bool IsActiveToPreventFullSpeed(void);
 	void SetVolume(uint32_t dwVolume, uint32_t dwVolumeMax);
 	void SetCumulativeCycles(void);
@@ -135,7 +136,7 @@ private:
 	BYTE AYReadReg(BYTE subunit, BYTE ay, int r);
 	void _AYWriteReg(BYTE subunit, BYTE ay, int r, int v);
 	void AY8910_reset(BYTE subunit, BYTE ay);
-	void AY8910Update(BYTE subunit, BYTE ay, INT16** buffer, int nNumSamples);
+	void AY8910UpdateAll(int nNumSamples);
 
 	void AY8910_InitAll(int nClock, int nSampleRate);
 	void AY8910_InitClock(int nClock);
@@ -168,6 +169,7 @@ private:
 	SyncEvent* m_syncEvent[kNumSyncEvents];
 
 	UINT64 m_lastCumulativeCycle;
+	UINT64 m_timerCyclesPending;	// 6522 TIMER1/2 cycles not yet applied (see SyncTimers())
 
 	short* m_ppAYVoiceBuffer[NUM_VOICES];
 
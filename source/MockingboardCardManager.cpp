@@ -34,6 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "CardManager.h"
 #include "CPU.h"
 #include "MockingboardDefs.h"
+#include "PerfCounters.h"
 #include "Riff.h"
 
 //#define DBG_MB_UPDATE
@@ -254,6 +255,7 @@ void MockingboardCardManager::UpdateSoundBuffer(void)
 	extern UINT64 g_timeMB_Timer;
 	PerfMarker perfMarker(!IsAnyTimer1Active() ? g_timeMB_NoTimer : g_timeMB_Timer);
 #endif
+	PERF_SCOPE(PERF_MOCKINGBOARD_NS);
 
 	if (!m_mockingboardVoice.lpDSBvoice)
 	{
@@ -387,54 +389,47 @@ UINT MockingboardCardManager::GenerateAllSoundData(void)
 	return nNumSamples;
 }
 
+void MockingboardCardManager::MixVoice(int* pAccum, const short* pVoice, const UINT nNumSamples, const double fAttenuation)
+{
+	for (UINT i = 0; i < nNumSamples; i++)
+		pAccum[i] += (int)((double)pVoice[i] * fAttenuation);
+}
+
 void MockingboardCardManager::MixAllAndCopyToRingBuffer(UINT nNumSamples)
 {
 //	const double fAttenuation = g_bPhasorEnable ? 2.0 / 3.0 : 1.0;
 	const double fAttenuation = true ? 2.0 / 3.0 : 1.0;
 
-	short** slotAYVoiceBuffers[NUM_SLOTS] = {0};
+	// Mockingboard stereo (all voices on an AY8910 wire-or'ed together)
+	// L = Address.b7=0, R = Address.b7=1
+	// . Regular MB-C AY's: chip 0 (L) & chip 2 (R)
+	// . Extra Phasor AY's: chip 1 (L) & chip 3 (R)
+	// Each voice is mixed in its own pass over a contiguous buffer, so that the compiler can vectorise the inner loop.
+	// NB. Integer addition is associative, so the result is identical to mixing sample-by-sample.
+	memset(m_mixAccumL, 0, nNumSamples * sizeof(int));
+	memset(m_mixAccumR, 0, nNumSamples * sizeof(int));
 
 	for (UINT slot = SLOT0; slot < NUM_SLOTS; slot++)
 	{
-		if (IsMockingboard(slot))
-			slotAYVoiceBuffers[slot] = dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(slot)).GetVoiceBuffers();
-	}
+		if (!IsMockingboard(slot))
+			continue;
 
-	for (UINT i = 0; i < nNumSamples; i++)
-	{
-		// Mockingboard stereo (all voices on an AY8910 wire-or'ed together)
-		// L = Address.b7=0, R = Address.b7=1
-		int nDataL = 0, nDataR = 0;
+		short** ppAYVoiceBuffer = dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(slot)).GetVoiceBuffers();
 
-		for (UINT slot = SLOT0; slot < NUM_SLOTS; slot++)
+		for (UINT chip = 0; chip < NUM_AY8913; chip++)
 		{
-			if (!slotAYVoiceBuffers[slot])
-				continue;
+			int* const pAccum = (chip < NUM_AY8913 / 2) ? m_mixAccumL : m_mixAccumR;
 
 			for (UINT j = 0; j < NUM_VOICES_PER_AY8913; j++)
-			{
-				short** ppAYVoiceBuffer = slotAYVoiceBuffers[slot];
-
-				// Regular MB-C AY's
-				nDataL += (int)((double)ppAYVoiceBuffer[0 * NUM_VOICES_PER_AY8913 + j][i] * fAttenuation);
-				nDataR += (int)((double)ppAYVoiceBuffer[2 * NUM_VOICES_PER_AY8913 + j][i] * fAttenuation);
-
-				// Extra Phasor AY's
-				nDataL += (int)((double)ppAYVoiceBuffer[1 * NUM_VOICES_PER_AY8913 + j][i] * fAttenuation);
-				nDataR += (int)((double)ppAYVoiceBuffer[3 * NUM_VOICES_PER_AY8913 + j][i] * fAttenuation);
-			}
+				MixVoice(pAccum, ppAYVoiceBuffer[chip * NUM_VOICES_PER_AY8913 + j], nNumSamples, fAttenuation);
 		}
+	}
 
+	for (UINT i = 0; i < nNumSamples; i++)
+	{
 		// Cap the superpositioned output
-		if (nDataL < WAVE_DATA_MIN)
-			nDataL = WAVE_DATA_MIN;
-		else if (nDataL > WAVE_DATA_MAX)
-			nDataL = WAVE_DATA_MAX;
-
-		if (nDataR < WAVE_DATA_MIN)
-			nDataR = WAVE_DATA_MIN;
-		else if (nDataR > WAVE_DATA_MAX)
-			nDataR = WAVE_DATA_MAX;
+		const int nDataL = std::min(std::max(m_mixAccumL[i], (int)WAVE_DATA_MIN), (int)WAVE_DATA_MAX);
+		const int nDataR = std::min(std::max(m_mixAccumR[i], (int)WAVE_DATA_MIN), (int)WAVE_DATA_MAX);
 
 		m_mixBuffer[i * MockingboardCard::NUM_MB_CHANNELS + 0] = (short)nDataL;	// L
 		m_mixBuffer[i * MockingboardCard::NUM_MB_CHANNELS + 1] = (short)nDataR;	// R
@@ -53,6 +53,7 @@ private:
 	bool Init(void);
 	UINT GenerateAllSoundData(void);
 	void MixAllAndCopyToRingBuffer(UINT nNumSamples);
+	static void MixVoice(int* pAccum, const short* pVoice, const UINT nNumSamples, const double fAttenuation);
 	bool IsMockingboardExtraCardType(UINT slot);
 
 	static const uint32_t SOUNDBUFFER_SIZE = MAX_SAMPLES * sizeof(short) * MockingboardCard::NUM_MB_CHANNELS;
@@ -61,6 +62,8 @@ private:
 	static const SHORT WAVE_DATA_MAX = (SHORT)0x7FFF;
 
 	short m_mixBuffer[SOUNDBUFFER_SIZE / sizeof(short)];
+	int m_mixAccumL[MAX_SAMPLES];	// Per-channel accumulators used by MixAllAndCopyToRingBuffer()
+	int m_mixAccumR[MAX_SAMPLES];
 	VOICE m_mockingboardVoice;
 
 	//
@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	#include "Interface.h"  // GetFrameBuffer()
 	#include "RGBMonitor.h"
 	#include "VidHD.h"
+	#include "PerfCounters.h"
 
 	#include "NTSC_CharSet.h"
 
@@ -143,6 +144,16 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static bgra_t   g_aBnwColorTV                 [NTSC_NUM_SEQUENCES];
 	static bgra_t   g_aHueColorTV[NTSC_NUM_PHASES][NTSC_NUM_SEQUENCES];
 
+	// The above tables only depend on constants, so are only generated once - this keeps a copy, since the debugger can load a palette over them
+	static struct
+	{
+		bgra_t aBnWMonitor                 [NTSC_NUM_SEQUENCES];
+		bgra_t aHueMonitor[NTSC_NUM_PHASES][NTSC_NUM_SEQUENCES];
+		bgra_t aBnwColorTV                 [NTSC_NUM_SEQUENCES];
+		bgra_t aHueColorTV[NTSC_NUM_PHASES][NTSC_NUM_SEQUENCES];
+	} g_generatedChromaTables;
+	static bool g_bChromaTablesGenerated = false;
+
 	// g_aBnWMonitor * g_nMonochromeRGB -> g_aBnWMonitorCustom
 	// g_aBnwColorTV * g_nMonochromeRGB -> g_aBnWColorTVCustom
 	static bgra_t g_aBnWMonitorCustom           [NTSC_NUM_SEQUENCES];
@@ -175,6 +186,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static unsigned short g_aClockVertOffsetsTXT[VIDEO_SCANNER_MAX_VERT_PAL/8];
 	static unsigned short APPLE_IIP_HORZ_CLOCK_OFFSET[5][VIDEO_SCANNER_MAX_HORZ];	// 5 = CEILING(312/64) = CEILING(262/64)
 	static unsigned short APPLE_IIE_HORZ_CLOCK_OFFSET[5][VIDEO_SCANNER_MAX_HORZ];
+	static int g_videoTablesRefreshRate = -1;	// VideoRefreshRate_e that the above tables were generated for
 
 #ifdef _DEBUG
 	static unsigned short g_kClockVertOffsetsHGR[ VIDEO_SCANNER_MAX_VERT ] =
@@ -918,6 +930,15 @@ INLINE uint16_t getVideoScannerAddressSHR()
 //===========================================================================
 static void initChromaPhaseTables (void)
 {
+	if (g_bChromaTablesGenerated)
+	{
+		memcpy(g_aBnWMonitor, g_generatedChromaTables.aBnWMonitor, sizeof(g_aBnWMonitor));
+		memcpy(g_aHueMonitor, g_generatedChromaTables.aHueMonitor, sizeof(g_aHueMonitor));
+		memcpy(g_aBnwColorTV, g_generatedChromaTables.aBnwColorTV, sizeof(g_aBnwColorTV));
+		memcpy(g_aHueColorTV, g_generatedChromaTables.aHueColorTV, sizeof(g_aHueColorTV));
+		return;
+	}
+
 	int phase,s,t,n;
 	real z,y0,y1,c,i,q;
 	real phi,zz;
@@ -925,9 +946,16 @@ static void initChromaPhaseTables (void)
 	double r64,g64,b64;
 	float  r32,g32,b32;	
 
+	// Rotate (cos(phi),sin(phi)) by 45 degrees each sample, rather than calling cos() & sin() (same tables, but less than half the time)
+	const real cosStep = cos(RAD_45);
+	const real sinStep = sin(RAD_45);
+
 	for (phase = 0; phase < 4; ++phase)
 	{
 		phi = (phase * RAD_90) + CYCLESTART;
+		real cosPhi = cos(phi);
+		real sinPhi = sin(phi);
+
 		for (s = 0; s < NTSC_NUM_SEQUENCES; ++s)
 		{
 			t = s;
@@ -947,10 +975,12 @@ static void initChromaPhaseTables (void)
 					y1 = initFilterLuma1 (zz - c);
 
 					c = c * 2.f;
-					i = i + (c * cos(phi) - i) / 8.f;
-					q = q + (c * sin(phi) - q) / 8.f;
+					i = i + (c * cosPhi - i) / 8.f;
+					q = q + (c * sinPhi - q) / 8.f;
 
-					phi += RAD_45;
+					const real cosNext = cosPhi * cosStep - sinPhi * sinStep;	// phi += RAD_45
+					sinPhi = sinPhi * cosStep + cosPhi * sinStep;
+					cosPhi = cosNext;
 				} // k
 			} // samples
 
@@ -1077,6 +1107,11 @@ static void initChromaPhaseTables (void)
 	*p++ = 0xFF;
 #endif
 
+	memcpy(g_generatedChromaTables.aBnWMonitor, g_aBnWMonitor, sizeof(g_aBnWMonitor));
+	memcpy(g_generatedChromaTables.aHueMonitor, g_aHueMonitor, sizeof(g_aHueMonitor));
+	memcpy(g_generatedChromaTables.aBnwColorTV, g_aBnwColorTV, sizeof(g_aBnwColorTV));
+	memcpy(g_generatedChromaTables.aHueColorTV, g_aHueColorTV, sizeof(g_aHueColorTV));
+	g_bChromaTablesGenerated = true;
 }
 
 /*
@@ -1164,6 +1199,11 @@ static real initFilterSignal (real z)
 //===========================================================================
 static void initPixelDoubleMasks (void)
 {
+	static bool bDone = false;	// only depends on constants
+	if (bDone)
+		return;
+	bDone = true;
+
 	/*
 		Convert 7-bit monochrome luminance to 14-bit double pixel luminance
 		Chroma will be applied later based on the color phase in updatePixelHueMonitorDoubleScanline( luminanceBit )
@@ -1876,17 +1916,8 @@ void updateScreenSHR(long cycles6502)
 				uint32_t* pAux = (uint32_t*) MemGetAuxPtr(addr);	// 8 pixels (320 mode) / 16 pixels (640 mode)
 				uint32_t a = pAux[0];
 
-				uint8_t* pControl = MemGetAuxPtr(0x9D00 + g_nVideoClockVert);	// scan-line control byte
-				uint8_t c = pControl[0];
-
-				bool is640Mode = !!(c & 0x80);
-				bool isColorFillMode = !!(c & 0x20);
-				UINT paletteSelectCode = c & 0xf;
-				const UINT kColorsPerPalette = 16;
-				const UINT kColorSize = 2;
-				uint16_t addrPalette = 0x9E00 + paletteSelectCode * kColorsPerPalette * kColorSize;
-
-				VidHDCard::UpdateSHRCell(is640Mode, isColorFillMode, addrPalette, g_pVideoAddress, a);
+				// NB. the line's scan-line control byte & palette are read (and cached) by VidHD
+				VidHDCard::UpdateSHRCell(g_pVideoAddress, a, g_nVideoClockVert, g_nVideoClockHorz - VIDEO_SCANNER_HORZ_START);
 				g_pVideoAddress += 16;
 			}
 		}
@@ -1999,6 +2030,9 @@ void NTSC_SetVideoMode( uint32_t uVideoModeFlags, bool bDelay/*=false*/ )
 
 	if (uVideoModeFlags & VF_SHR)
 	{
+		if (g_pFuncUpdateGraphicsScreen != updateScreenSHR)
+			VidHDCard::InvalidateSHRCache();	// framebuffer was drawn by another video mode
+
 		g_pFuncUpdateGraphicsScreen = updateScreenSHR;
 		g_pFuncUpdateTextScreen = updateScreenSHR;
 		return;
@@ -2341,7 +2375,8 @@ void NTSC_Destroy(void)
 void NTSC_VideoInit( uint8_t* pFramebuffer ) // wsVideoInit
 {
 	make_csbits();
-	GenerateVideoTables();
+	if (g_videoTablesRefreshRate != GetVideo().GetVideoRefreshRate())	// else already generated (eg. by NTSC_SetRefreshRate() or a previous NTSC_VideoInit())
+		GenerateVideoTables();
 	initPixelDoubleMasks();
 	initChromaPhaseTables();
 	updateMonochromeTables( 0xFF, 0xFF, 0xFF );
@@ -2357,6 +2392,7 @@ void NTSC_VideoInit( uint8_t* pFramebuffer ) // wsVideoInit
 	}
 
 	g_pVideoAddress = g_pScanLines[0];
+	VidHDCard::InvalidateSHRCache();
 
 	g_pFuncUpdateTextScreen     = updateScreenText40;
 	g_pFuncUpdateGraphicsScreen = updateScreenText40;
@@ -2517,6 +2553,7 @@ void NTSC_VideoUpdateCycles( UINT cycles6502 )
 	extern UINT64 g_timeVideo;
 	PerfMarker perfMarker(g_timeVideo);
 #endif
+	PERF_SCOPE(PERF_NTSC_NS);
 
 	_ASSERT(cycles6502 && cycles6502 < g_videoScanner6502Cycles);	// Use NTSC_VideoRedrawWholeScreen() instead
 
@@ -2550,6 +2587,8 @@ void NTSC_VideoRedrawWholeScreen( void )
 	g_nVideoClockHorz = 0;
 	updateVideoScannerAddress();
 
+	VidHDCard::InvalidateSHRCache();	// redraw every SHR cell too
+
 	VideoUpdateCycles(g_videoScanner6502Cycles);
 
 	VideoUpdateCycles(horz);	// Finally update to get to correct H-pos
@@ -2692,6 +2731,8 @@ static void GenerateVideoTables( void )
 	GetVideo().SetVideoMode(currentVideoMode);
 	g_nHiresPage = currentHiresPage;
 	g_nTextPage = currentTextPage;
+
+	g_videoTablesRefreshRate = GetVideo().GetVideoRefreshRate();
 }
 
 static void GenerateBaseColors(baseColors_t pBaseNtscColors)
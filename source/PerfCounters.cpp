@@ -0,0 +1,113 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2024, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Performance counters
+ *
+ * Unlike LOG_PERF_TIMINGS these are always compiled in, so they can be scraped
+ * from any running instance (see debugserver/MetricsInfoProvider).
+ * The hot path timings are only compiled in with PERF_COUNTER_TIMINGS (see PerfCounters.h).
+ *
+ */
+
+#include "StdAfx.h"
+
+#include "PerfCounters.h"
+
+std::atomic<UINT64> g_perfCounters[PERF_NUM_COUNTERS];
+
+static std::atomic<UINT64> g_perfLastSecond[PERF_NUM_COUNTERS];
+
+// Only accessed by PerfCounters_Tick() (emulation thread)
+static UINT64 g_perfWindowTotals[PERF_NUM_COUNTERS];
+static UINT64 g_perfWindowStart = 0;
+
+static const UINT64 g_perfStart = PerfCounters_Now();
+
+static const UINT64 kNanosecondsPerSecond = 1000000000;
+
+// Audio underruns & frame pacing are only counted by the Linux frontends (linuxsoundbuffer.cpp, common2/speed.cpp)
+#ifdef _WIN32
+static const bool kFrontendCounters = false;
+#else
+static const bool kFrontendCounters = true;
+#endif
+
+static const PerfCounterInfo g_perfCounterInfo[PERF_NUM_COUNTERS] =
+{
+	{ "cycles",					"Emulated CPU cycles",									false,	true },
+	{ "cpu_seconds",			"Host time in the CPU core (inclusive)",				true,	true },
+	{ "ntsc_seconds",			"Host time in NTSC video generation",					true,	true },
+	{ "speaker_seconds",		"Host time in speaker audio synthesis",					true,	true },
+	{ "mockingboard_seconds",	"Host time in Mockingboard audio synthesis",			true,	true },
+	{ "disk_seconds",			"Host time in Disk II I/O handlers",					true,	true },
+	{ "card_update_seconds",	"Host time in periodic card I/O updates",				true,	true },
+	{ "audio_underruns",		"Audio buffer underruns",								false,	kFrontendCounters },
+	{ "frames",					"Frames paced by the frontend",							false,	kFrontendCounters },
+	{ "frame_jitter_seconds",	"Sum of frame pacing errors (actual vs requested)",		true,	kFrontendCounters },
+	{ "bankswitch_copies",		"Memory pages copied on bank switches",					false,	true },
+};
+
+const PerfCounterInfo& PerfCounters_GetInfo(const PerfCounter_e counter)
+{
+	_ASSERT(counter < PERF_NUM_COUNTERS);
+	return g_perfCounterInfo[counter];
+}
+
+UINT64 PerfCounters_GetTotal(const PerfCounter_e counter)
+{
+	return g_perfCounters[counter].load(std::memory_order_relaxed);
+}
+
+UINT64 PerfCounters_GetLastSecond(const PerfCounter_e counter)
+{
+	return g_perfLastSecond[counter].load(std::memory_order_relaxed);
+}
+
+UINT64 PerfCounters_GetUptime(void)
+{
+	return PerfCounters_Now() - g_perfStart;
+}
+
+void PerfCounters_Tick(const UINT64 now)
+{
+	if (g_perfWindowStart == 0)
+	{
+		g_perfWindowStart = now;
+		return;
+	}
+
+	const UINT64 elapsed = now - g_perfWindowStart;
+	if (elapsed < kNanosecondsPerSecond)
+		return;
+
+	// Normalise to exactly 1 second, as the window can overrun (eg. after a pause)
+	for (UINT i = 0; i < PERF_NUM_COUNTERS; i++)
+	{
+		const UINT64 total = g_perfCounters[i].load(std::memory_order_relaxed);
+		const UINT64 delta = total - g_perfWindowTotals[i];
+		g_perfWindowTotals[i] = total;
+		g_perfLastSecond[i].store((UINT64)((double)delta * kNanosecondsPerSecond / elapsed), std::memory_order_relaxed);
+	}
+
+	g_perfWindowStart = now;
+}
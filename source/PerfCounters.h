@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+// Low overhead performance counters.
+// . Totals are only ever added to (relaxed atomics), from the emulation thread and the audio callback.
+// . Once a second (of host time) PerfCounters_Tick() snapshots the totals into per-second rates.
+// . Timings are inclusive, eg. NTSC, Mockingboard & Disk II time is also part of CPU time.
+// . CPU time & cycles are counted per CpuExecute() batch, so are always on.
+// . The other timings (PERF_SCOPE) are in hot paths, so are only compiled in with PERF_COUNTER_TIMINGS,
+//   and even then only 1 in kPerfScopeSampleInterval calls is timed (and scaled up).
+
+//#define PERF_COUNTER_TIMINGS	// or cmake -DPERF_COUNTER_TIMINGS=ON
+
+enum PerfCounter_e
+{
+	PERF_CYCLES,				// emulated CPU cycles
+	PERF_CPU_NS,				// CpuExecute()
+	PERF_NTSC_NS,				// NTSC video generation
+	PERF_SPEAKER_NS,			// SpkrUpdate()
+	PERF_MOCKINGBOARD_NS,		// Mockingboard sound buffer synthesis
+	PERF_DISK_NS,				// Disk II $C0nX soft-switch handlers
+	PERF_CARD_UPDATE_NS,		// CardManager::Update() (periodic card I/O)
+	PERF_AUDIO_UNDERRUNS,
+	PERF_FRAMES,				// frames paced by the frontend
+	PERF_FRAME_JITTER_NS,		// sum of |actual - requested| frame intervals
+	PERF_BANKSWITCH_COPIES,		// pages copied by MemUpdatePaging()
+	PERF_NUM_COUNTERS
+};
+
+struct PerfCounterInfo
+{
+	const char* name;			// Prometheus style, eg. "cpu_seconds"
+	const char* help;
+	bool isTime;				// counted in ns, exported in seconds
+	bool isAvailable;			// false if this build never counts it, so it isn't exported
+};
+
+extern std::atomic<UINT64> g_perfCounters[PERF_NUM_COUNTERS];
+
+inline UINT64 PerfCounters_Now(void)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline void PerfCounters_Add(const PerfCounter_e counter, const UINT64 value)
+{
+	g_perfCounters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+const PerfCounterInfo& PerfCounters_GetInfo(const PerfCounter_e counter);
+UINT64 PerfCounters_GetTotal(const PerfCounter_e counter);
+UINT64 PerfCounters_GetLastSecond(const PerfCounter_e counter);	// 0 until the 1st second has elapsed
+UINT64 PerfCounters_GetUptime(void);							// ns since the counters were started
+
+// Called by CpuExecute() with the host time it has already read
+void PerfCounters_Tick(const UINT64 now);
+
+#ifdef PERF_COUNTER_TIMINGS
+const UINT kPerfScopeSampleInterval = 64;
+
+class PerfScope
+{
+public:
+	PerfScope(const PerfCounter_e counter, UINT& calls)
+		: m_counter(counter)
+		, m_start((++calls % kPerfScopeSampleInterval) == 0 ? PerfCounters_Now() : 0)
+	{
+	}
+	~PerfScope()
+	{
+		if (m_start)
+			PerfCounters_Add(m_counter, (PerfCounters_Now() - m_start) * kPerfScopeSampleInterval);
+	}
+
+private:
+	const PerfCounter_e m_counter;
+	const UINT64 m_start;
+};
+
+// NB. one per function (the call count is per call site)
+#define PERF_SCOPE(counter) static UINT s_perfScopeCalls = 0; PerfScope perfScope(counter, s_perfScopeCalls)
+#else
+#define PERF_SCOPE(counter)
+#endif
@@ -0,0 +1,993 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2024, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: ProDOS volume synthesised from a host directory
+ *
+ * Layout:
+ *  0-1   Boot blocks (ProDOS 2.4.3 boot loader)
+ *  2-5   Volume directory
+ *  6-21  Volume bitmap
+ *  22-   For each directory (depth first): its directory blocks, then for each file: its index block(s) & data blocks
+ *
+ * Blocks after the last file are free for the guest to allocate.
+ */
+
+#include "StdAfx.h"
+
+#include "ProDOS_HostVolume.h"
+#include "Common.h"
+#include "Log.h"
+#include "ProDOS_FileSystem.h"
+
+#include <sys/stat.h>
+
+#if __cplusplus >= 201703L // Compiler option: /std:c++17
+#include <filesystem>
+#define HOST_VOLUME_SUPPORTED 1
+#endif
+
+namespace
+{
+	const UINT kEntryLen = 0x27;
+	const UINT kEntriesPerBlock = (UINT)(PRODOS_BLOCK_SIZE / kEntryLen);	// 13
+	const UINT kRootDirBlocks = 4;
+	const UINT kMaxRootEntries = kRootDirBlocks * kEntriesPerBlock - 1;	// excluding the volume header
+	const UINT kMaxEOF = 0xFFFFFF;
+	const UINT kMaxDirDepth = 32;	// ProDOS pathnames are limited to 64 chars
+
+	const BYTE kTypeDIR = 0x0F;
+	const BYTE kTypeBIN = 0x06;
+	const BYTE kTypeSYS = 0xFF;
+
+	const BYTE kAccessAll = ACCESS_D | ACCESS_N | ACCESS_B | ACCESS_W | ACCESS_R;
+	const BYTE kAccessLocked = ACCESS_B | ACCESS_R;
+
+	const char kTempSuffix[] = ".awtmp";	// host file being written by WriteHostFile()
+
+	bool IsTempName(const std::string& hostName)
+	{
+		const size_t len = sizeof(kTempSuffix) - 1;
+		return hostName.length() > len && hostName.compare(hostName.length() - len, len, kTempSuffix) == 0;
+	}
+
+	// Returns "" if the host name can't be mapped to a ProDOS name
+	std::string MakeProDOSName(const std::string& hostName)
+	{
+		if (hostName.empty() || hostName.length() > PRODOS_MAX_FILENAME)
+			return "";
+
+		std::string name;
+		for (char c : hostName)
+		{
+			if (c >= 'a' && c <= 'z')
+				c -= 'a' - 'A';
+			if (!(c >= 'A' && c <= 'Z') && !(c >= '0' && c <= '9'))
+				c = '.';
+			name += c;
+		}
+
+		if (!(name[0] >= 'A' && name[0] <= 'Z'))
+			return "";
+
+		return name;
+	}
+
+	// "NAME#ttaaaa" => NAME, type=$tt, aux=$aaaa
+	bool ParseTypeSuffix(std::string& name, BYTE& type, WORD& aux)
+	{
+		const size_t hash = name.rfind('#');
+		if (hash == std::string::npos || name.length() - hash != 7)
+			return false;
+
+		for (size_t i = hash + 1; i < name.length(); i++)
+		{
+			if (!isxdigit((unsigned char)name[i]))
+				return false;
+		}
+
+		const UINT value = strtoul(name.c_str() + hash + 1, NULL, 16);
+		type = (BYTE)(value >> 16);
+		aux = (WORD)value;
+		name.resize(hash);
+		return true;
+	}
+
+	void GetHostDateTime(const std::string& pathname, WORD& date, WORD& time)
+	{
+		date = time = 0;
+
+		struct stat st;
+		if (stat(pathname.c_str(), &st) != 0)
+			return;
+
+		const time_t mtime = st.st_mtime;
+		const struct tm* pTm = localtime(&mtime);
+		if (!pTm)
+			return;
+
+		date = ProDOS_PackDate(pTm->tm_year % 100, pTm->tm_mon + 1, pTm->tm_mday);
+		time = ProDOS_PackTime(pTm->tm_hour, pTm->tm_min);
+	}
+
+	bool HostExists(const std::string& pathname)
+	{
+#if HOST_VOLUME_SUPPORTED
+		std::error_code ec;
+		return std::filesystem::exists(pathname, ec);
+#else
+		return false;
+#endif
+	}
+
+	// NB. Replaces 'to' if it's an existing file
+	bool HostRename(const std::string& from, const std::string& to)
+	{
+#if HOST_VOLUME_SUPPORTED
+		std::error_code ec;
+		std::filesystem::rename(from, to, ec);
+		if (!ec)
+			return true;
+#endif
+		LogOutput("HostVolume: failed to rename %s to %s\n", from.c_str(), to.c_str());
+		return false;
+	}
+
+	bool HostCreateDirectory(const std::string& pathname)
+	{
+#if HOST_VOLUME_SUPPORTED
+		std::error_code ec;
+		std::filesystem::create_directory(pathname, ec);
+		if (!ec)
+			return true;
+#endif
+		LogOutput("HostVolume: failed to create %s\n", pathname.c_str());
+		return false;
+	}
+}
+
+//===========================================================================
+
+// pBootBlocks: kBootBlocksSize bytes (or NULL for empty boot blocks)
+ProDOS_HostVolume::ProDOS_HostVolume(const std::string& pathname, const BYTE* pBootBlocks, const bool writeBack)
+	: m_pathname(pathname)
+	, m_bootBlocks(kBootBlocksSize, 0)
+	, m_writeBack(writeBack)
+	, m_nextBlock(0)
+	, m_syncPending(false)
+	, m_syncError(false)
+	, m_hostFile(NULL)
+	, m_hostFileNode(kNoNode)
+{
+	// Strip any trailing separator, so that the volume is named after the directory
+	while (m_pathname.length() > 1 && m_pathname.back() == PATH_SEPARATOR)
+		m_pathname.pop_back();
+
+	if (pBootBlocks)
+		memcpy(&m_bootBlocks[0], pBootBlocks, kBootBlocksSize);
+}
+
+ProDOS_HostVolume::~ProDOS_HostVolume(void)
+{
+	Flush();
+	Close();
+}
+
+bool ProDOS_HostVolume::IsHostDirectory(const std::string& pathname)
+{
+#if HOST_VOLUME_SUPPORTED
+	std::error_code ec;
+	return std::filesystem::is_directory(pathname, ec);
+#else
+	return false;
+#endif
+}
+
+//===========================================================================
+
+void ProDOS_HostVolume::Close(void)
+{
+	if (m_hostFile)
+		fclose(m_hostFile);
+
+	m_hostFile = NULL;
+	m_hostFileNode = kNoNode;
+}
+
+void ProDOS_HostVolume::Clear(void)
+{
+	Close();
+
+	m_nodes.clear();
+	m_extents.clear();
+	m_blocks.clear();
+	m_nextBlock = 0;
+	m_isDirty.assign(kNumBlocks, false);
+	m_syncPending = false;
+}
+
+bool ProDOS_HostVolume::Open(void)
+{
+	Clear();
+
+	Node root;
+	root.parent = kNoNode;
+	root.isDir = true;
+	root.hasTypeSuffix = false;
+	root.hostBacked = true;
+	root.alive = true;
+	root.type = kTypeDIR;
+	root.aux = 0;
+	root.access = kAccessAll;
+	root.eof = 0;
+	root.storage = PRODOS_KIND_ROOT;
+	root.keyBlock = PRODOS_ROOT_BLOCK;
+	root.blocksUsed = kRootDirBlocks;
+
+	const size_t slash = m_pathname.find_last_of(PATH_SEPARATOR);
+	root.hostName = (slash == std::string::npos) ? m_pathname : m_pathname.substr(slash + 1);
+	root.name = MakeProDOSName(root.hostName);
+	if (root.name.empty())
+		root.name = "HOST";
+	GetHostDateTime(m_pathname, root.date, root.time);
+
+	m_nodes.push_back(root);
+
+	if (!ScanDir(0, m_pathname, 0))
+		return false;
+
+	AddExtent(PRODOS_ROOT_BLOCK, EXTENT_BOOT, kNoNode);
+	AddExtent(kRootDirBlocks, EXTENT_DIR, 0);
+	AddExtent((kNumBlocks + kBlockSize * 8 - 1) / (kBlockSize * 8), EXTENT_BITMAP, kNoNode);
+
+	Allocate(0);
+
+	LogOutput("HostVolume: /%s from %s: %d files/dirs, %d blocks used\n",
+		m_nodes[0].name.c_str(), m_pathname.c_str(), (int)m_nodes.size() - 1, m_nextBlock);
+
+	return true;
+}
+
+void ProDOS_HostVolume::Rescan(void)
+{
+	Flush();
+	Open();
+}
+
+// Returns false if the guest's writes couldn't all be written back to the host directory
+bool ProDOS_HostVolume::Flush(void)
+{
+	if (m_syncPending)
+		return Sync();
+
+	return true;
+}
+
+void ProDOS_HostVolume::SetWriteBack(const bool writeBack)
+{
+	Flush();
+	m_writeBack = writeBack;
+}
+
+//===========================================================================
+
+bool ProDOS_HostVolume::ScanDir(const UINT dirNode, const std::string& hostPath, const UINT depth)
+{
+#if HOST_VOLUME_SUPPORTED
+	std::error_code ec;
+	std::filesystem::directory_iterator it(hostPath, ec);
+	if (ec)
+		return false;
+
+	std::vector<std::filesystem::directory_entry> entries;
+	for (; it != std::filesystem::directory_iterator(); it.increment(ec))
+	{
+		if (ec)
+			break;
+		entries.push_back(*it);
+	}
+
+	// Host directory order isn't defined, so sort for a repeatable layout
+	std::sort(entries.begin(), entries.end(),
+		[](const std::filesystem::directory_entry& a, const std::filesystem::directory_entry& b) { return a.path().filename() < b.path().filename(); });
+
+	for (const std::filesystem::directory_entry& entry : entries)
+	{
+		Node child;
+		child.hostName = entry.path().filename().string();
+		child.parent = dirNode;
+		child.isDir = entry.is_directory(ec);
+		child.hostBacked = true;
+		child.alive = true;
+		child.eof = 0;
+		child.keyBlock = 0;
+		child.blocksUsed = 0;
+
+		if ((!child.isDir && !entry.is_regular_file(ec)) || IsTempName(child.hostName))
+			continue;
+
+		std::string baseName = child.hostName;
+		child.hasTypeSuffix = !child.isDir && ParseTypeSuffix(baseName, child.type, child.aux);
+		child.name = MakeProDOSName(baseName);
+
+		bool skip = child.name.empty() || (child.isDir && depth + 1 >= kMaxDirDepth);
+		for (UINT sibling : m_nodes[dirNode].children)
+			skip |= (m_nodes[sibling].name == child.name);
+		if (dirNode == 0 && m_nodes[0].children.size() >= kMaxRootEntries)
+			skip = true;
+
+		if (child.isDir)
+		{
+			child.type = kTypeDIR;
+			child.aux = 0;
+			child.storage = PRODOS_KIND_DIR;
+		}
+		else
+		{
+			const uintmax_t size = entry.file_size(ec);
+			skip |= (ec || size > kMaxEOF);
+			child.eof = (UINT)size;
+
+			if (!child.hasTypeSuffix)
+			{
+				const bool isSystem = child.name == "PRODOS" ||
+					(child.name.length() > 7 && child.name.compare(child.name.length() - 7, 7, ".SYSTEM") == 0);
+				child.type = isSystem ? kTypeSYS : kTypeBIN;
+				child.aux = isSystem ? 0x2000 : 0x0000;
+			}
+
+			const UINT numDataBlocks = child.eof ? (child.eof + kBlockSize - 1) / kBlockSize : 1;
+			child.storage = (numDataBlocks == 1) ? PRODOS_KIND_SEED
+				: (numDataBlocks <= 256) ? PRODOS_KIND_SAPL
+				: PRODOS_KIND_TREE;
+		}
+
+		if (skip)
+		{
+			LogOutput("HostVolume: skipping %s\n", entry.path().string().c_str());
+			continue;
+		}
+
+		const std::filesystem::perms perms = entry.status(ec).permissions();
+		child.access = (perms & std::filesystem::perms::owner_write) != std::filesystem::perms::none ? kAccessAll : kAccessLocked;
+		GetHostDateTime(entry.path().string(), child.date, child.time);
+
+		const UINT childNode = (UINT)m_nodes.size();
+		m_nodes.push_back(child);
+		m_nodes[dirNode].children.push_back(childNode);
+
+		if (child.isDir)
+			ScanDir(childNode, entry.path().string(), depth + 1);
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+void ProDOS_HostVolume::AddExtent(const UINT numBlocks, const ExtentKind_e kind, const UINT node)
+{
+	Extent extent = { m_nextBlock, numBlocks, kind, node };
+	m_extents.push_back(extent);
+	m_nextBlock += numBlocks;
+}
+
+// Assign block numbers to a directory's children (the directory's own blocks are already allocated)
+void ProDOS_HostVolume::Allocate(const UINT dirNode)
+{
+	if (dirNode == 0)
+	{
+		for (UINT i = 0; i < kRootDirBlocks; i++)
+			m_nodes[0].dataBlocks.push_back(PRODOS_ROOT_BLOCK + i);
+	}
+
+	std::vector<UINT> children;
+	for (UINT child : m_nodes[dirNode].children)
+	{
+		Node& node = m_nodes[child];
+
+		UINT numIndexBlocks = 0;
+		UINT numDataBlocks = 0;
+		if (node.isDir)
+		{
+			numDataBlocks = ((UINT)node.children.size() + 1 + kEntriesPerBlock - 1) / kEntriesPerBlock;	// +1 for the subdir header
+		}
+		else
+		{
+			numDataBlocks = node.eof ? (node.eof + kBlockSize - 1) / kBlockSize : 1;
+			if (node.storage == PRODOS_KIND_SAPL)
+				numIndexBlocks = 1;
+			else if (node.storage == PRODOS_KIND_TREE)
+				numIndexBlocks = 1 + (numDataBlocks + 255) / 256;	// master index + index blocks
+		}
+
+		if (m_nextBlock + numIndexBlocks + numDataBlocks > kNumBlocks)
+		{
+			LogOutput("HostVolume: volume full, skipping %s\n", GetHostPath(child).c_str());
+			node.alive = false;
+			continue;
+		}
+
+		if (numIndexBlocks)
+			AddExtent(numIndexBlocks, EXTENT_INDEX, child);
+
+		const UINT firstDataBlock = m_nextBlock;
+		AddExtent(numDataBlocks, node.isDir ? EXTENT_DIR : EXTENT_DATA, child);
+
+		for (UINT i = 0; i < numDataBlocks; i++)
+			node.dataBlocks.push_back(firstDataBlock + i);
+
+		node.keyBlock = numIndexBlocks ? firstDataBlock - numIndexBlocks : firstDataBlock;
+		node.blocksUsed = numIndexBlocks + numDataBlocks;
+
+		children.push_back(child);
+
+		if (node.isDir)
+			Allocate(child);
+	}
+
+	m_nodes[dirNode].children = children;
+}
+
+const ProDOS_HostVolume::Extent* ProDOS_HostVolume::FindExtent(const UINT block)
+{
+	std::vector<Extent>::const_iterator it = std::upper_bound(m_extents.begin(), m_extents.end(), block,
+		[](const UINT block, const Extent& extent) { return block < extent.firstBlock; });
+
+	if (it == m_extents.begin())
+		return NULL;
+
+	--it;
+	if (block >= it->firstBlock + it->numBlocks)
+		return NULL;
+
+	return &*it;
+}
+
+std::string ProDOS_HostVolume::GetHostPath(const UINT node)
+{
+	if (node == 0)
+		return m_pathname;
+
+	return GetHostPath(m_nodes[node].parent) + PATH_SEPARATOR + m_nodes[node].hostName;
+}
+
+//===========================================================================
+
+bool ProDOS_HostVolume::ReadHostData(const UINT node, const UINT offset, BYTE* pBlockBuffer)
+{
+	memset(pBlockBuffer, 0, kBlockSize);
+
+	if (m_hostFileNode != node)
+	{
+		Close();
+		m_hostFile = fopen(GetHostPath(node).c_str(), "rb");
+		m_hostFileNode = node;
+	}
+
+	if (!m_hostFile)
+		return false;
+
+	if (fseek(m_hostFile, offset, SEEK_SET) != 0)
+		return false;
+
+	fread(pBlockBuffer, 1, kBlockSize, m_hostFile);	// NB. Short read for the last block
+	return true;
+}
+
+// A guest created file/dir can only take a host name that's not already in use, unless it's the leftover of a file the guest deleted
+bool ProDOS_HostVolume::IsHostPathFree(const UINT node, const std::string& pathname)
+{
+	if (!HostExists(pathname))
+		return true;
+
+	for (UINT i = 1; i < m_nodes.size(); i++)
+	{
+		const Node& other = m_nodes[i];
+		if (i != node && !other.alive && other.hostBacked && other.isDir == m_nodes[node].isDir && GetHostPath(i) == pathname)
+			return true;
+	}
+
+	return false;
+}
+
+//===========================================================================
+
+void ProDOS_HostVolume::GenerateDirBlock(const UINT node, const UINT index, BYTE* pBlockBuffer)
+{
+	const Node& dir = m_nodes[node];
+
+	ProDOS_Put16(pBlockBuffer, 0, index ? dir.dataBlocks[index - 1] : 0);
+	ProDOS_Put16(pBlockBuffer, 2, (index + 1 < dir.dataBlocks.size()) ? dir.dataBlocks[index + 1] : 0);
+
+	for (UINT i = 0; i < kEntriesPerBlock; i++)
+	{
+		const UINT entry = index * kEntriesPerBlock + i;
+
+		if (entry == 0)
+		{
+			ProDOS_VolumeHeader_t header;
+			memset(&header, 0, sizeof(header));
+			header.kind = (node == 0) ? PRODOS_KIND_ROOT : PRODOS_KIND_SUB;
+			header.len = (uint8_t) ProDOS_String_CopyUpper(header.name, dir.name.c_str(), PRODOS_MAX_FILENAME);
+			header.date = dir.date;
+			header.time = dir.time;
+			header.access = dir.access;
+			header.entry_len = kEntryLen;
+			header.entry_num = kEntriesPerBlock;
+			header.file_count = (uint16_t) dir.children.size();
+
+			if (node == 0)
+			{
+				header.meta.bitmap_block = (uint16_t) (PRODOS_ROOT_BLOCK + kRootDirBlocks);
+				header.meta.total_blocks = (uint16_t) kNumBlocks;
+			}
+			else
+			{
+				// Locate this subdir's file entry in its parent directory
+				const Node& parent = m_nodes[dir.parent];
+				const UINT parentEntry = (UINT)(std::find(parent.children.begin(), parent.children.end(), node) - parent.children.begin()) + 1;
+				header.info.res75 = 0x75;
+				header.subdir.parent_block = (uint16_t) parent.dataBlocks[parentEntry / kEntriesPerBlock];
+				header.subdir.parent_entry_num = (uint8_t) (parentEntry % kEntriesPerBlock + 1);
+				header.subdir.parent_entry_len = kEntryLen;
+			}
+
+			ProDOS_SetVolumeHeader(pBlockBuffer, &header, 0);
+			continue;
+		}
+
+		if (entry - 1 >= dir.children.size())
+			break;
+
+		const Node& child = m_nodes[dir.children[entry - 1]];
+
+		ProDOS_FileHeader_t file;
+		memset(&file, 0, sizeof(file));
+		file.kind = child.storage;
+		file.len = (uint8_t) ProDOS_String_CopyUpper(file.name, child.name.c_str(), PRODOS_MAX_FILENAME);
+		file.type = child.type;
+		file.inode = (uint16_t) child.keyBlock;
+		file.blocks = (uint16_t) child.blocksUsed;
+		file.size = child.isDir ? child.blocksUsed * kBlockSize : child.eof;
+		file.date = file.mod_date = child.date;
+		file.time = file.mod_time = child.time;
+		file.access = child.access;
+		file.aux = child.aux;
+		file.dir_block = (uint16_t) dir.keyBlock;
+
+		ProDOS_PutFileHeader(pBlockBuffer, 4 + i * kEntryLen, &file);
+	}
+}
+
+void ProDOS_HostVolume::GenerateIndexBlock(const Extent& extent, const UINT index, BYTE* pBlockBuffer)
+{
+	const Node& file = m_nodes[extent.node];
+	const UINT numDataBlocks = (UINT)file.dataBlocks.size();
+
+	if (file.storage == PRODOS_KIND_TREE && index == 0)
+	{
+		// Master index block: points to the other index blocks in this extent
+		for (UINT i = 1; i < extent.numBlocks; i++)
+			ProDOS_PutIndexBlock(pBlockBuffer, 0, i - 1, extent.firstBlock + i);
+		return;
+	}
+
+	const UINT first = (file.storage == PRODOS_KIND_TREE) ? (index - 1) * 256 : 0;
+	for (UINT i = 0; i < 256 && first + i < numDataBlocks; i++)
+		ProDOS_PutIndexBlock(pBlockBuffer, 0, i, file.dataBlocks[first + i]);
+}
+
+void ProDOS_HostVolume::GenerateBitmapBlock(const UINT index, BYTE* pBlockBuffer)
+{
+	// Bit set = free
+	for (UINT i = 0; i < kBlockSize * 8; i++)
+	{
+		const UINT block = index * kBlockSize * 8 + i;
+		if (block >= m_nextBlock && block < kNumBlocks)
+			pBlockBuffer[i / 8] |= 0x80 >> (i % 8);
+	}
+}
+
+//===========================================================================
+
+bool ProDOS_HostVolume::ReadBlock(const UINT block, BYTE* pBlockBuffer)
+{
+	if (block >= kNumBlocks)
+		return false;
+
+	std::unordered_map<UINT, Block>::const_iterator it = m_blocks.find(block);
+	if (it != m_blocks.end())
+	{
+		memcpy(pBlockBuffer, it->second.data(), kBlockSize);
+		return true;
+	}
+
+	memset(pBlockBuffer, 0, kBlockSize);
+
+	const Extent* pExtent = FindExtent(block);
+	if (!pExtent)
+		return true;	// Free block
+
+	const UINT index = block - pExtent->firstBlock;
+
+	switch (pExtent->kind)
+	{
+	case EXTENT_BOOT:
+		memcpy(pBlockBuffer, &m_bootBlocks[index * kBlockSize], kBlockSize);
+		return true;
+	case EXTENT_DATA:
+		return ReadHostData(pExtent->node, index * kBlockSize, pBlockBuffer);
+	case EXTENT_FREE:
+		return true;
+	case EXTENT_DIR:
+		GenerateDirBlock(pExtent->node, index, pBlockBuffer);
+		break;
+	case EXTENT_INDEX:
+		GenerateIndexBlock(*pExtent, index, pBlockBuffer);
+		break;
+	case EXTENT_BITMAP:
+		GenerateBitmapBlock(index, pBlockBuffer);
+		break;
+	}
+
+	// Metadata is generated once, then kept: so it's stable even as the host directory changes
+	memcpy(m_blocks[block].data(), pBlockBuffer, kBlockSize);
+	return true;
+}
+
+bool ProDOS_HostVolume::WriteBlock(const UINT block, const BYTE* pBlockBuffer)
+{
+	if (block >= kNumBlocks || !m_writeBack)
+		return false;
+
+	// NB. Not written back to the host until Flush(), as a guest's update of a file spans several block writes
+	memcpy(m_blocks[block].data(), pBlockBuffer, kBlockSize);
+	m_isDirty[block] = true;
+	m_syncPending = true;
+
+	return true;
+}
+
+//===========================================================================
+
+// The node's host file is about to be rewritten, so take a copy of its (host backed) blocks first
+void ProDOS_HostVolume::Detach(const UINT node)
+{
+	for (Extent& extent : m_extents)
+	{
+		if (extent.node != node || (extent.kind != EXTENT_DATA && extent.kind != EXTENT_INDEX))
+			continue;
+
+		for (UINT block = extent.firstBlock; block < extent.firstBlock + extent.numBlocks; block++)
+		{
+			if (m_blocks.find(block) == m_blocks.end())
+			{
+				Block data;
+				ReadBlock(block, data.data());
+				m_blocks[block] = data;
+			}
+		}
+
+		extent.kind = EXTENT_FREE;
+	}
+
+	if (m_hostFileNode == node)
+		Close();
+}
+
+bool ProDOS_HostVolume::GetFileBlocks(const BYTE storage, const UINT keyBlock, const UINT eof, std::vector<UINT>& dataBlocks)
+{
+	const UINT numDataBlocks = (eof + kBlockSize - 1) / kBlockSize;
+	Block index;
+
+	switch (storage)
+	{
+	case PRODOS_KIND_SEED:
+		dataBlocks.push_back(keyBlock);
+		break;
+	case PRODOS_KIND_SAPL:
+		if (!ReadBlock(keyBlock, index.data()))
+			return false;
+		for (UINT i = 0; i < 256 && i < numDataBlocks; i++)
+			dataBlocks.push_back(ProDOS_GetIndexBlock(index.data(), 0, i));
+		break;
+	case PRODOS_KIND_TREE:
+		{
+			Block master;
+			if (!ReadBlock(keyBlock, master.data()))
+				return false;
+			for (UINT i = 0; i < 128 && dataBlocks.size() < numDataBlocks; i++)
+			{
+				const UINT indexBlock = ProDOS_GetIndexBlock(master.data(), 0, i);
+				if (indexBlock == 0)
+					index.fill(0);	// Sparse
+				else if (!ReadBlock(indexBlock, index.data()))
+					return false;
+				for (UINT j = 0; j < 256 && dataBlocks.size() < numDataBlocks; j++)
+					dataBlocks.push_back(ProDOS_GetIndexBlock(index.data(), 0, j));
+			}
+		}
+		break;
+	default:
+		return false;
+	}
+
+	for (UINT block : dataBlocks)
+	{
+		if (block >= kNumBlocks)
+			return false;
+	}
+
+	return true;
+}
+
+// Write to a temp file, then rename over the host file: so the host file is never left truncated
+bool ProDOS_HostVolume::WriteHostFile(const UINT node)
+{
+	const Node& file = m_nodes[node];
+	const std::string pathname = GetHostPath(node);
+	const std::string tempPathname = pathname + kTempSuffix;
+
+	if (m_hostFileNode == node)
+		Close();
+
+	FILE* hFile = fopen(tempPathname.c_str(), "wb");
+	if (!hFile)
+	{
+		LogOutput("HostVolume: failed to write %s\n", tempPathname.c_str());
+		return false;
+	}
+
+	bool res = true;
+	UINT remaining = file.eof;
+	for (UINT block : file.dataBlocks)
+	{
+		if (!remaining)
+			break;
+
+		Block data;
+		data.fill(0);
+		if (block)
+			ReadBlock(block, data.data());
+
+		const UINT size = MIN(kBlockSize, remaining);
+		res &= fwrite(data.data(), 1, size, hFile) == size;
+		remaining -= size;
+	}
+
+	res &= fclose(hFile) == 0;
+
+	if (res)
+		res = HostRename(tempPathname, pathname);
+	else
+		LogOutput("HostVolume: failed to write %s\n", tempPathname.c_str());
+
+	if (!res)
+		remove(tempPathname.c_str());
+
+	return res;
+}
+
+std::string ProDOS_HostVolume::MakeHostName(const UINT node)
+{
+	const Node& file = m_nodes[node];
+	if (!file.hasTypeSuffix)
+		return file.name;
+
+	return file.name + StrFormat("#%02X%04X", file.type, file.aux);
+}
+
+// Reflect the guest's view of the volume back to the host directory
+bool ProDOS_HostVolume::Sync(void)
+{
+	m_syncPending = false;
+	m_syncError = false;
+
+	// Generate any directory blocks that the guest hasn't read yet, before the nodes they're generated from change
+	for (const Extent& extent : m_extents)
+	{
+		if (extent.kind != EXTENT_DIR)
+			continue;
+
+		for (UINT block = extent.firstBlock; block < extent.firstBlock + extent.numBlocks; block++)
+		{
+			Block data;
+			ReadBlock(block, data.data());
+		}
+	}
+
+	std::vector<bool> seen(m_nodes.size(), false);
+	seen[0] = true;
+	SyncDir(0, PRODOS_ROOT_BLOCK, seen, 0);
+
+	// Anything not seen has been deleted by the guest: but leave it on the host
+	for (UINT node = 1; node < m_nodes.size(); node++)
+	{
+		if (!m_nodes[node].alive || seen[node])
+			continue;
+
+		if (m_nodes[node].hostBacked)
+			LogOutput("HostVolume: %s deleted by the guest (kept on the host)\n", GetHostPath(node).c_str());
+
+		Detach(node);
+		m_nodes[node].alive = false;
+	}
+
+	m_isDirty.assign(kNumBlocks, false);
+	return !m_syncError;
+}
+
+void ProDOS_HostVolume::SyncDir(const UINT dirNode, const UINT keyBlock, std::vector<bool>& seen, const UINT depth)
+{
+	if (depth >= kMaxDirDepth)
+		return;
+
+	std::vector<UINT> dirBlocks;
+	UINT block = keyBlock;
+
+	while (block && block < kNumBlocks && std::find(dirBlocks.begin(), dirBlocks.end(), block) == dirBlocks.end())
+	{
+		dirBlocks.push_back(block);
+
+		Block data;
+		ReadBlock(block, data.data());
+
+		for (UINT i = (dirBlocks.size() == 1) ? 1 : 0; i < kEntriesPerBlock; i++)
+		{
+			ProDOS_FileHeader_t file;
+			ProDOS_GetFileHeader(data.data(), 4 + i * kEntryLen, &file);
+
+			const bool isDir = file.kind == PRODOS_KIND_DIR;
+			if (!isDir && file.kind != PRODOS_KIND_SEED && file.kind != PRODOS_KIND_SAPL && file.kind != PRODOS_KIND_TREE)
+				continue;	// Deleted, or a Pascal area/GS/OS extended file (unsupported)
+
+			// Match by key block, else by name (eg. a seedling file that grew gets a new key block)
+			UINT child = kNoNode;
+			for (UINT pass = 0; pass < 2 && child == kNoNode; pass++)
+			{
+				for (UINT node : m_nodes[dirNode].children)
+				{
+					const Node& n = m_nodes[node];
+					if (n.alive && n.isDir == isDir && !seen[node] &&
+						(pass == 0 ? n.keyBlock == file.inode : n.name == file.name))
+					{
+						child = node;
+						break;
+					}
+				}
+			}
+
+			const bool isNew = child == kNoNode;
+			if (isNew)
+			{
+				Node newNode;
+				newNode.parent = dirNode;
+				newNode.isDir = isDir;
+				newNode.hasTypeSuffix = !isDir;	// Keep the ProDOS type of files created by the guest
+				newNode.hostBacked = m_nodes[dirNode].hostBacked;
+				newNode.alive = true;
+				newNode.type = file.type;
+				newNode.aux = file.aux;
+				newNode.eof = 0;
+				newNode.storage = file.kind;
+				newNode.keyBlock = file.inode;
+				newNode.blocksUsed = 0;
+
+				child = (UINT)m_nodes.size();
+				m_nodes.push_back(newNode);
+				m_nodes[dirNode].children.push_back(child);
+				seen.push_back(true);
+			}
+
+			seen[child] = true;
+
+			Node& node = m_nodes[child];
+			node.access = file.access;
+			node.date = file.mod_date;
+			node.time = file.mod_time;
+			node.blocksUsed = file.blocks;
+
+			const bool renamed = node.name != file.name;
+			const bool retyped = node.type != file.type || node.aux != file.aux;
+			node.keyBlock = file.inode;
+			node.type = file.type;
+			node.aux = file.aux;
+
+			if (isNew || renamed || (retyped && node.hasTypeSuffix))
+			{
+				node.name = file.name;
+
+				const std::string hostName = MakeHostName(child);
+				if (isNew)
+				{
+					node.hostName = hostName;
+					if (node.hostBacked && !IsHostPathFree(child, GetHostPath(child)))
+					{
+						LogOutput("HostVolume: %s already exists, so not written back\n", GetHostPath(child).c_str());
+						node.hostBacked = false;
+					}
+					if (node.hostBacked && isDir)
+						m_syncError |= !HostCreateDirectory(GetHostPath(child));
+				}
+				else if (hostName != node.hostName && node.hostBacked)
+				{
+					if (m_hostFileNode == child)
+						Close();
+
+					const std::string oldPath = GetHostPath(child);
+					node.hostName = hostName;
+					const std::string newPath = GetHostPath(child);
+
+					if (!IsHostPathFree(child, newPath))
+					{
+						LogOutput("HostVolume: %s already exists, so not renamed from %s\n", newPath.c_str(), oldPath.c_str());
+						node.hostBacked = false;
+						m_syncError = true;
+					}
+					else if (!HostRename(oldPath, newPath))
+					{
+						node.hostBacked = false;
+						m_syncError = true;
+					}
+				}
+				else
+				{
+					node.hostName = hostName;
+				}
+			}
+
+			if (isDir)
+			{
+				SyncDir(child, file.inode, seen, depth + 1);
+				continue;
+			}
+
+			std::vector<UINT> dataBlocks;
+			if (!GetFileBlocks(file.kind, file.inode, file.size, dataBlocks))
+			{
+				LogOutput("HostVolume: bad file %s\n", GetHostPath(child).c_str());
+				continue;
+			}
+
+			bool changed = isNew || node.eof != file.size || node.storage != file.kind || node.dataBlocks != dataBlocks;
+
+			for (UINT i = 0; i < dataBlocks.size() && !changed; i++)
+				changed = dataBlocks[i] && m_isDirty[dataBlocks[i]];
+
+			if (!changed)
+				continue;
+
+			Detach(child);
+			node.eof = file.size;
+			node.storage = file.kind;
+			node.dataBlocks = dataBlocks;
+			if (node.hostBacked)
+				m_syncError |= !WriteHostFile(child);
+		}
+
+		block = ProDOS_Get16(data.data(), 2);
+	}
+
+	m_nodes[dirNode].dataBlocks = dirBlocks;
+}
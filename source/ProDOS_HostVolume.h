@@ -0,0 +1,130 @@
+#pragma once
+
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2024, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <array>
+#include <unordered_map>
+
+// A ProDOS block device synthesised from a host directory (for the HDD card).
+// . The layout (block numbers) is fixed when the directory is scanned; directory, index, bitmap & boot blocks
+//   are generated on first read, and file data is read straight from the host files.
+// . The volume is read-only, unless write-back is enabled. Then guest writes are kept (so the guest always sees
+//   what it wrote), and on Flush() the volume's directory tree is walked and created/changed/renamed files are
+//   reflected back to the host directory. Changed files are replaced via a temp file & a rename.
+// . Host files are never deleted: a file deleted by the guest is left on the host (and reappears on a rescan).
+// . Host files can carry a ProDOS type & aux type as a "#ttaaaa" suffix, eg. "HELLO#062000".
+class ProDOS_HostVolume
+{
+public:
+	ProDOS_HostVolume(const std::string& pathname, const BYTE* pBootBlocks, const bool writeBack);
+	~ProDOS_HostVolume(void);
+
+	static bool IsHostDirectory(const std::string& pathname);
+
+	bool Open(void);
+	void Rescan(void);
+	bool Flush(void);
+	bool IsSyncPending(void) { return m_syncPending; }
+	bool GetWriteBack(void) { return m_writeBack; }
+	void SetWriteBack(const bool writeBack);
+
+	const std::string& GetPathname(void) { return m_pathname; }
+	UINT GetNumBlocks(void) { return kNumBlocks; }
+	bool ReadBlock(const UINT block, BYTE* pBlockBuffer);
+	bool WriteBlock(const UINT block, const BYTE* pBlockBuffer);
+
+	static const UINT kBootBlocksSize = 2 * 512;
+
+private:
+	static const UINT kBlockSize = 512;
+	static const UINT kNumBlocks = 0xFFFF;		// 32MiB, the largest ProDOS volume
+	static const UINT kNoNode = (UINT)-1;
+
+	enum ExtentKind_e { EXTENT_BOOT, EXTENT_DIR, EXTENT_BITMAP, EXTENT_INDEX, EXTENT_DATA, EXTENT_FREE };
+
+	struct Extent
+	{
+		UINT firstBlock;
+		UINT numBlocks;
+		ExtentKind_e kind;
+		UINT node;
+	};
+
+	struct Node
+	{
+		std::string hostName;		// leaf name on the host
+		std::string name;			// ProDOS name
+		UINT parent;
+		bool isDir;
+		bool hasTypeSuffix;			// host name ends in "#ttaaaa"
+		bool hostBacked;			// false if a guest created file couldn't be given a host file (eg. name clash)
+		bool alive;
+		BYTE type;
+		WORD aux;
+		BYTE access;
+		WORD date;
+		WORD time;
+		UINT eof;
+		BYTE storage;
+		UINT keyBlock;
+		UINT blocksUsed;
+		std::vector<UINT> dataBlocks;	// file: data blocks in file order (0 = sparse) / dir: directory blocks
+		std::vector<UINT> children;
+	};
+
+	typedef std::array<BYTE, kBlockSize> Block;
+
+	void Close(void);
+	void Clear(void);
+	bool ScanDir(const UINT dirNode, const std::string& hostPath, const UINT depth);
+	void Allocate(const UINT dirNode);
+	void AddExtent(const UINT numBlocks, const ExtentKind_e kind, const UINT node);
+	const Extent* FindExtent(const UINT block);
+	std::string GetHostPath(const UINT node);
+	bool ReadHostData(const UINT node, const UINT offset, BYTE* pBlockBuffer);
+	bool IsHostPathFree(const UINT node, const std::string& pathname);
+	void GenerateDirBlock(const UINT node, const UINT index, BYTE* pBlockBuffer);
+	void GenerateIndexBlock(const Extent& extent, const UINT index, BYTE* pBlockBuffer);
+	void GenerateBitmapBlock(const UINT index, BYTE* pBlockBuffer);
+	void Detach(const UINT node);
+	bool Sync(void);
+	void SyncDir(const UINT dirNode, const UINT keyBlock, std::vector<bool>& seen, const UINT depth);
+	bool GetFileBlocks(const BYTE storage, const UINT keyBlock, const UINT eof, std::vector<UINT>& dataBlocks);
+	bool WriteHostFile(const UINT node);
+	std::string MakeHostName(const UINT node);
+
+	std::string m_pathname;
+	std::vector<BYTE> m_bootBlocks;
+	bool m_writeBack;
+	std::vector<Node> m_nodes;
+	std::vector<Extent> m_extents;			// sorted by firstBlock; blocks beyond the last extent are free
+	UINT m_nextBlock;
+	std::unordered_map<UINT, Block> m_blocks;	// generated metadata blocks & all blocks written by the guest
+	std::vector<bool> m_isDirty;			// written since the last Sync()
+	bool m_syncPending;
+	bool m_syncError;
+
+	FILE* m_hostFile;						// last host file read (by ReadHostData())
+	UINT m_hostFileNode;
+};
@@ -68,7 +68,8 @@ static YamlHelper yamlHelper;
 // v7: Extended: joystick (added 'Paddle Inactive Cycle')
 // v8: Added 'Unit Game I/O Connector' for Game I/O Connector
 // v9: Extended: memory (added 'Last Slot to Set Main Mem LC', 'MMU LC Mode')
-#define UNIT_APPLE2_VER 9
+// v10: Extended: memory (main memory can be a compressed block)
+#define UNIT_APPLE2_VER 10
 
 #define UNIT_SLOTS_VER 1
 
@@ -91,6 +92,20 @@ void Snapshot_SetIgnoreHdcFirmware(const bool ignoreHdcFirmware)
 	g_ignoreHdcFirmware = ignoreHdcFirmware;
 }
 
+// Memory blocks are saved zlib-compressed by default; hex is only for debugging/diffing save-states.
+// Both are always supported on load, so load + save converts between them.
+static bool g_compressMemory = true;
+
+bool Snapshot_GetCompressMemory()
+{
+	return g_compressMemory;
+}
+
+void Snapshot_SetCompressMemory(const bool compressMemory)
+{
+	g_compressMemory = compressMemory;
+}
+
 //-----------------------------------------------------------------------------
 
 static void Snapshot_SetPathname(const std::string& strPathname)
@@ -488,6 +503,7 @@ void Snapshot_SaveState(void)
 	try
 	{
 		YamlSaveHelper yamlSaveHelper(g_strSaveStatePathname);
+		yamlSaveHelper.SetCompressMemory(g_compressMemory);
 		yamlSaveHelper.FileHdr(SS_FILE_VER);
 
 		// Unit: Apple2
@@ -15,3 +15,6 @@ void Snapshot_Shutdown();
 
 bool Snapshot_GetIgnoreHdcFirmware();
 void Snapshot_SetIgnoreHdcFirmware(const bool ignoreHdcFirmware);
+
+bool Snapshot_GetCompressMemory();
+void Snapshot_SetCompressMemory(const bool compressMemory);
@@ -34,6 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Interface.h"
 #include "Log.h"
 #include "Memory.h"
+#include "PerfCounters.h"
 #include "SoundCore.h"
 #include "YamlHelper.h"
 #include "Riff.h"
@@ -65,12 +66,22 @@ static short*	g_pSpeakerBuffer = NULL;
 // Globals (SOUND_WAVE)
 const short		SPKR_DATA_INIT = (short)0x8000;
 
-short		g_nSpeakerData	= SPKR_DATA_INIT;
+static short	g_nSpeakerData	= SPKR_DATA_INIT;	// Speaker level at g_nSpkrLastCycle (ie. as rendered so far)
+static short	g_nSpkrToggleLevel = SPKR_DATA_INIT;	// Speaker level after the most recent (logged) toggle
 static UINT		g_nBufferIdx	= 0;		// Sample index
 
-static short*	g_pRemainderBuffer = NULL;
-static UINT		g_nRemainderBufferSize;		// Setup in SpkrInitialize()
-static UINT		g_nRemainderBufferIdx;		// Setup in SpkrInitialize()
+// Toggle log: SpkrToggle() just records each level change, and they are all rendered in one pass by SpkrUpdate()
+struct SpkrEvent
+{
+	unsigned __int64 cycle;
+	short level;
+	bool resetDCFilter;
+	bool render;	// Sound was being output (ie. not full-speed) when the toggle was logged
+};
+
+static const UINT kMaxSpkrEvents = 4096;	// If full, then SpkrToggle() renders the log early
+static SpkrEvent g_spkrEvents[kMaxSpkrEvents];
+static UINT g_nSpkrEvents = 0;
 
 // Application-wide globals:
 SoundType_e		soundtype		= SOUND_WAVE;
@@ -93,6 +104,7 @@ static ULONG   Spkr_SubmitWaveBuffer_FullSpeed(short* pSpeakerBuffer, ULONG nNum
 static ULONG   Spkr_SubmitWaveBuffer(short* pSpeakerBuffer, ULONG nNumSamples);
 static void    Spkr_SetActive(bool bActive);
 static void    Spkr_DSUninit();
+static void    DiscardSpkrEvents();
 
 //-----------------------------------------------------------------------------
 
@@ -134,7 +146,7 @@ static void DisplayBenchmarkResults ()
 //
 // The approach works as follows:
 // - SpkrToggle() is called when the speaker state is flipped by accessing $C030
-// - This brings audio up to date then calls ResetDCFilter()
+// - This logs the toggle, and when rendered, audio is brought up to date then ResetDCFilter() is called
 // - ResetDCFilter() sets a counter to a high value
 // - every audio sample is processed by DCFilter() as follows:
 //   - if the counter is >= 32768, the speaker has been recently toggled
@@ -193,21 +205,111 @@ static void SetClksPerSpkrSample()
 }
 
 //=============================================================================
+//
+// Band-limited steps (BLEP)
+//
+// Each logged speaker level change is rendered as a band-limited step (an integrated,
+// Blackman-windowed sinc) centred on the toggle's exact cycle, instead of averaging
+// the speaker level over each sample's 23 cycles. The box average lets through a lot
+// of energy above Nyquist (eg. from 1-bit PWM music), which aliases back as audible tones.
+//
+// - A step of height 'delta' at sample position 's' adds delta*H(n-s) to each output
+//   sample 'n' in [s-kBlepTaps/2, s+kBlepTaps/2), and 'delta' to all samples after that.
+// - H() is tabulated for kBlepPhases sub-sample positions (the step's cycle within a sample).
+// - So a sample can only be output once the emulation is kBlepTaps/2 samples past it
+//   (ie. ~0.36ms of latency at 44.1kHz).
+//
+
+static const UINT kBlepTaps = 32;
+static const UINT kBlepPhases = 64;
+static const UINT kBlepRingSize = 64;	// Power of 2, and > kBlepTaps+2
+static const double kBlepCutoff = 0.42;	// Cycles per sample (Nyquist = 0.5)
+
+static float	g_blepTable[kBlepPhases + 1][kBlepTaps];
+static float	g_blepRing[kBlepRingSize];		// Partial steps for the next kBlepRingSize samples
+static float	g_blepStepRing[kBlepRingSize];	// Completed steps, added to g_blepLevel from this sample on
+static float	g_blepLevel = 0.0f;				// Speaker level of all completed steps
+static UINT		g_nBlepRingIdx = 0;				// Ring index of the next sample to output
+static unsigned __int64 g_nBlepSampleCycle = 0;	// Cycle of the next sample to output
 
-static void InitRemainderBuffer()
+static void InitBlepTable()
 {
-	delete [] g_pRemainderBuffer;
+	static bool bInitialized = false;
+	if (bInitialized)
+		return;
+	bInitialized = true;
+
+	// Integrate the windowed sinc numerically, then normalise so that each step ends at 1.0
+	const UINT kSubSteps = 16;
+	const UINT kNumPoints = kBlepTaps * kBlepPhases * kSubSteps;
+	const double dt = 1.0 / (kBlepPhases * kSubSteps);
+	const double halfWidth = kBlepTaps / 2;
+	const double kPi = 3.14159265358979323846;
+
+	std::vector<double> integral(kNumPoints + 1);
+	integral[0] = 0.0;
+	for (UINT i = 0; i < kNumPoints; i++)
+	{
+		const double t = -halfWidth + (i + 0.5) * dt;
+		const double x = 2.0 * kBlepCutoff * t;
+		const double sinc = (x == 0.0) ? 1.0 : sin(kPi * x) / (kPi * x);
+		const double w = 0.42 + 0.5 * cos(kPi * t / halfWidth) + 0.08 * cos(2.0 * kPi * t / halfWidth);
+		integral[i + 1] = integral[i] + sinc * w * dt;
+	}
 
-	SetClksPerSpkrSample();
+	// Step at fractional sample position p/kBlepPhases: tap j is at n-s = j - (kBlepTaps/2 - 1) - p/kBlepPhases
+	for (UINT p = 0; p <= kBlepPhases; p++)
+	{
+		for (UINT j = 0; j < kBlepTaps; j++)
+		{
+			const UINT point = (j + 1) * kBlepPhases * kSubSteps - p * kSubSteps;
+			g_blepTable[p][j] = (float)(integral[point] / integral[kNumPoints]);
+		}
+	}
+}
+
+// Start a new sample grid at /cycle/, settled at the current speaker level
+static void ResetBlep(const unsigned __int64 cycle)
+{
+	memset(g_blepRing, 0, sizeof(g_blepRing));
+	memset(g_blepStepRing, 0, sizeof(g_blepStepRing));
+	g_blepLevel = g_nSpeakerData;
+	g_nBlepRingIdx = 0;
+	g_nBlepSampleCycle = cycle;
+}
+
+// Add a step to 'level' at /cycle/ (which must not be before the previous step)
+static void AddBlepStep(const unsigned __int64 cycle, const short level)
+{
+	const float delta = (float)level - (float)g_nSpeakerData;
+	if (delta == 0.0f)
+		return;
+
+	const UINT clksPerSample = (UINT)g_fClksPerSpkrSample;
+	const UINT cycleOffset = (cycle > g_nBlepSampleCycle) ? (UINT)(cycle - g_nBlepSampleCycle) : 0;	// NB. < kBlepTaps/2 samples, as UpdateSpkr(cycle) has output all samples before that
+	const UINT sample = cycleOffset / clksPerSample;
+	const UINT phase = ((cycleOffset % clksPerSample) * kBlepPhases + clksPerSample / 2) / clksPerSample;
 
-	g_nRemainderBufferSize = (UINT) g_fClksPerSpkrSample;
-	if ((double)g_nRemainderBufferSize < g_fClksPerSpkrSample)
-		g_nRemainderBufferSize++;
+	// Taps start kBlepTaps/2-1 samples before the step, but not before the next sample to output
+	const int firstTap = (int)sample - (int)(kBlepTaps / 2 - 1);
+	const float* table = g_blepTable[phase];
 
-	g_pRemainderBuffer = new short [g_nRemainderBufferSize];
-	memset(g_pRemainderBuffer, 0, g_nRemainderBufferSize);
+	for (UINT j = (firstTap < 0) ? (UINT)-firstTap : 0; j < kBlepTaps; j++)
+		g_blepRing[(g_nBlepRingIdx + firstTap + j) & (kBlepRingSize - 1)] += delta * table[j];
 
-	g_nRemainderBufferIdx = 0;
+	const int stepDone = firstTap + kBlepTaps;
+	_ASSERT(stepDone < (int)kBlepRingSize);
+	if (stepDone <= 0)
+		g_blepLevel += delta;
+	else
+		g_blepStepRing[(g_nBlepRingIdx + stepDone) & (kBlepRingSize - 1)] += delta;
+}
+
+static void InitBlep()
+{
+	SetClksPerSpkrSample();
+	InitBlepTable();
+	ResetBlep(g_nSpkrLastCycle);
 }
 
 //
@@ -225,11 +327,10 @@ void SpkrDestroy ()
 	if(soundtype == SOUND_WAVE)
 	{
 		delete [] g_pSpeakerBuffer;
-		delete [] g_pRemainderBuffer;
-		
 		g_pSpeakerBuffer = NULL;
-		g_pRemainderBuffer = NULL;
 	}
+
+	DiscardSpkrEvents();
 }
 
 //=============================================================================
@@ -274,7 +375,7 @@ void SpkrInitialize ()
 
 	if (soundtype == SOUND_WAVE)
 	{
-		InitRemainderBuffer();
+		InitBlep();
 
 		g_pSpeakerBuffer = new short [SPKR_SAMPLE_RATE * g_nSPKR_NumChannels];	// Buffer can hold a max of 1 seconds worth of samples
 	}
@@ -287,7 +388,7 @@ void SpkrReinitialize ()
 {
 	if (soundtype == SOUND_WAVE)
 	{
-		InitRemainderBuffer();
+		InitBlep();
 	}
 }
 
@@ -295,11 +396,12 @@ void SpkrReinitialize ()
 
 void SpkrReset()
 {
+	DiscardSpkrEvents();
 	g_nBufferIdx = 0;
 	g_nSpkrQuietCycleCount = 0;
 	g_bSpkrToggleFlag = false;
 
-	InitRemainderBuffer();
+	InitBlep();
 	Spkr_SubmitWaveBuffer(NULL, 0);
 	Spkr_SetActive(false);
 	Spkr_Unmute();
@@ -309,7 +411,7 @@ void SpkrReset()
 
 void SpkrSetEmulationType (SoundType_e newtype)
 {
-  SpkrDestroy();	// GH#295: Destroy for all types (even SOUND_NONE)
+  SpkrDestroy();	// GH#295: Destroy for all types (even SOUND_NONE). NB. Also discards any logged toggles
 
   soundtype = newtype;
   if (soundtype != SOUND_NONE)
@@ -318,85 +420,88 @@ void SpkrSetEmulationType (SoundType_e newtype)
 
 //=============================================================================
 
-static void ReinitRemainderBuffer(UINT nCyclesRemaining)
+// Output all samples up to /cycle/ that no later step can affect
+static void UpdateSpkr(const unsigned __int64 cycle, const bool render)
 {
-	if(nCyclesRemaining == 0)
+	if (!render)
+	{
+		// Full-speed: no samples for this period, so restart the sample grid here
+		ResetBlep(cycle);
+		g_nSpkrLastCycle = cycle;
 		return;
+	}
 
-	for(g_nRemainderBufferIdx=0; g_nRemainderBufferIdx<nCyclesRemaining; g_nRemainderBufferIdx++)
-		g_pRemainderBuffer[g_nRemainderBufferIdx] = g_nSpeakerData;
-
-	_ASSERT(g_nRemainderBufferIdx < g_nRemainderBufferSize);
-}
+	const UINT clksPerSample = (UINT)g_fClksPerSpkrSample;
+	const unsigned __int64 latency = (unsigned __int64)(kBlepTaps / 2) * clksPerSample;
 
-static void UpdateRemainderBuffer(ULONG* pnCycleDiff)
-{
-	if(g_nRemainderBufferIdx)
+	while (g_nBlepSampleCycle + latency <= cycle)
 	{
-		while((g_nRemainderBufferIdx < g_nRemainderBufferSize) && *pnCycleDiff)
+		const UINT idx = g_nBlepRingIdx;
+		g_blepLevel += g_blepStepRing[idx];
+		float level = g_blepLevel + g_blepRing[idx];
+		g_blepStepRing[idx] = 0.0f;
+		g_blepRing[idx] = 0.0f;
+		g_nBlepRingIdx = (idx + 1) & (kBlepRingSize - 1);
+		g_nBlepSampleCycle += clksPerSample;
+
+		if (g_nBufferIdx >= SPKR_SAMPLE_RATE - 1)
+			continue;
+
+		// Clip the step overshoot (Gibbs) at full volume
+		if (level > 32767.0f) level = 32767.0f;
+		else if (level < -32768.0f) level = -32768.0f;
+
+		const short sample = DCFilter((short)level);
+		if (g_nSPKR_NumChannels == 1)
 		{
-			g_pRemainderBuffer[g_nRemainderBufferIdx] = g_nSpeakerData;
-			g_nRemainderBufferIdx++;
-			(*pnCycleDiff)--;
+			g_pSpeakerBuffer[g_nBufferIdx] = sample;
 		}
-
-		if(g_nRemainderBufferIdx == g_nRemainderBufferSize)
+		else
 		{
-			g_nRemainderBufferIdx = 0;
-			signed long nSampleMean = 0;
-			for(UINT i=0; i<g_nRemainderBufferSize; i++)
-				nSampleMean += (signed long) g_pRemainderBuffer[i];
-			nSampleMean /= (signed long) g_nRemainderBufferSize;
-
-			if (g_nBufferIdx < SPKR_SAMPLE_RATE - 1)
-			{
-				if (g_nSPKR_NumChannels == 1)
-				{
-					g_pSpeakerBuffer[g_nBufferIdx] = DCFilter((short)nSampleMean);
-				}
-				else
-				{
-					const short sample = DCFilter((short)nSampleMean);
-					g_pSpeakerBuffer[g_nBufferIdx * 2 + 0] = sample;
-					g_pSpeakerBuffer[g_nBufferIdx * 2 + 1] = sample;
-				}
-				g_nBufferIdx++;
-			}
+			g_pSpeakerBuffer[g_nBufferIdx * 2 + 0] = sample;
+			g_pSpeakerBuffer[g_nBufferIdx * 2 + 1] = sample;
 		}
+		g_nBufferIdx++;
 	}
+
+	g_nSpkrLastCycle = cycle;
 }
 
-static void UpdateSpkr()
+static bool IsSpkrRendering()
 {
-  if(!g_bFullSpeed || SoundCore_GetTimerState())
-  {
-	  ULONG nCycleDiff = (ULONG) (g_nCumulativeCycles - g_nSpkrLastCycle);
+	return !g_bFullSpeed || SoundCore_GetTimerState();
+}
 
-	  UpdateRemainderBuffer(&nCycleDiff);
+// Render all logged toggles (in cycle order) into the speaker buffer
+static void RenderSpkrEvents()
+{
+	for (UINT i = 0; i < g_nSpkrEvents; i++)
+	{
+		const SpkrEvent& event = g_spkrEvents[i];
 
-	  ULONG nNumSamples = (ULONG) ((double)nCycleDiff / g_fClksPerSpkrSample);
+		UpdateSpkr(event.cycle, event.render);
 
-	  ULONG nCyclesRemaining = (ULONG) ((double)nCycleDiff - (double)nNumSamples * g_fClksPerSpkrSample);
+		if (event.resetDCFilter)
+			ResetDCFilter();
 
-	  while ((nNumSamples--) && (g_nBufferIdx < SPKR_SAMPLE_RATE - 1))
-	  {
-		  if (g_nSPKR_NumChannels == 1)
-		  {
-			  g_pSpeakerBuffer[g_nBufferIdx] = DCFilter(g_nSpeakerData);
-		  }
-		  else
-		  {
-			  const short sample = DCFilter(g_nSpeakerData);
-			  g_pSpeakerBuffer[g_nBufferIdx * 2 + 0] = sample;
-			  g_pSpeakerBuffer[g_nBufferIdx * 2 + 1] = sample;
-		  }
-		  g_nBufferIdx++;
-	  }
+		AddBlepStep(event.cycle, event.level);
+		g_nSpeakerData = event.level;
+	}
 
-	  ReinitRemainderBuffer(nCyclesRemaining);	// Partially fill 1Mhz sample buffer
-  }
+	g_nSpkrEvents = 0;
+}
 
-  g_nSpkrLastCycle = g_nCumulativeCycles;
+static void UpdateSpkr()
+{
+	RenderSpkrEvents();
+	UpdateSpkr(g_nCumulativeCycles, IsSpkrRendering());
+}
+
+static void DiscardSpkrEvents()
+{
+	g_nSpkrEvents = 0;
+	g_nSpeakerData = g_nSpkrToggleLevel;
+	ResetBlep(g_nSpkrLastCycle);
 }
 
 //=============================================================================
@@ -424,20 +529,25 @@ BYTE __stdcall SpkrToggle (WORD, WORD, BYTE, BYTE, ULONG nExecutedCycles)
   {
 	  CpuCalcCycles(nExecutedCycles);
 
-	  UpdateSpkr();
+	  if (g_nSpkrEvents == kMaxSpkrEvents)
+		  RenderSpkrEvents();
 
       short speakerDriveLevel = SPKR_DATA_INIT;
       if (g_bQuieterSpeaker)	// quieten the speaker if 8 bit DAC in use
         speakerDriveLevel /= 4;	// NB. Don't shift -ve number right: undefined behaviour (MSDN says: implementation-dependent)
 
-      // When full-speed: Don't ResetDCFilter(), otherwise get occasional clicks when speaker toggled
-      if (!g_bFullSpeed)
-        ResetDCFilter();
-
-      if (g_nSpeakerData == speakerDriveLevel)
-        g_nSpeakerData = ~speakerDriveLevel;
+      if (g_nSpkrToggleLevel == speakerDriveLevel)
+        g_nSpkrToggleLevel = ~speakerDriveLevel;
       else
-        g_nSpeakerData = speakerDriveLevel;
+        g_nSpkrToggleLevel = speakerDriveLevel;
+
+      // Just log the toggle - it's rendered by SpkrUpdate()
+      SpkrEvent& event = g_spkrEvents[g_nSpkrEvents++];
+      event.cycle = g_nCumulativeCycles;
+      event.level = g_nSpkrToggleLevel;
+      // When full-speed: Don't ResetDCFilter(), otherwise get occasional clicks when speaker toggled
+      event.resetDCFilter = !g_bFullSpeed;
+      event.render = IsSpkrRendering();
   }
 
   return MemReadFloatingBus(nExecutedCycles);
@@ -445,6 +555,18 @@ BYTE __stdcall SpkrToggle (WORD, WORD, BYTE, BYTE, ULONG nExecutedCycles)
 
 //=============================================================================
 
+// Called by the SAM card's 8-bit DAC, after SpkrToggle() has logged the access
+void SpkrSetDACLevel(short level)
+{
+	if (!g_nSpkrEvents)
+		return;
+
+	g_spkrEvents[g_nSpkrEvents - 1].level = level;
+	g_nSpkrToggleLevel = level;
+}
+
+//=============================================================================
+
 // Called by ContinueExecution()
 void SpkrUpdate (uint32_t totalcycles)
 {
@@ -452,6 +574,7 @@ void SpkrUpdate (uint32_t totalcycles)
 	extern UINT64 g_timeSpeaker;
 	PerfMarker perfMarker(g_timeSpeaker);
 #endif
+	PERF_SCOPE(PERF_SPEAKER_NS);
 
   if(!g_bSpkrToggleFlag)
   {
@@ -1017,6 +1140,9 @@ static const std::string& SpkrGetSnapshotStructName(void)
 
 void SpkrSaveSnapshot(YamlSaveHelper& yamlSaveHelper)
 {
+	if (soundtype == SOUND_WAVE)
+		RenderSpkrEvents();
+
 	YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", SpkrGetSnapshotStructName().c_str());
 	yamlSaveHelper.SaveHexUint64(SS_YAML_KEY_LASTCYCLE, g_nSpkrLastCycle);
 }
@@ -1026,7 +1152,9 @@ void SpkrLoadSnapshot(YamlLoadHelper& yamlLoadHelper)
 	if (!yamlLoadHelper.GetSubMap(SpkrGetSnapshotStructName()))
 		return;
 
+	DiscardSpkrEvents();
 	g_nSpkrLastCycle = yamlLoadHelper.LoadUint64(SS_YAML_KEY_LASTCYCLE);
+	ResetBlep(g_nSpkrLastCycle);
 
 	yamlLoadHelper.PopMap();
 }
@@ -15,7 +15,6 @@ enum SoundType_e
 extern SoundType_e soundtype;
 extern double     g_fClksPerSpkrSample;
 extern bool       g_bQuieterSpeaker;
-extern short      g_nSpeakerData;
 
 void    SpkrDestroy ();
 void    SpkrInitialize ();
@@ -24,6 +23,7 @@ void    SpkrReset();
 void    SpkrSetEmulationType (SoundType_e newSoundType);
 void    SpkrUpdate (uint32_t);
 void    SpkrUpdate_Timer();
+void    SpkrSetDACLevel(short level);
 uint32_t   SpkrGetVolume();
 void    SpkrSetVolume(uint32_t dwVolume, uint32_t dwVolumeMax);
 void    Spkr_Mute();
@@ -24,7 +24,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 /* Description: Synchronous Event Manager
  *
  * This manager class maintains a linked-list of ordered timer-based event,
- * where only the head of the list needs updating after every opcode.
+ * where only the head of the list needs updating.
+ *
+ * The CPU doesn't update the head after every opcode: it runs until the head is due
+ * (see GetNextEventCycles()), and then applies all the cycles executed since the last update.
  *
  * The Nth event in the list will expire in: event[1] + ... + event[N] cycles time.
  * (So each event has a cycle delta expiry time relative to the previous event.)
@@ -44,7 +47,34 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "SynchronousEventManager.h"
 #include "CPU.h"
 
+// Apply the cycles executed since the head was last updated, so that events are inserted/removed relative to the current opcode
+// NB. Expiry is only handled by Update(), when the CPU reaches m_nextEventCycles
+void SynchronousEventManager::SyncToNow(void)
+{
+	if (m_syncEventHead)
+		m_syncEventHead->m_cyclesRemaining -= (int)(m_cyclesNow - m_cyclesSynced);
+
+	m_cyclesSynced = m_cyclesNow;
+}
+
+void SynchronousEventManager::UpdateNextEventCycles(void)
+{
+	if (!m_syncEventHead)
+		m_nextEventCycles = kNoEventCycles;
+	else if (m_syncEventHead->m_cyclesRemaining <= 0)
+		m_nextEventCycles = m_cyclesSynced;	// due now
+	else
+		m_nextEventCycles = m_cyclesSynced + m_syncEventHead->m_cyclesRemaining;
+}
+
 void SynchronousEventManager::Insert(SyncEvent* pNewEvent)
+{
+	SyncToNow();
+	InsertInternal(pNewEvent);
+	UpdateNextEventCycles();
+}
+
+void SynchronousEventManager::InsertInternal(SyncEvent* pNewEvent)
 {
 	pNewEvent->m_active = true;	// add always succeeds
 
@@ -99,6 +129,14 @@ void SynchronousEventManager::Insert(SyncEvent* pNewEvent)
 }
 
 bool SynchronousEventManager::Remove(int id)
+{
+	SyncToNow();
+	const bool res = RemoveInternal(id);
+	UpdateNextEventCycles();
+	return res;
+}
+
+bool SynchronousEventManager::RemoveInternal(int id)
 {
 	SyncEvent* pPrevEvent = NULL;
 	SyncEvent* pCurrEvent = m_syncEventHead;
@@ -136,7 +174,29 @@ bool SynchronousEventManager::Remove(int id)
 	return false;
 }
 
-void SynchronousEventManager::Update(int cycles, ULONG uExecutedCycles)
+void SynchronousEventManager::UpdateExpired(SyncEvent* pCurrEvent, int cycles, ULONG uExecutedCycles)
+{
+	_ASSERT(pCurrEvent == m_syncEventHead && pCurrEvent->m_cyclesRemaining <= 0);
+
+	if (pCurrEvent->m_cyclesRemaining == 0 && pCurrEvent->m_canAssertIRQ)
+		SetIrqOnLastOpcodeCycle();		// IRQ occurs on last cycle of opcode
+
+	int cyclesUnderflowed = -pCurrEvent->m_cyclesRemaining;
+
+	pCurrEvent->m_cyclesRemaining = pCurrEvent->m_callback(pCurrEvent->m_id, cycles, uExecutedCycles);
+	m_syncEventHead = pCurrEvent->m_next;	// unlink this event
+
+	pCurrEvent->m_active = false;
+	pCurrEvent->m_next = NULL;
+
+	// Always Update even if cyclesUnderflowed=0, as next event may have cycleRemaining=0 (ie. the 2 events fire at the same time)
+	UpdateHead(cyclesUnderflowed, uExecutedCycles);	// update (potential) next event with underflow cycles
+
+	if (pCurrEvent->m_cyclesRemaining)
+		InsertInternal(pCurrEvent);	// re-add event
+}
+
+void SynchronousEventManager::UpdateHead(int cycles, ULONG uExecutedCycles)
 {
 	SyncEvent* pCurrEvent = m_syncEventHead;
 
@@ -145,22 +205,29 @@ void SynchronousEventManager::Update(int cycles, ULONG uExecutedCycles)
 
 	pCurrEvent->m_cyclesRemaining -= cycles;
 	if (pCurrEvent->m_cyclesRemaining <= 0)
-	{
-		if (pCurrEvent->m_cyclesRemaining == 0 && pCurrEvent->m_canAssertIRQ)
-			SetIrqOnLastOpcodeCycle();		// IRQ occurs on last cycle of opcode
+		UpdateExpired(pCurrEvent, cycles, uExecutedCycles);
+}
 
-		int cyclesUnderflowed = -pCurrEvent->m_cyclesRemaining;
+// Called by the CPU at the end of the opcode where uExecutedCycles reaches GetNextEventCycles()
+// . cycles: the cycles for this last opcode (passed to the expired event's callback)
+void SynchronousEventManager::Update(int cycles, ULONG uExecutedCycles)
+{
+	m_cyclesNow = uExecutedCycles;
+	SyncToNow();	// NB. before any callbacks, as they may insert/remove events
 
-		pCurrEvent->m_cyclesRemaining = pCurrEvent->m_callback(pCurrEvent->m_id, cycles, uExecutedCycles);
-		m_syncEventHead = pCurrEvent->m_next;	// unlink this event
+	SyncEvent* pCurrEvent = m_syncEventHead;
+	if (pCurrEvent && pCurrEvent->m_cyclesRemaining <= 0)
+		UpdateExpired(pCurrEvent, cycles, uExecutedCycles);
 
-		pCurrEvent->m_active = false;
-		pCurrEvent->m_next = NULL;
+	UpdateNextEventCycles();
+}
 
-		// Always Update even if cyclesUnderflowed=0, as next event may have cycleRemaining=0 (ie. the 2 events fire at the same time)
-		Update(cyclesUnderflowed, uExecutedCycles);	// update (potential) next event with underflow cycles
+// Called at the end of CpuExecute(): the next CpuExecute()'s uExecutedCycles start from 0 again
+void SynchronousEventManager::EndExecute(ULONG uExecutedCycles)
+{
+	m_cyclesNow = uExecutedCycles;
+	SyncToNow();
 
-		if (pCurrEvent->m_cyclesRemaining)
-			Insert(pCurrEvent);	// re-add event
-	}
+	m_cyclesSynced = m_cyclesNow = 0;
+	UpdateNextEventCycles();
 }
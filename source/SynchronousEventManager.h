@@ -2,10 +2,17 @@
 
 class SyncEvent;
 
+// SyncEvent IDs must be unique:
+// . slot based IDs (eg. slot#, or (slot#<<4)+n for Mockingboard) are < SYNC_EVENT_ID_NON_SLOT
+// . other IDs are allocated here
+const int SYNC_EVENT_ID_NON_SLOT = 0x100;
+const int SYNC_EVENT_ID_INPUT_RECORDER = SYNC_EVENT_ID_NON_SLOT + 0;
+const int SYNC_EVENT_ID_PROFILE_SAMPLE = SYNC_EVENT_ID_NON_SLOT + 1;
+
 class SynchronousEventManager
 {
 public:
-	SynchronousEventManager() : m_syncEventHead(NULL)
+	SynchronousEventManager() : m_syncEventHead(NULL), m_cyclesSynced(0), m_cyclesNow(0), m_nextEventCycles(kNoEventCycles)
 	{}
 	~SynchronousEventManager(){}
 
@@ -14,11 +21,31 @@ public:
 
 	void Insert(SyncEvent* pNewEvent);
 	bool Remove(int id);
+	void Reset(void) { m_syncEventHead = NULL; m_cyclesSynced = m_cyclesNow = 0; m_nextEventCycles = kNoEventCycles; }
+
+	// CPU interface - uExecutedCycles are the cycles executed so far in the current CpuExecute():
+	// . the CPU runs opcodes until uExecutedCycles reaches GetNextEventCycles(), and only then calls Update()
+	// . I/O accesses call SetCyclesNow(), so that events inserted/removed by I/O handlers are relative to the current opcode
+	// . EndExecute() rebases the list for the next CpuExecute()
+	ULONG GetNextEventCycles(void) const { return m_nextEventCycles; }
+	void SetCyclesNow(ULONG uExecutedCycles) { m_cyclesNow = uExecutedCycles; }
 	void Update(int cycles, ULONG uExecutedCycles);
-	void Reset(void) { m_syncEventHead = NULL; }
+	void EndExecute(ULONG uExecutedCycles);
 
 private:
+	void InsertInternal(SyncEvent* pNewEvent);
+	bool RemoveInternal(int id);
+	void SyncToNow(void);
+	void UpdateHead(int cycles, ULONG uExecutedCycles);
+	void UpdateExpired(SyncEvent* pCurrEvent, int cycles, ULONG uExecutedCycles);
+	void UpdateNextEventCycles(void);
+
+	static const ULONG kNoEventCycles = ~(ULONG)0;
+
 	SyncEvent* m_syncEventHead;
+	ULONG m_cyclesSynced;		// the head's m_cyclesRemaining is relative to this
+	ULONG m_cyclesNow;
+	ULONG m_nextEventCycles;	// m_cyclesSynced + the head's m_cyclesRemaining
 };
 
 //
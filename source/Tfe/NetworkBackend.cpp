@@ -20,7 +20,58 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "StdAfx.h"
 #include "NetworkBackend.h"
+#include "../CPU.h"
 
 NetworkBackend::~NetworkBackend()
 {
 }
+
+bool HostPollTimer::isDue()
+{
+	// ~250us at 1MHz: poll at most once per period of emulated cycles
+	const uint64_t kPeriodCycles = 256;
+
+	const uint64_t period = g_nCumulativeCycles / kPeriodCycles;
+	if (period == m_lastPeriod)
+		return false;
+	m_lastPeriod = period;
+	return true;
+}
+
+FrameQueue::FrameQueue(const size_t capacity)
+	: m_frames(capacity)
+	, m_head(0)
+	, m_count(0)
+{
+}
+
+bool FrameQueue::push(const uint8_t * frame, const int length)
+{
+	if (m_count == m_frames.size())
+		return false;
+
+	Frame & slot = m_frames[(m_head + m_count) % m_frames.size()];
+	slot.length = std::min(length, MAX_RXLENGTH);
+	memcpy(slot.data, frame, slot.length);
+	++m_count;
+	return true;
+}
+
+int FrameQueue::pop(const int size, uint8_t * rxframe)
+{
+	if (m_count == 0)
+		return -1;
+
+	const Frame & slot = m_frames[m_head];
+	int received = std::min(slot.length, size);
+	memcpy(rxframe, slot.data, received);
+	if ((received & 1) && received < size)
+	{
+		rxframe[received] = 0;
+		++received;
+	}
+
+	m_head = (m_head + 1) % m_frames.size();
+	--m_count;
+	return received;
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+#include <cstdint>
+
 #define MAX_TXLENGTH 1518
 #define MIN_TXLENGTH 4
 
@@ -14,6 +17,47 @@ struct MACAddress
 };
 #pragma pack(pop)
 
+// A bounded FIFO of received frames, owned by each backend (so one per card).
+// update() drains everything the host has pending into it in one pass, and receive() pops from it
+// without any further host calls. Frames arriving while it is full are dropped (as a real NIC would).
+class FrameQueue
+{
+public:
+	FrameQueue(const size_t capacity = 64);
+
+	bool push(const uint8_t * frame, const int length);
+	int pop(const int size, uint8_t * rxframe);		// size (>0) or missing (-1), padded to an even length
+
+	size_t available() const { return m_frames.size() - m_count; }
+	bool empty() const { return m_count == 0; }
+	void clear() { m_head = m_count = 0; }
+
+private:
+	struct Frame
+	{
+		int length;
+		uint8_t data[MAX_RXLENGTH];
+	};
+
+	std::vector<Frame> m_frames;
+	size_t m_head;
+	size_t m_count;
+};
+
+// Limits how often a backend polls the host. This counts emulated cycles, not wall time, so the host
+// is polled at the same cycles whatever the host speed, as well as in a recording and in its replay.
+// At normal speed this is once per CPU batch (1ms).
+class HostPollTimer
+{
+public:
+	HostPollTimer() : m_lastPeriod(UINT64_MAX) {}
+
+	bool isDue();
+
+private:
+	uint64_t m_lastPeriod;
+};
+
 class NetworkBackend
 {
 public:
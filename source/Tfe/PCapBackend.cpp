@@ -53,14 +53,7 @@ void PCapBackend::transmit(
 
 int PCapBackend::receive(const int size, uint8_t * rxframe)
 {
-    if (m_tfePcapFP)
-    {
-        return tfe_arch_receive(m_tfePcapFP, size, rxframe);
-    }
-    else
-    {
-        return -1;
-    }
+    return m_queue.pop(size, rxframe);
 }
 
 bool PCapBackend::isValid()
@@ -68,9 +61,20 @@ bool PCapBackend::isValid()
     return m_tfePcapFP;
 }
 
+static void PCapQueueFrame(void * param, const BYTE * frame, const int length)
+{
+    FrameQueue * queue = reinterpret_cast<FrameQueue *>(param);
+    queue->push(frame, length);
+}
+
 void PCapBackend::update(const ULONG /* nExecutedCycles */)
 {
-    // nothing to do
+    // only ask for what fits: the rest stays in the capture buffer until the guest catches up
+    const int maxFrames = static_cast<int>(m_queue.available());
+    if (m_tfePcapFP && maxFrames > 0 && m_pollTimer.isDue())
+    {
+        tfe_arch_receive_frames(m_tfePcapFP, maxFrames, PCapQueueFrame, &m_queue);
+    }
 }
 
 void PCapBackend::getMACAddress(const uint32_t address, MACAddress & mac)
@@ -26,7 +26,7 @@ public:
 	// receive all pending packets (to the queue)
 	virtual void update(const ULONG nExecutedCycles);
 
-	// process pending packets
+	// if the backend is usable
 	virtual bool isValid();
 
 	// get MAC for IPRAW (it is only supposed to handle addresses on the local network)
@@ -69,4 +69,6 @@ public:
 private:
 	const std::string m_interfaceName;
 	pcap_t * m_tfePcapFP;
+	FrameQueue m_queue;
+	HostPollTimer m_pollTimer;
 };
@@ -574,6 +574,42 @@ int tfe_arch_receive(pcap_t * TfePcapFP,
     return -1;
 }
 
+typedef struct TFE_PCAP_FRAMES_tag {
+    tfe_arch_frame_handler_t handler;
+    void *param;
+
+} TFE_PCAP_FRAMES;
+
+static
+void TfePcapFramesHandler(u_char *param, const struct pcap_pkthdr *header, const u_char *pkt_data)
+{
+    TFE_PCAP_FRAMES *pframes = (TFE_PCAP_FRAMES *)param;
+    pframes->handler(pframes->param, pkt_data, header->caplen);
+}
+
+/*
+  tfe_arch_receive_frames()
+
+  Drains up to maxframes frames in a single pcap_dispatch() call (which, on Linux,
+  walks libpcap's memory-mapped TPACKET ring), rather than one call per frame.
+*/
+int tfe_arch_receive_frames(pcap_t * TfePcapFP,
+                            const int maxframes,
+                            tfe_arch_frame_handler_t handler,
+                            void *param
+                           )
+{
+    TFE_PCAP_FRAMES frames = { handler, param };
+
+    const int ret = (*p_pcap_dispatch)(TfePcapFP, maxframes, TfePcapFramesHandler, (u_char*)&frames);
+
+#ifdef TFE_DEBUG_ARCH
+    if(g_fh) fprintf( g_fh, "tfe_arch_receive_frames() called, returns %d.\n", ret );
+#endif
+
+    return ret < 0 ? -1 : ret;
+}
+
 const char * tfe_arch_lib_version()
 {
     if (!TfePcapLoadLibrary())
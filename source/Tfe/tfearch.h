@@ -64,6 +64,16 @@ int tfe_arch_receive(pcap_t * TfePcapFP,
                      BYTE *pbuffer       /* where to store a frame */
                     );
 
+typedef void (*tfe_arch_frame_handler_t)(void *param, const BYTE *frame, const int length);
+
+/* hand up to maxframes pending frames to handler, return their number, or -1 */
+extern
+int tfe_arch_receive_frames(pcap_t * TfePcapFP,
+                            const int maxframes,                 /* Maximum number of frames */
+                            tfe_arch_frame_handler_t handler,    /* Called for every frame */
+                            void *param
+                           );
+
 extern int tfe_arch_is_npcap_loaded();
 extern int tfe_arch_enumadapter_open(void);
 extern int tfe_arch_enumadapter(std::string & name, std::string & description);
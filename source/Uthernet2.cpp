@@ -73,11 +73,15 @@ typedef int socklen_t;
 #include <sys/types.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
-#include <poll.h>
+#include <sys/select.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
 #endif
 
 // Dest MAC + Source MAC + Ether Type
@@ -94,6 +98,7 @@ typedef int socklen_t;
 
 #include "Memory.h"
 #include "Log.h"
+#include "CPU.h"
 
 namespace
 {
@@ -179,6 +184,188 @@ namespace
         writeData(socket, memory, data, len);
     }
 
+    // The TCP & UDP sockets of all Uthernet II cards are polled together, with one syscall per Update() (epoll on Linux, else select)
+    // . a socket is only read once it has been reported readable, and until a read finds it empty
+    //   (so the guest polling its RX size register doesn't cost a recv() each time)
+    // . a connecting socket is only checked once it has been reported writable
+    class SocketPoller
+    {
+    public:
+        SocketPoller();
+
+        void add(const Socket::socket_t fd);
+        void remove(const Socket::socket_t fd);
+        void setConnecting(const Socket::socket_t fd, const bool connecting);
+        void poll();
+
+        bool isReadable(const Socket::socket_t fd) const;
+        bool isWritable(const Socket::socket_t fd) const;
+        void clearReadable(const Socket::socket_t fd);
+
+    private:
+        struct State
+        {
+            bool connecting;
+            bool readable;
+            bool writable;
+        };
+
+        std::map<Socket::socket_t, State> myStates;
+        unsigned __int64 myLastPollCycles;
+
+#ifdef __linux__
+        void control(const int op, const Socket::socket_t fd, const bool connecting);
+
+        int myEpollFD;
+#endif
+    };
+
+    SocketPoller::SocketPoller()
+        : myLastPollCycles(0)
+#ifdef __linux__
+        , myEpollFD(epoll_create1(EPOLL_CLOEXEC))
+#endif
+    {
+    }
+
+    void SocketPoller::add(const Socket::socket_t fd)
+    {
+        const State state = {false, false, false};
+        myStates[fd] = state;
+#ifdef __linux__
+        control(EPOLL_CTL_ADD, fd, false);
+#endif
+    }
+
+    void SocketPoller::remove(const Socket::socket_t fd)
+    {
+        if (myStates.erase(fd))
+        {
+#ifdef __linux__
+            control(EPOLL_CTL_DEL, fd, false);
+#endif
+        }
+    }
+
+    void SocketPoller::setConnecting(const Socket::socket_t fd, const bool connecting)
+    {
+        const std::map<Socket::socket_t, State>::iterator it = myStates.find(fd);
+        if (it != myStates.end() && it->second.connecting != connecting)
+        {
+            it->second.connecting = connecting;
+            it->second.writable = false;
+#ifdef __linux__
+            control(EPOLL_CTL_MOD, fd, connecting);
+#endif
+        }
+    }
+
+#ifdef __linux__
+    void SocketPoller::control(const int op, const Socket::socket_t fd, const bool connecting)
+    {
+        epoll_event event = {};
+        event.events = connecting ? EPOLLOUT : EPOLLIN;
+        event.data.fd = fd;
+        if (myEpollFD >= 0 && epoll_ctl(myEpollFD, op, fd, &event) < 0)
+        {
+#ifdef U2_LOG_STATE
+            LogFileOutput("U2: epoll_ctl(%d) error %" ERROR_FMT "\n", op, STRERROR(sock_error()));
+#endif
+        }
+    }
+#endif
+
+    void SocketPoller::poll()
+    {
+        // once for all cards, and not at all if there are no sockets
+        if (myStates.empty() || myLastPollCycles == g_nCumulativeCycles)
+            return;
+        myLastPollCycles = g_nCumulativeCycles;
+
+#ifdef __linux__
+        if (myEpollFD < 0)
+        {
+            // no epoll: just try every socket
+            for (std::map<Socket::socket_t, State>::iterator it = myStates.begin(); it != myStates.end(); ++it)
+                it->second.readable = it->second.writable = true;
+            return;
+        }
+
+        epoll_event events[64];
+        const int count = epoll_wait(myEpollFD, events, 64, 0);
+        for (int i = 0; i < count; ++i)
+        {
+            const std::map<Socket::socket_t, State>::iterator it = myStates.find(events[i].data.fd);
+            if (it != myStates.end())
+            {
+                // errors & hang-ups are picked up by the recv() or getsockopt()
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                    it->second.readable = true;
+                if (events[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+                    it->second.writable = true;
+            }
+        }
+#else
+        fd_set readfds, writefds, exceptfds;
+        FD_ZERO(&readfds);
+        FD_ZERO(&writefds);
+        FD_ZERO(&exceptfds);
+
+        Socket::socket_t maxFD = 0;
+        for (std::map<Socket::socket_t, State>::const_iterator it = myStates.begin(); it != myStates.end(); ++it)
+        {
+            if (it->second.connecting)
+            {
+                FD_SET(it->first, &writefds);
+                FD_SET(it->first, &exceptfds);
+            }
+            else
+            {
+                FD_SET(it->first, &readfds);
+            }
+            maxFD = std::max(maxFD, it->first);
+        }
+
+        timeval timeout = {0, 0}; // non const for old versions of msys2 / mxe
+        if (select((int)maxFD + 1, &readfds, &writefds, &exceptfds, &timeout) > 0)
+        {
+            for (std::map<Socket::socket_t, State>::iterator it = myStates.begin(); it != myStates.end(); ++it)
+            {
+                if (FD_ISSET(it->first, &readfds))
+                    it->second.readable = true;
+                if (FD_ISSET(it->first, &writefds) || FD_ISSET(it->first, &exceptfds))
+                    it->second.writable = true;
+            }
+        }
+#endif
+    }
+
+    bool SocketPoller::isReadable(const Socket::socket_t fd) const
+    {
+        const std::map<Socket::socket_t, State>::const_iterator it = myStates.find(fd);
+        return it != myStates.end() && it->second.readable;
+    }
+
+    bool SocketPoller::isWritable(const Socket::socket_t fd) const
+    {
+        const std::map<Socket::socket_t, State>::const_iterator it = myStates.find(fd);
+        return it != myStates.end() && it->second.writable;
+    }
+
+    void SocketPoller::clearReadable(const Socket::socket_t fd)
+    {
+        const std::map<Socket::socket_t, State>::iterator it = myStates.find(fd);
+        if (it != myStates.end())
+            it->second.readable = false;
+    }
+
+    SocketPoller &getSocketPoller()
+    {
+        // never deleted, as Sockets can still be destroyed during static destruction
+        static SocketPoller *poller = new SocketPoller();
+        return *poller;
+    }
+
 }
 
 Socket::Socket()
@@ -199,6 +386,7 @@ void Socket::clearFD()
 {
     if (myFD != INVALID_SOCKET)
     {
+        getSocketPoller().remove(myFD);
 #ifdef _WIN32
         closesocket(myFD);
 #else
@@ -213,6 +401,11 @@ void Socket::setStatus(const uint8_t status)
 {
     mySocketStatus = status;
 
+    if (myFD != INVALID_SOCKET)
+    {
+        getSocketPoller().setConnecting(myFD, mySocketStatus == W5100_SN_SR_SOCK_SYNSENT);
+    }
+
     switch (mySocketStatus)
     {
     case W5100_SN_SR_ESTABLISHED:
@@ -237,6 +430,7 @@ void Socket::setFD(const socket_t fd, const uint8_t status)
 {
     clearFD();
     myFD = fd;
+    getSocketPoller().add(myFD);
     setStatus(status);
 }
 
@@ -268,20 +462,10 @@ bool Socket::isOpen() const
 
 void Socket::process()
 {
+    // NB. SocketPoller::poll() has already been called
     if (myFD != INVALID_SOCKET && mySocketStatus == W5100_SN_SR_SOCK_SYNSENT)
     {
-#ifdef _WIN32
-        FD_SET writefds, exceptfds;
-        FD_ZERO(&writefds);
-        FD_ZERO(&exceptfds);
-        FD_SET(myFD, &writefds);
-        FD_SET(myFD, &exceptfds);
-        timeval timeout = {0, 0}; // non const for old versions of msys2 / mxe
-        if (select(0, NULL, &writefds, &exceptfds, &timeout) > 0)
-#else
-        pollfd pfd = {.fd = myFD, .events = POLLOUT};
-        if (poll(&pfd, 1, 0) > 0)
-#endif
+        if (getSocketPoller().isWritable(myFD))
         {
             int err = 0;
             socklen_t elen = sizeof(err);
@@ -701,7 +885,7 @@ void Uthernet2::receiveOnePacketIPRaw(const size_t i, const size_t lengthOfPaylo
 void Uthernet2::receiveOnePacketFromSocket(const size_t i)
 {
     Socket &socket = mySockets[i];
-    if (socket.isOpen())
+    if (socket.isOpen() && getSocketPoller().isReadable(socket.getFD()))
     {
         const uint16_t freeRoom = socket.getFreeRoom();
         if (freeRoom > 32) // avoid meaningless reads
@@ -715,6 +899,11 @@ void Uthernet2::receiveOnePacketFromSocket(const size_t i)
 #endif
             if (data > 0)
             {
+                if (socket.getStatus() == W5100_SN_SR_ESTABLISHED && size_t(data) < buffer.size())
+                {
+                    // stream socket is now empty (else it will be reported again by the next poll)
+                    getSocketPoller().clearReadable(socket.getFD());
+                }
                 writeDataForProtocol(socket, myMemory, buffer.data(), data, source);
 #ifdef U2_LOG_TRAFFIC
                 LogFileOutput("U2: Read %s[%" SIZE_T_FMT "]: +%d+%" SIZE_T_FMT " -> %d bytes\n", proto, i, socket.getHeaderSize(),
@@ -729,7 +918,11 @@ void Uthernet2::receiveOnePacketFromSocket(const size_t i)
             else // data < 0;
             {
                 const int error = sock_error();
-                if (error != SOCK_EAGAIN && error != SOCK_EWOULDBLOCK)
+                if (error == SOCK_EAGAIN || error == SOCK_EWOULDBLOCK)
+                {
+                    getSocketPoller().clearReadable(socket.getFD());
+                }
+                else
                 {
 #ifdef U2_LOG_TRAFFIC
                     LogFileOutput("U2: %s[%" SIZE_T_FMT "]: recvfrom error %" ERROR_FMT "\n", proto, i, STRERROR(error));
@@ -1526,9 +1719,11 @@ void Uthernet2::getMACAddress(const uint32_t address, const MACAddress * & mac)
 void Uthernet2::Update(const ULONG nExecutedCycles)
 {
     myNetworkBackend->update(nExecutedCycles);
-    for (Socket &socket : mySockets)
+    getSocketPoller().poll();
+    for (size_t i = 0; i < mySockets.size(); ++i)
     {
-        socket.process();
+        mySockets[i].process();
+        receiveOnePacketFromSocket(i);  // receive into the RX buffer as soon as data is ready (not only when the guest reads the RX size)
     }
 }
 
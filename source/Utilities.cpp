@@ -325,6 +325,10 @@ void LoadConfiguration(bool loadImages)
 	REGLOAD_DEFAULT(REGVALUE_ENHANCE_DISK_SPEED, &dwEnhanceDisk, 1);
 	GetCardMgr().GetDisk2CardMgr().SetEnhanceDisk(dwEnhanceDisk ? true : false);
 
+	uint32_t dwFastDisk;
+	REGLOAD_DEFAULT(REGVALUE_FAST_DISK, &dwFastDisk, 0);
+	GetCardMgr().GetDisk2CardMgr().SetFastDisk(dwFastDisk ? true : false);
+
 	//
 
 	if (GetCardMgr().IsParallelPrinterCardInstalled())
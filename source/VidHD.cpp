@@ -127,24 +127,126 @@ bgra_t ConvertIIgs2RGB(Color color)
 	return rgb;
 }
 
-void VidHDCard::UpdateSHRCell(bool is640Mode, bool isColorFillMode, uint16_t addrPalette, bgra_t* pVideoAddress, uint32_t a)
+// SHR render cache:
+// . Each palette is converted to RGB once, and only reconverted when its 32 bytes in aux $9E00-$9FFF change.
+// . Each line remembers its SCB, which converted palette it was drawn with, and the 4 bytes drawn in each cell.
+//   A cell whose bytes are unchanged (and whose line's SCB & palette are unchanged) is already in the framebuffer, so is skipped.
+// . The SCB & palette are latched at the start of each line (as the IIgs VGC does during horizontal blanking).
+// . InvalidateSHRCache() must be called whenever the framebuffer is drawn by anything else (eg. another video mode, or cleared).
+
+static const UINT kSHRLines = 200;
+static const UINT kSHRCellsPerLine = 40;	// 160 bytes per line, 4 bytes per cell
+static const UINT kSHRNumPalettes = 16;
+static const UINT kSHRPaletteSize = 16 * sizeof(Color);
+
+struct SHRPalette
 {
+	BYTE raw[kSHRPaletteSize];
+	bgra_t rgb[16];
+	UINT generation;	// 0 = not converted yet
+};
+
+struct SHRLine
+{
+	uint32_t cells[kSHRCellsPerLine];
+	uint64_t drawnCells;	// bitmap of the cells drawn with this SCB & palette
+	BYTE scb;
+	UINT paletteGeneration;
+};
+
+static SHRPalette g_shrPalettes[kSHRNumPalettes];
+static SHRLine g_shrLines[kSHRLines];
+static UINT g_shrPaletteGeneration = 0;
+
+static UINT g_shrCurrLine = kSHRLines;		// the line latched
+static UINT g_shrCurrCell = 0;
+static const SHRPalette* g_shrCurrPalette = NULL;
+static bool g_shrCurrLineCached = false;
+static bool g_shrNextLineCached = false;	// false after an invalidate (eg. just switched to SHR, so the video address of this line was setup by the previous mode)
+static bool g_shrPrevCellSkipped = false;
+
+void VidHDCard::InvalidateSHRCache(void)
+{
+	for (UINT line = 0; line < kSHRLines; line++)
+		g_shrLines[line].drawnCells = 0;
+	g_shrCurrLine = kSHRLines;
+	g_shrNextLineCached = false;
+}
+
+static void LatchSHRLine(const UINT line, const UINT cell)
+{
+	const BYTE scb = *MemGetAuxPtr(0x9D00 + line);	// scan-line control byte
+	const UINT paletteSelectCode = scb & 0xf;
+
+	SHRPalette& palette = g_shrPalettes[paletteSelectCode];
+	const BYTE* pRaw = MemGetAuxPtr(0x9E00 + paletteSelectCode * kSHRPaletteSize);
+	if (palette.generation == 0 || memcmp(palette.raw, pRaw, kSHRPaletteSize) != 0)
+	{
+		memcpy(palette.raw, pRaw, kSHRPaletteSize);
+		const Color* pColors = (const Color*) palette.raw;
+		for (UINT i = 0; i < 16; i++)
+			palette.rgb[i] = ConvertIIgs2RGB(pColors[i]);
+		palette.generation = ++g_shrPaletteGeneration;
+	}
+
+	SHRLine& cache = g_shrLines[line];
+	g_shrCurrLineCached = (cell == 0) && g_shrNextLineCached;	// only cache lines drawn from their 1st cell
+	g_shrNextLineCached = true;
+	if (cache.scb != scb || cache.paletteGeneration != palette.generation || !g_shrCurrLineCached)
+	{
+		cache.drawnCells = 0;
+		cache.scb = scb;
+		cache.paletteGeneration = palette.generation;
+	}
+
+	g_shrCurrLine = line;
+	g_shrCurrPalette = &palette;
+	g_shrPrevCellSkipped = true;
+}
+
+void VidHDCard::UpdateSHRCell(bgra_t* pVideoAddress, uint32_t a, UINT line, UINT cell)
+{
+	_ASSERT(line < kSHRLines && cell < kSHRCellsPerLine);
+
+	if (line != g_shrCurrLine || cell <= g_shrCurrCell)
+		LatchSHRLine(line, cell);
+	g_shrCurrCell = cell;
+
+	SHRLine& cache = g_shrLines[line];
+	const bool is640Mode = !!(cache.scb & 0x80);
+	const bool isColorFillMode = !!(cache.scb & 0x20);
+	const uint64_t cellBit = (uint64_t)1 << cell;
+
+	// In color-fill mode a cell depends on the last pixel of the previous cell, so can only be skipped if that one was too
+	if ((cache.drawnCells & cellBit) && cache.cells[cell] == a && (!isColorFillMode || g_shrPrevCellSkipped))
+	{
+		g_shrPrevCellSkipped = true;
+		return;
+	}
+
+	if (g_shrCurrLineCached)
+	{
+		cache.cells[cell] = a;
+		cache.drawnCells |= cellBit;
+	}
+	g_shrPrevCellSkipped = false;
+
 	_ASSERT(!is640Mode);		// to do: test this mode
 
-	Color* palette = (Color*) MemGetAuxPtr(addrPalette);
+	const bgra_t* palette = g_shrCurrPalette->rgb;
 
 	for (UINT i = 0; i < 4; i++)
 	{
 		if (!is640Mode) // 320 mode
 		{
 			BYTE pixel1 = (a >> 4) & 0xf;
-			bgra_t color1 = ConvertIIgs2RGB(palette[pixel1]);
+			bgra_t color1 = palette[pixel1];
 			if (isColorFillMode && pixel1 == 0) color1 = *(pVideoAddress - 1);
 			*pVideoAddress++ = color1;
 			*pVideoAddress++ = color1;
 
 			BYTE pixel2 = a & 0xf;
-			bgra_t color2 = ConvertIIgs2RGB(palette[pixel2]);
+			bgra_t color2 = palette[pixel2];
 			if (isColorFillMode && pixel2 == 0) color2 = color1;
 			*pVideoAddress++ = color2;
 			*pVideoAddress++ = color2;
@@ -152,20 +254,16 @@ void VidHDCard::UpdateSHRCell(bool is640Mode, bool isColorFillMode, uint16_t add
 		else // 640 mode - see IIgs Hardware Ref, Pg.96, Table4-21 'Color Selection in 640 mode'
 		{
 			BYTE pixel1 = (a >> 6) & 0x3;
-			bgra_t color1 = ConvertIIgs2RGB(palette[0x8 + pixel1]);
-			*pVideoAddress++ = color1;
+			*pVideoAddress++ = palette[0x8 + pixel1];
 
 			BYTE pixel2 = (a >> 4) & 0x3;
-			bgra_t color2 = ConvertIIgs2RGB(palette[0xC + pixel2]);
-			*pVideoAddress++ = color2;
+			*pVideoAddress++ = palette[0xC + pixel2];
 
 			BYTE pixel3 = (a >> 2) & 0x3;
-			bgra_t color3 = ConvertIIgs2RGB(palette[0x0 + pixel3]);
-			*pVideoAddress++ = color3;
+			*pVideoAddress++ = palette[0x0 + pixel3];
 
 			BYTE pixel4 = a & 0x3;
-			bgra_t color4 = ConvertIIgs2RGB(palette[0x4 + pixel4]);
-			*pVideoAddress++ = color4;
+			*pVideoAddress++ = palette[0x4 + pixel4];
 		}
 
 		a >>= 8;
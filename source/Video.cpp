@@ -871,6 +871,7 @@ void Video::ClearFrameBuffer(void)
 {
 	UINT32* frameBuffer = (UINT32*)GetFrameBuffer();
 	std::fill(frameBuffer, frameBuffer + GetFrameBufferWidth() * GetFrameBufferHeight(), OPAQUE_BLACK);
+	VidHDCard::InvalidateSHRCache();
 }
 
 // Called when entering debugger, and after viewing Apple II video screen from debugger
@@ -810,6 +810,8 @@ static void RepeatInitialization(void)
 			if (g_cmdLine.useHdcFirmwareV2)
 				dynamic_cast<HarddiskInterfaceCard&>(GetCardMgr().GetRef(i)).UseHdcFirmwareV2();
 			dynamic_cast<HarddiskInterfaceCard&>(GetCardMgr().GetRef(i)).SetHdcFirmwareMode(g_cmdLine.slotInfo[i].useHdcFirmwareMode);
+			if (g_cmdLine.hddHostWriteBack)
+				dynamic_cast<HarddiskInterfaceCard&>(GetCardMgr().GetRef(i)).SetHostVolumeWriteBack(true);
 		}
 		else if (GetCardMgr().GetMockingboardCardMgr().IsMockingboard(i))
 		{
@@ -930,6 +932,9 @@ static void RepeatInitialization(void)
 	if (g_cmdLine.useAltCpuEmulation)
 		ForceAltCpuEmulation();
 
+	if (g_cmdLine.snapshotHexMemory)
+		Snapshot_SetCompressMemory(false);
+
 	if (!g_cmdLine.debuggerAutoRunScriptFilename.empty())
 		DebugSetAutoRunScript(g_cmdLine.debuggerAutoRunScriptFilename);
 
@@ -26,8 +26,73 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "YamlHelper.h"
 #include "Log.h"
 
+#include "zlib.h"
+
 #include <sstream>
 
+static const char g_base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static std::string Base64Encode(const BYTE* pSrc, const size_t size)
+{
+	std::string out;
+	out.reserve(((size + 2) / 3) * 4);
+
+	size_t i = 0;
+	for (; i + 2 < size; i += 3)
+	{
+		const UINT n = (pSrc[i] << 16) | (pSrc[i+1] << 8) | pSrc[i+2];
+		out += g_base64Chars[(n >> 18) & 0x3f];
+		out += g_base64Chars[(n >> 12) & 0x3f];
+		out += g_base64Chars[(n >> 6) & 0x3f];
+		out += g_base64Chars[n & 0x3f];
+	}
+
+	if (i < size)
+	{
+		const UINT n = (pSrc[i] << 16) | ((i + 1 < size) ? (pSrc[i+1] << 8) : 0);
+		out += g_base64Chars[(n >> 18) & 0x3f];
+		out += g_base64Chars[(n >> 12) & 0x3f];
+		out += (i + 1 < size) ? g_base64Chars[(n >> 6) & 0x3f] : '=';
+		out += '=';
+	}
+
+	return out;
+}
+
+// Returns false if the input contains an illegal character
+static bool Base64Decode(const std::string& in, std::vector<BYTE>& out)
+{
+	signed char lut[256];
+	memset(lut, -1, sizeof(lut));
+	for (int i = 0; i < 64; i++)
+		lut[(BYTE)g_base64Chars[i]] = i;
+
+	out.clear();
+	out.reserve((in.size() / 4) * 3);
+
+	UINT n = 0;
+	int bits = 0;
+	for (const char c : in)
+	{
+		if (c == '=')
+			break;
+
+		const signed char v = lut[(BYTE)c];
+		if (v < 0)
+			return false;
+
+		n = (n << 6) | v;
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			out.push_back((n >> bits) & 0xff);
+		}
+	}
+
+	return true;
+}
+
 int YamlHelper::InitParser(const char* pPathname)
 {
 	m_hFile = fopen(pPathname, "r");
@@ -272,14 +337,15 @@ void YamlHelper::MakeAsciiToHexTable(void)
 		m_AsciiToHex[i] = i - 'a' + 0xA;
 }
 
-UINT YamlHelper::LoadMemory(MapYaml& mapYaml, const LPBYTE pMemBase, const size_t kAddrSpaceSize, const UINT offset)
+UINT YamlHelper::LoadMemory(MapYaml& mapYaml, const LPBYTE pMemBase, const size_t kAddrSpaceSize, const UINT offset, const bool allowCompressed/*=false*/)
 {
 	UINT bytes = 0;
 
 	for (MapYaml::iterator it = mapYaml.begin(); it != mapYaml.end(); ++it)
 	{
 		const char* pKey = it->first.c_str();
-		UINT addr = strtoul(pKey, NULL, 16);
+		const bool isCompressed = pKey[0] == SS_YAML_MEMORY_COMPRESSED_PREFIX;
+		UINT addr = strtoul(isCompressed ? pKey + 1 : pKey, NULL, 16);
 		if (addr >= (kAddrSpaceSize + offset))
 			throw std::runtime_error("Memory: line address too big: " + it->first);
 
@@ -289,6 +355,15 @@ UINT YamlHelper::LoadMemory(MapYaml& mapYaml, const LPBYTE pMemBase, const size_
 		if (it->second.subMap)
 			throw std::runtime_error("Memory: unexpected sub-map");
 
+		if (isCompressed)
+		{
+			if (!allowCompressed)
+				throw std::runtime_error("Memory: compressed data not supported by this unit's version on line address: " + it->first);
+
+			bytes += LoadMemoryCompressed(it->first, it->second.value, pDst, pDstEnd);
+			continue;
+		}
+
 		const char* pValue = it->second.value.c_str();
 		size_t len = strlen(pValue);
 		if (len & 1)
@@ -314,6 +389,22 @@ UINT YamlHelper::LoadMemory(MapYaml& mapYaml, const LPBYTE pMemBase, const size_
 	return bytes;
 }
 
+UINT YamlHelper::LoadMemoryCompressed(const std::string& key, const std::string& value, const LPBYTE pDst, const LPBYTE pDstEnd)
+{
+	std::vector<BYTE> compressed;
+	if (!Base64Decode(value, compressed))
+		throw std::runtime_error("Memory: compressed data contains illegal character on line address: " + key);
+
+	uLongf size = pDstEnd - pDst;
+	const int res = uncompress(pDst, &size, compressed.data(), compressed.size());
+	if (res == Z_BUF_ERROR)
+		throw std::runtime_error("Memory: compressed data overflowed address space on line address: " + key);
+	if (res != Z_OK)
+		throw std::runtime_error("Memory: failed to decompress data on line address: " + key);
+
+	return size;
+}
+
 //-------------------------------------
 
 INT YamlLoadHelper::LoadInt(const std::string key)
@@ -406,9 +497,9 @@ double YamlLoadHelper::LoadDouble(const std::string& key)
 	return strtod(value.c_str(), NULL);
 }
 
-void YamlLoadHelper::LoadMemory(const LPBYTE pMemBase, const size_t size, const UINT offset/*=0*/)
+void YamlLoadHelper::LoadMemory(const LPBYTE pMemBase, const size_t size, const UINT offset/*=0*/, const bool allowCompressed/*=false*/)
 {
-	m_yamlHelper.LoadMemory(*m_pMapYaml, pMemBase, size, offset);
+	m_yamlHelper.LoadMemory(*m_pMapYaml, pMemBase, size, offset, allowCompressed);
 }
 
 void YamlLoadHelper::LoadMemory(std::vector<BYTE>& memory, const size_t size, const UINT offset/*=0*/)
@@ -543,11 +634,17 @@ void YamlSaveHelper::SaveDouble(const char* key, double value)
 }
 
 // Pre: uMemSize must be multiple of 8
-void YamlSaveHelper::SaveMemory(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset/*=0*/)
+void YamlSaveHelper::SaveMemory(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset/*=0*/, const bool allowCompressed/*=false*/)
 {
 	if (uMemSize & 7)
 		throw std::runtime_error("Memory: size must be multiple of 8");
 
+	if (m_compressMemory && allowCompressed)
+	{
+		SaveMemoryCompressed(pMemBase, uMemSize, offset);
+		return;
+	}
+
 	const UINT kIndent = m_indent;
 
 	const UINT kStride = 64;
@@ -599,6 +696,19 @@ void YamlSaveHelper::SaveMemory(const LPBYTE pMemBase, const UINT uMemSize, cons
 	delete [] pLine;
 }
 
+// A whole block is deflated in one go: avoids formatting (and later parsing) 2 chars/byte of hex,
+// and RAM images are typically very compressible (eg. unused RamWorks banks)
+void YamlSaveHelper::SaveMemoryCompressed(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset)
+{
+	uLongf size = compressBound(uMemSize);
+	std::vector<BYTE> compressed(size);
+	if (compress2(compressed.data(), &size, pMemBase + offset, uMemSize, Z_BEST_SPEED) != Z_OK)
+		throw std::runtime_error("Memory: failed to compress data");
+
+	const std::string encoded = Base64Encode(compressed.data(), size);
+	Save("%c%04X: %s\n", SS_YAML_MEMORY_COMPRESSED_PREFIX, offset, encoded.c_str());
+}
+
 void YamlSaveHelper::FileHdr(UINT version)
 {
 	fprintf(m_hFile, "%s:\n", SS_YAML_KEY_FILEHDR);
@@ -15,6 +15,10 @@
 
 #define SS_YAML_VALUE_AWSS "AppleWin Save State"
 
+// Memory saved as a single zlib-compressed, base64-encoded block: "Z<hex addr>: <data>"
+// (instead of the "<hex addr>: <hex data>" lines)
+#define SS_YAML_MEMORY_COMPRESSED_PREFIX 'Z'
+
 struct MapValue;
 typedef std::map<std::string, MapValue> MapYaml;
 
@@ -54,7 +58,8 @@ private:
 	void GetNextEvent(void);
 	int ParseMap(MapYaml& mapYaml);
 	std::string GetMapValue(MapYaml& mapYaml, const std::string &key, bool& bFound);
-	UINT LoadMemory(MapYaml& mapYaml, const LPBYTE pMemBase, const size_t kAddrSpaceSize, const UINT offset);
+	UINT LoadMemory(MapYaml& mapYaml, const LPBYTE pMemBase, const size_t kAddrSpaceSize, const UINT offset, const bool allowCompressed=false);
+	UINT LoadMemoryCompressed(const std::string& key, const std::string& value, const LPBYTE pDst, const LPBYTE pDstEnd);
 	bool GetSubMap(MapYaml** mapYaml, const std::string &key, const bool canBeNull=false);
 	void GetMapRemainder(std::string& mapName, MapYaml& mapYaml);
 
@@ -105,7 +110,7 @@ public:
 	std::string LoadString(const std::string& key);
 	float LoadFloat(const std::string & key);
 	double LoadDouble(const std::string & key);
-	void LoadMemory(const LPBYTE pMemBase, const size_t size, const UINT offset=0);
+	void LoadMemory(const LPBYTE pMemBase, const size_t size, const UINT offset=0, const bool allowCompressed=false);
 	void LoadMemory(std::vector<BYTE>& memory, const size_t size, const UINT offset=0);
 
 	bool GetSubMap(const std::string & key, const bool canBeNull=false)
@@ -178,6 +183,7 @@ public:
 	YamlSaveHelper(const std::string & pathname) :
 		m_hFile(NULL),
 		m_indent(0),
+		m_compressMemory(false),
 		m_pWcStr(NULL),
 		m_wcStrSize(0),
 		m_pMbStr(NULL),
@@ -233,7 +239,11 @@ public:
 	void SaveString(const char* key, const std::string & value);
 	void SaveFloat(const char* key, float value);
 	void SaveDouble(const char* key, double value);
-	void SaveMemory(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset=0);
+	void SaveMemory(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset=0, const bool allowCompressed=false);
+
+	// When true, SaveMemory() writes compressed blocks instead of human-readable hex
+	// . but only for units whose version supports them (ie. the caller passes allowCompressed=true)
+	void SetCompressMemory(const bool compressMemory) { m_compressMemory = compressMemory; }
 
 	class Label
 	{
@@ -278,9 +288,12 @@ public:
 	void UnitHdr(const std::string & type, UINT version);
 
 private:
+	void SaveMemoryCompressed(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset);
+
 	FILE* m_hFile;
 
 	int m_indent;
+	bool m_compressMemory;
 	static const UINT kMaxIndent = 50*2;
 	char m_szIndent[kMaxIndent];
 
@@ -26,8 +26,10 @@
 
 #include "../StdAfx.h"
 
+#include "../Core.h"
 #include "../CPU.h"
 #include "../Memory.h"
+#include "../SynchronousEventManager.h"
 #include "../YamlHelper.h"
 
 
@@ -101,8 +103,11 @@ void z80_trigger_dma(void)
 }
 #endif
 
+static void z80_init_direct_pages(void);
+
 void z80_reset(void)
 {
+    z80_init_direct_pages();	// [AppleWin]
     z80_reg_pc = 0;
     z80_regs.reg_pc = 0;
     iff1 = 0;
@@ -134,8 +139,42 @@ void z80_reset(void)
    } while (0)
 
 
+// [AppleWin] Z80 pages that map to plain 6502 memory (ie. not the I/O window at $Exxx, nor $F8xx which may be a NSC)
+// are read straight from mem[], as CpuRead() would, skipping z80_RDMEM()'s translation (4x per FETCH_OPCODE).
+// Only in MODE_RUNNING, as otherwise CpuRead() goes via the heatmap.
+static int z80_direct_page[0x100];		// 6502 page, or -1 if not a plain memory page
+static bool z80_direct_read = false;
+
+static void z80_init_direct_pages(void)
+{
+    for (int page = 0; page < 0x100; page++)
+    {
+        int page6502;
+        if (page < 0xB0)
+            page6502 = page + 0x10;		// $0000-AFFF -> $1000-BFFF
+        else if (page < 0xE0)
+            page6502 = page + 0x20;		// $B000-DFFF -> $D000-FFFF
+        else if (page < 0xF0)
+            page6502 = -1;				// $E000-EFFF -> $C000-CFFF (I/O)
+        else
+            page6502 = page - 0xF0;		// $F000-FFFF -> $0000-0FFF
+        z80_direct_page[page] = (page6502 >= 0xF8) ? -1 : page6502;
+    }
+}
+
+static inline BYTE z80_load(const WORD addr)
+{
+    if (z80_direct_read)
+    {
+        const int page = z80_direct_page[addr >> 8];
+        if (page >= 0)
+            return mem[(page << 8) | (addr & 0xff)];
+    }
+    return (*_z80mem_read_tab_ptr[addr >> 8])(addr);
+}
+
 #define LOAD(addr) \
-    (*_z80mem_read_tab_ptr[(addr) >> 8])((WORD)(addr))
+    z80_load((WORD)(addr))
 
 #define STORE(addr, value) \
     (*_z80mem_write_tab_ptr[(addr) >> 8])((WORD)(addr), (BYTE)(value))
@@ -5511,11 +5550,11 @@ static void opcode_fd(BYTE ip1, BYTE ip2, BYTE ip3, WORD ip12, WORD ip23)
 
 // The effective Z-80 clock rate is 2.041MHz
 // See: http://www.apple2info.net/hardware/softcard/SC-SWHW_a2in.pdf
-static const double uZ80ClockMultiplier = 2;
+static const UINT uZ80ClockMultiplier = 2;
 
 inline static ULONG ConvertZ80TStatesTo6502Cycles(UINT uTStates)
 {
-	return (uTStates < 0) ? 0 : (ULONG) ((double)uTStates / uZ80ClockMultiplier);
+	return uTStates / uZ80ClockMultiplier;	// called for every z80_RDMEM()/z80_WRMEM(), so keep it integer
 }
 
 //void z80_mainloop(interrupt_cpu_status_t *cpu_int_status,
@@ -5531,10 +5570,12 @@ DWORD z80_mainloop(ULONG uTotalCycles, ULONG uExecutedCycles)
 
     //dma_request = 0;											// [AppleWin-TC] Not used
 
-	uTotalCycles    = (ULONG) ((double)uTotalCycles    * uZ80ClockMultiplier);
-	uExecutedCycles = (ULONG) ((double)uExecutedCycles * uZ80ClockMultiplier);
+	uTotalCycles    = uTotalCycles    * uZ80ClockMultiplier;
+	uExecutedCycles = uExecutedCycles * uZ80ClockMultiplier;
 	maincpu_clk = uExecutedCycles;	// Must be signed int, as cycles can go -ve
 
+	z80_direct_read = (g_nAppMode == MODE_RUNNING);	// [AppleWin]
+
     do {
 
 		// [AppleWin-TC] Z80 IRQs not supported
@@ -6385,6 +6426,7 @@ BYTE z80_RDMEM(WORD Addr)
 
 		case 0xE:
 			addr = (WORD)Addr - 0x2000;
+			g_SynchronousEventMgr.SetCyclesNow( ConvertZ80TStatesTo6502Cycles(maincpu_clk) );	// [AppleWin] I/O handlers can insert/remove SyncEvents
 			return IORead[(addr>>4) & 0xFF]( regs.pc, addr, 0, 0, ConvertZ80TStatesTo6502Cycles(maincpu_clk) ); // Maps to 6502 I/O address range: $C000..CFFF
 		break;
 
@@ -42,6 +42,7 @@ DebugServerManager::DebugServerManager()
     m_cpuProvider = std::make_unique<CPUInfoProvider>();
     m_ioProvider = std::make_unique<IOInfoProvider>();
     m_memoryProvider = std::make_unique<MemoryInfoProvider>();
+    m_metricsProvider = std::make_unique<MetricsInfoProvider>();
 
     // Create stream provider
     m_streamProvider = std::make_unique<DebugStreamProvider>();
@@ -104,6 +105,13 @@ bool DebugServerManager::Start() {
             allStarted = false;
         }
 
+        // Metrics Server (port 65506)
+        m_metricsServer = CreateServer(m_metricsProvider.get());
+        if (!m_metricsServer->Start()) {
+            m_lastError += "Metrics server failed: " + m_metricsServer->GetLastError() + "\n";
+            allStarted = false;
+        }
+
         // Stream Server (port 65505)
         if (m_streamEnabled) {
             m_streamServer = std::make_unique<TelnetStreamServer>(
@@ -135,6 +143,8 @@ bool DebugServerManager::Start() {
                   << static_cast<int>(DebugServerPort::CPU) << "/" << std::endl;
         std::cout << "  Memory Info:  http://" << m_bindAddress << ":"
                   << static_cast<int>(DebugServerPort::Memory) << "/" << std::endl;
+        std::cout << "  Metrics:      http://" << m_bindAddress << ":"
+                  << static_cast<int>(DebugServerPort::Metrics) << "/metrics" << std::endl;
         if (m_streamEnabled && m_streamServer) {
             std::cout << "  Debug Stream: telnet://" << m_bindAddress << ":"
                       << static_cast<int>(DebugServerPort::Stream) << "/" << std::endl;
@@ -149,7 +159,7 @@ bool DebugServerManager::Start() {
 
 void DebugServerManager::Stop() {
     if (!m_running.load() &&
-        !m_machineServer && !m_cpuServer && !m_ioServer && !m_memoryServer && !m_streamServer) {
+        !m_machineServer && !m_cpuServer && !m_ioServer && !m_memoryServer && !m_metricsServer && !m_streamServer) {
         return;  // Nothing to stop
     }
 
@@ -174,6 +184,11 @@ void DebugServerManager::Stop() {
         m_memoryServer.reset();
     }
 
+    if (m_metricsServer) {
+        m_metricsServer->Stop();
+        m_metricsServer.reset();
+    }
+
     // Stop stream server
     if (m_streamServer) {
         m_streamServer->Stop();
@@ -200,6 +215,7 @@ std::vector<DebugServerManager::ServerStatus> DebugServerManager::GetServerStatu
     addStatus("I/O Info", static_cast<uint16_t>(DebugServerPort::IO), m_ioServer.get());
     addStatus("CPU Info", static_cast<uint16_t>(DebugServerPort::CPU), m_cpuServer.get());
     addStatus("Memory Info", static_cast<uint16_t>(DebugServerPort::Memory), m_memoryServer.get());
+    addStatus("Metrics", static_cast<uint16_t>(DebugServerPort::Metrics), m_metricsServer.get());
 
     // Add stream server status
     {
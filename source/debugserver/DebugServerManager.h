@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "CPUInfoProvider.h"
 #include "IOInfoProvider.h"
 #include "MemoryInfoProvider.h"
+#include "MetricsInfoProvider.h"
 #include "DebugStreamProvider.h"
 
 #include <memory>
@@ -101,6 +102,7 @@ public:
     InfoProvider* GetCPUInfoProvider() { return m_cpuProvider.get(); }
     InfoProvider* GetIOInfoProvider() { return m_ioProvider.get(); }
     InfoProvider* GetMemoryInfoProvider() { return m_memoryProvider.get(); }
+    InfoProvider* GetMetricsInfoProvider() { return m_metricsProvider.get(); }
 
     // Stream server access
     TelnetStreamServer* GetStreamServer() { return m_streamServer.get(); }
@@ -133,6 +135,7 @@ private:
     std::unique_ptr<CPUInfoProvider> m_cpuProvider;
     std::unique_ptr<IOInfoProvider> m_ioProvider;
     std::unique_ptr<MemoryInfoProvider> m_memoryProvider;
+    std::unique_ptr<MetricsInfoProvider> m_metricsProvider;
 
     // Stream Provider
     std::unique_ptr<DebugStreamProvider> m_streamProvider;
@@ -142,6 +145,7 @@ private:
     std::unique_ptr<HttpServer> m_cpuServer;
     std::unique_ptr<HttpServer> m_ioServer;
     std::unique_ptr<HttpServer> m_memoryServer;
+    std::unique_ptr<HttpServer> m_metricsServer;
 
     // Telnet Stream Server
     std::unique_ptr<TelnetStreamServer> m_streamServer;
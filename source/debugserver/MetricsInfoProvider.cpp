@@ -0,0 +1,143 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2024, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "StdAfx.h"
+
+#include "MetricsInfoProvider.h"
+#include "JsonBuilder.h"
+
+// AppleWin includes - access to emulator state
+#include "PerfCounters.h"
+
+#include <cstdio>
+#include <sstream>
+
+namespace debugserver {
+
+namespace {
+
+const char* const kPrefix = "applewin_";
+
+double ToSeconds(UINT64 ns) {
+    return ns / 1.0e9;
+}
+
+std::string ToPrometheusSeconds(UINT64 ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9f", ToSeconds(ns));
+    return buf;
+}
+
+// Counters in ns are exported in seconds, as Prometheus expects
+double ToExportedValue(PerfCounter_e counter, UINT64 value) {
+    return PerfCounters_GetInfo(counter).isTime ? ToSeconds(value) : static_cast<double>(value);
+}
+
+// Keep full precision for large integer counters (eg. cycles)
+std::string ToPrometheusValue(PerfCounter_e counter, UINT64 value) {
+    if (!PerfCounters_GetInfo(counter).isTime) {
+        return std::to_string(value);
+    }
+    return ToPrometheusSeconds(value);
+}
+
+} // namespace
+
+void MetricsInfoProvider::HandleRequest(const HttpRequest& request, HttpResponse& response) {
+    std::string path = request.GetPath();
+    std::string format = request.GetQueryParam("format", "prometheus");
+
+    // API routes
+    if (path == "/api/metrics" || ((path == "/metrics" || path == "/") && format == "json")) {
+        HandleApiMetrics(response);
+    }
+    else if (path == "/metrics" || path == "/") {
+        HandlePrometheus(response);
+    }
+    else {
+        SendErrorResponse(response, 404, "Endpoint not found: " + path);
+    }
+}
+
+void MetricsInfoProvider::HandlePrometheus(HttpResponse& response) {
+    std::ostringstream out;
+
+    for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+        const PerfCounter_e counter = static_cast<PerfCounter_e>(i);
+        const PerfCounterInfo& info = PerfCounters_GetInfo(counter);
+        if (!info.isAvailable) {
+            continue;
+        }
+
+        // running total
+        out << "# HELP " << kPrefix << info.name << "_total " << info.help << "\n";
+        out << "# TYPE " << kPrefix << info.name << "_total counter\n";
+        out << kPrefix << info.name << "_total " << ToPrometheusValue(counter, PerfCounters_GetTotal(counter)) << "\n";
+
+        // rate over the last second
+        out << "# HELP " << kPrefix << info.name << "_per_second " << info.help << " (last second)\n";
+        out << "# TYPE " << kPrefix << info.name << "_per_second gauge\n";
+        out << kPrefix << info.name << "_per_second " << ToPrometheusValue(counter, PerfCounters_GetLastSecond(counter)) << "\n";
+    }
+
+    out << "# HELP " << kPrefix << "uptime_seconds Time since the counters were started\n";
+    out << "# TYPE " << kPrefix << "uptime_seconds gauge\n";
+    out << kPrefix << "uptime_seconds " << ToPrometheusSeconds(PerfCounters_GetUptime()) << "\n";
+
+    // Prometheus text exposition format
+    response.SendText(out.str());
+    response.SetContentType("text/plain; version=0.0.4; charset=utf-8");
+}
+
+void MetricsInfoProvider::HandleApiMetrics(HttpResponse& response) {
+    JsonBuilder json;
+
+    json.BeginObject()
+        .Add("uptimeSeconds", ToSeconds(PerfCounters_GetUptime()));
+
+    json.Key("total").BeginObject();
+    for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+        const PerfCounter_e counter = static_cast<PerfCounter_e>(i);
+        const PerfCounterInfo& info = PerfCounters_GetInfo(counter);
+        if (info.isAvailable) {
+            json.Add(info.name, ToExportedValue(counter, PerfCounters_GetTotal(counter)), 9);
+        }
+    }
+    json.EndObject();
+
+    json.Key("perSecond").BeginObject();
+    for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+        const PerfCounter_e counter = static_cast<PerfCounter_e>(i);
+        const PerfCounterInfo& info = PerfCounters_GetInfo(counter);
+        if (info.isAvailable) {
+            json.Add(info.name, ToExportedValue(counter, PerfCounters_GetLastSecond(counter)), 9);
+        }
+    }
+    json.EndObject();
+
+    json.EndObject();
+
+    SendJsonResponse(response, json.ToPrettyString());
+}
+
+} // namespace debugserver
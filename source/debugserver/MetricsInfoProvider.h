@@ -0,0 +1,52 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2024, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/*
+ * Metrics Information Provider
+ * Exports the emulator performance counters (see PerfCounters.h) for scraping
+ * Port: 65506
+ */
+
+#pragma once
+
+#include "InfoProvider.h"
+
+namespace debugserver {
+
+class MetricsInfoProvider : public InfoProvider {
+public:
+    MetricsInfoProvider() = default;
+    ~MetricsInfoProvider() override = default;
+
+    const char* GetName() const override { return "MetricsInfo"; }
+    uint16_t GetPort() const override { return static_cast<uint16_t>(DebugServerPort::Metrics); }
+
+    void HandleRequest(const HttpRequest& request, HttpResponse& response) override;
+
+private:
+    // API endpoints
+    void HandlePrometheus(HttpResponse& response);
+    void HandleApiMetrics(HttpResponse& response);
+};
+
+} // namespace debugserver
@@ -44,6 +44,11 @@ namespace
 
     constexpr int NO_VIDEO_UPDATE = 1024;
     constexpr int EV_DEVICE_NAME = 1025;
+    constexpr int RECORD_INPUT = 1026;
+    constexpr int REPLAY_INPUT = 1027;
+    constexpr int SAVE_STATE_HEX = 1028;
+    constexpr int FAST_DISK = 1029;
+    constexpr int HDD_WRITE_BACK = 1030;
 
     struct OptionData_t
     {
@@ -173,6 +178,8 @@ namespace common2
                  {"benchmark",               no_argument,          'b',              "Benchmark emulator"},
                  {"no-squaring",             no_argument,          NO_SQUARING,      "Gamepad range is (already) a square"},
                  {"nat",                     required_argument,    SLIRP_NAT,        "SLIRP PortFwd (e.g. 0,tcp,,8080,,http)"},
+                 {"record-input",            required_argument,    RECORD_INPUT,     "Record keys, paddles & clock to file"},
+                 {"replay-input",            required_argument,    REPLAY_INPUT,     "Replay recorded input from file"},
              }},
             {"Disk",
              {
@@ -180,11 +187,14 @@ namespace common2
                  {"d2",                      required_argument,    '2',              "Disk in S6D2 drive"},
                  {"h1",                      required_argument,    DISK_H1,          "Hard Disk in 1st drive"},
                  {"h2",                      required_argument,    DISK_H2,          "Hard Disk in 1st drive"},
+                 {"fast-disk",               no_argument,          FAST_DISK,        "Run the DOS 3.3 and ProDOS disk read routines natively"},
+                 {"hdd-write-back",          no_argument,          HDD_WRITE_BACK,   "Write guest changes back to Hard Disk host directories"},
              }},
             {"Snapshot",
              {
                  {"state-filename",          required_argument,    'f',              "Set snapshot filename"},
                  {"load-state",              required_argument,    's',              "Load snapshot from file"},
+                 {"save-state-hex",          no_argument,          SAVE_STATE_HEX,   "Save memory as hex (not compressed)"},
              }},
             {"Memory",
              {
@@ -334,6 +344,21 @@ namespace common2
                 options.natPortFwds.emplace_back(optarg);
                 break;
             }
+            case RECORD_INPUT:
+            {
+                options.recordInputFilename = optarg;
+                break;
+            }
+            case REPLAY_INPUT:
+            {
+                options.replayInputFilename = optarg;
+                break;
+            }
+            case SAVE_STATE_HEX:
+            {
+                options.saveStateHex = true;
+                break;
+            }
             case DISK_H1:
             {
                 options.hardDisk1 = optarg;
@@ -344,6 +369,16 @@ namespace common2
                 options.hardDisk2 = optarg;
                 break;
             }
+            case FAST_DISK:
+            {
+                options.fastDisk = true;
+                break;
+            }
+            case HDD_WRITE_BACK:
+            {
+                options.hardDiskWriteBack = true;
+                break;
+            }
             case MEM_CLEAR:
             {
                 const int memclear = std::stoi(optarg);
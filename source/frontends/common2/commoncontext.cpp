@@ -3,6 +3,10 @@
 #include "frontends/common2/programoptions.h"
 #include "frontends/common2/utils.h"
 #include "linux/linuxframe.h"
+#include "linux/inputrecorder.h"
+
+#include "CardManager.h"
+#include "Core.h"
 
 namespace common2
 {
@@ -18,9 +22,28 @@ namespace common2
         {
             myFrame->LoadSnapshot();
         }
+
+        if (!options.replayInputFilename.empty() || !options.recordInputFilename.empty())
+        {
+            // mouse card input is not recorded, so the replay would diverge
+            if (GetCardMgr().IsMouseCardInstalled())
+            {
+                throw std::runtime_error("Input recording/replay is not supported with a Mouse Card");
+            }
+
+            if (!options.replayInputFilename.empty())
+            {
+                InputRecorder::instance().startReplay(options.replayInputFilename);
+            }
+            else
+            {
+                InputRecorder::instance().startRecording(options.recordInputFilename);
+            }
+        }
     }
     CommonInitialisation::~CommonInitialisation()
     {
+        InputRecorder::instance().stop();
         myFrame->End();
     }
 
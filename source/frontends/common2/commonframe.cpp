@@ -12,6 +12,7 @@
 #include "Log.h"
 #include "NTSC.h"
 #include "Speaker.h"
+#include "linux/cassettetape.h"
 
 #include "apple2roms_data.h"
 
@@ -71,8 +72,9 @@ namespace common2
     bool CommonFrame::CanDoFullSpeed()
     {
         return (g_dwSpeed == SPEED_MAX) ||
-               (GetCardMgr().GetDisk2CardMgr().IsConditionForFullSpeed() && !Spkr_IsActive() &&
-                !GetCardMgr().GetMockingboardCardMgr().IsActiveToPreventFullSpeed()) ||
+               ((GetCardMgr().GetDisk2CardMgr().IsConditionForFullSpeed() ||
+                 CassetteTape::instance().isConditionForFullSpeed()) &&
+                !Spkr_IsActive() && !GetCardMgr().GetMockingboardCardMgr().IsActiveToPreventFullSpeed()) ||
                IsDebugSteppingAtFullSpeed();
     }
 
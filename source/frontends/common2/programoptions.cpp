@@ -9,6 +9,8 @@
 #include "Speaker.h"
 #include "Riff.h"
 #include "CardManager.h"
+#include "Harddisk.h"
+#include "SaveState.h"
 
 namespace common2
 {
@@ -23,6 +25,7 @@ namespace common2
         g_nMemoryClearType = options.memclear;
         g_bDisableDirectSound = options.noAudio;
         g_bDisableDirectSoundMockingboard = options.noAudio;
+        Snapshot_SetCompressMemory(!options.saveStateHex);
 
         LPCSTR szImageName_drive[NUM_DRIVES] = {nullptr, nullptr};
         bool driveConnected[NUM_DRIVES] = {true, true};
@@ -40,6 +43,11 @@ namespace common2
         bool bBoot = false;
         InsertFloppyDisks(SLOT6, szImageName_drive, driveConnected, bBoot);
 
+        if (options.fastDisk)
+        {
+            GetCardMgr().GetDisk2CardMgr().SetFastDisk(true);
+        }
+
         LPCSTR szImageName_harddisk[NUM_HARDDISKS] = {nullptr, nullptr};
 
         if (!options.hardDisk1.empty())
@@ -54,6 +62,17 @@ namespace common2
 
         InsertHardDisks(SLOT7, szImageName_harddisk, bBoot);
 
+        if (options.hardDiskWriteBack)
+        {
+            for (UINT i = SLOT0; i < NUM_SLOTS; ++i)
+            {
+                if (GetCardMgr().QuerySlot(i) == CT_GenericHDD)
+                {
+                    dynamic_cast<HarddiskInterfaceCard &>(GetCardMgr().GetRef(i)).SetHostVolumeWriteBack(true);
+                }
+            }
+        }
+
         if (!options.customRom.empty())
         {
             CloseHandle(g_hCustomRom);
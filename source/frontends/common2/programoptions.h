@@ -25,9 +25,16 @@ namespace common2
 
         std::string hardDisk1;
         std::string hardDisk2;
+        bool hardDiskWriteBack = false; // host directories are read-only by default
+
+        bool fastDisk = false; // run the RWTS read routines natively (else as per registry)
 
         std::string snapshotFilename;
         bool loadSnapshot = false;
+        bool saveStateHex = false; // save memory as hex (for diffing), instead of compressed
+
+        std::string recordInputFilename;
+        std::string replayInputFilename; // start from the same state as the recording
 
         int memclear;
 
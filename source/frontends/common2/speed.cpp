@@ -4,6 +4,7 @@
 #include "CPU.h"
 #include "Core.h"
 #include "Speaker.h"
+#include "PerfCounters.h"
 
 namespace
 {
@@ -39,6 +40,7 @@ namespace common2
         myOrgStartCycles = myStartCycles;
         myTotalFeedbackCycles = 0;
         myAudioSpeed = getAudioAdjustedSpeed();
+        myLastFrameMicros = 0;
     }
 
     uint32_t Speed::getCyclesAtFixedSpeed(const int64_t microseconds) const
@@ -50,6 +52,7 @@ namespace common2
     uint32_t Speed::getCyclesTillNext(const int64_t microseconds)
     {
         myTotalFeedbackCycles += g_nCpuCyclesFeedback;
+        updateFrameJitter(microseconds);
 
         if (myFixedSpeed || g_bFullSpeed)
         {
@@ -77,6 +80,21 @@ namespace common2
         }
     }
 
+    void Speed::updateFrameJitter(const int64_t microseconds)
+    {
+        const auto currentTime = std::chrono::steady_clock::now();
+        if (myLastFrameMicros > 0)
+        {
+            // compare how long the last frame actually took with what was requested
+            const int64_t actual =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - myLastFrameTime).count();
+            PerfCounters_Add(PERF_FRAMES, 1);
+            PerfCounters_Add(PERF_FRAME_JITTER_NS, std::abs(actual - myLastFrameMicros * 1000));
+        }
+        myLastFrameTime = currentTime;
+        myLastFrameMicros = microseconds;
+    }
+
     Speed::Stats Speed::getSpeedStats() const
     {
         const auto currentTime = std::chrono::steady_clock::now();
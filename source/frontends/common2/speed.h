@@ -29,6 +29,8 @@ namespace common2
         Stats getSpeedStats() const;
 
     private:
+        void updateFrameJitter(const int64_t microseconds);
+
         const bool myFixedSpeed;
 
         std::chrono::time_point<std::chrono::steady_clock> myStartTime;
@@ -37,6 +39,10 @@ namespace common2
         double myAudioSpeed;
 
         int64_t myTotalFeedbackCycles;
+
+        // frame pacing
+        std::chrono::time_point<std::chrono::steady_clock> myLastFrameTime;
+        int64_t myLastFrameMicros;
     };
 
 } // namespace common2
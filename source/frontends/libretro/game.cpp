@@ -64,6 +64,7 @@ namespace ra2
 
     Game::~Game()
     {
+        myMainMemoryWatch.release();
         myFrame->End();
         myFrame.reset();
         SetFrame(myFrame);
@@ -283,7 +284,10 @@ namespace ra2
 
     void Game::restart()
     {
+        // memmain is reallocated
+        myMainMemoryWatch.release();
         myFrame->Restart();
+        myMainMemoryReference = MemGetBankPtr(0, true);
     }
 
     void Game::writeAudio(const size_t fps, const size_t sampleRate, const size_t channels)
@@ -309,10 +313,16 @@ namespace ra2
 
         // force flush (mem -> memmain) so frontend can see the current state of memory
         MemGetBankPtr(0, true);
+
+        // until the next frame, only the frontend writes to memmain
+        myMainMemoryWatch.protect(myMainMemoryReference, _6502_MEM_LEN);
     }
 
     void Game::checkForMemoryWrites()
     {
+        // the emulator writes to memmain during the frame
+        myMainMemoryWatch.release();
+
         // if not using shadow areas, all reads/writes will occur directly on memmain
         if (!GetIsMemCacheValid())
             return;
@@ -320,11 +330,12 @@ namespace ra2
         // the libretro interface exposes memmain. for any pages that have a copy in mem,
         // copy the memmain back into mem in case it was changed between frames (by cheats,
         // debuggers, or other forms of memory editing)
+        // after flushMemory() every such page of mem matches memmain, so only copy the pages the frontend wrote to
         LPBYTE memMainPtr = myMainMemoryReference;
         for (UINT loop = 0; loop < _6502_NUM_PAGES; loop++)
         {
             LPBYTE altptr = MemGetMainPtr(loop * _6502_PAGE_SIZE);
-            if (altptr != memMainPtr)
+            if (altptr != memMainPtr && myMainMemoryWatch.isWritten(loop * _6502_PAGE_SIZE, _6502_PAGE_SIZE))
             {
                 // because this ensures mem and memmain match, we don't have to set the dirty flag
                 memcpy(altptr, memMainPtr, _6502_PAGE_SIZE);
@@ -4,6 +4,7 @@
 #include "frontends/common2/controllerdoublepress.h"
 #include "frontends/libretro/environment.h"
 #include "frontends/libretro/diskcontrol.h"
+#include "frontends/libretro/memorywatch.h"
 #include "frontends/libretro/input/rkeyboard.h"
 #include "frontends/libretro/input/inputremapper.h"
 
@@ -73,6 +74,8 @@ namespace ra2
 
         std::vector<int16_t> myAudioBuffer;
         LPBYTE myMainMemoryReference;
+        // the frontend's writes to memmain between frames
+        MemoryWatch myMainMemoryWatch;
 
         void keyboardEmulation();
         void applyVariables();
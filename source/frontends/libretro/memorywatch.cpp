@@ -0,0 +1,202 @@
+#include "StdAfx.h"
+#include "frontends/libretro/memorywatch.h"
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+#ifndef _WIN32
+    // enough for 64KB of 4KB host pages
+    constexpr size_t MAX_WATCHED_PAGES = 16;
+
+    // shared with the fault handler
+    uint8_t *volatile ourBegin = nullptr;
+    volatile size_t ourNumPages = 0;
+    volatile sig_atomic_t ourWritten[MAX_WATCHED_PAGES] = {};
+
+    size_t ourPageSize = 0;
+    bool ourInstalled = false;
+    struct sigaction ourPreviousSegv;
+    struct sigaction ourPreviousBus;
+
+    void onFault(int sig, siginfo_t *info, void *context)
+    {
+        uint8_t *const address = static_cast<uint8_t *>(info->si_addr);
+        uint8_t *const begin = ourBegin;
+
+        if (begin && address >= begin && address < begin + ourNumPages * ourPageSize)
+        {
+            // unprotect the page and return to retry the write
+            const size_t page = (address - begin) / ourPageSize;
+            ourWritten[page] = 1;
+            mprotect(begin + page * ourPageSize, ourPageSize, PROT_READ | PROT_WRITE);
+            return;
+        }
+
+        // not ours: hand it over to the previous handler
+        const struct sigaction &previous = sig == SIGSEGV ? ourPreviousSegv : ourPreviousBus;
+        if (previous.sa_flags & SA_SIGINFO)
+        {
+            previous.sa_sigaction(sig, info, context);
+        }
+        else if (previous.sa_handler == SIG_DFL || previous.sa_handler == SIG_IGN)
+        {
+            // the faulting instruction will run again, and fault with the default action
+            sigaction(sig, &previous, nullptr);
+        }
+        else
+        {
+            previous.sa_handler(sig);
+        }
+    }
+
+    bool installHandler()
+    {
+        const long pageSize = sysconf(_SC_PAGESIZE);
+        if (pageSize <= 0)
+        {
+            return false;
+        }
+        ourPageSize = pageSize;
+
+        struct sigaction action = {};
+        action.sa_sigaction = onFault;
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+
+        if (sigaction(SIGSEGV, &action, &ourPreviousSegv) != 0)
+        {
+            return false;
+        }
+        // macOS raises SIGBUS for writes to protected pages
+        if (sigaction(SIGBUS, &action, &ourPreviousBus) != 0)
+        {
+            sigaction(SIGSEGV, &ourPreviousSegv, nullptr);
+            return false;
+        }
+        return true;
+    }
+
+    void uninstallHandler()
+    {
+        sigaction(SIGSEGV, &ourPreviousSegv, nullptr);
+        sigaction(SIGBUS, &ourPreviousBus, nullptr);
+    }
+#endif
+
+} // namespace
+
+namespace ra2
+{
+
+    MemoryWatch::MemoryWatch()
+        : myEnabled(false)
+        , myWatched(false)
+        , myBuffer(nullptr)
+    {
+#ifndef _WIN32
+        if (!ourInstalled && installHandler())
+        {
+            ourInstalled = true;
+            myEnabled = true;
+        }
+#endif
+    }
+
+    MemoryWatch::~MemoryWatch()
+    {
+        release();
+#ifndef _WIN32
+        if (myEnabled)
+        {
+            uninstallHandler();
+            ourInstalled = false;
+        }
+#endif
+    }
+
+    void MemoryWatch::protect(uint8_t *buffer, size_t size)
+    {
+        release();
+
+        myBuffer = buffer;
+        myWatched = false;
+
+#ifndef _WIN32
+        if (!myEnabled || !buffer)
+        {
+            return;
+        }
+
+        // only the host pages entirely inside the buffer
+        const uintptr_t begin = (reinterpret_cast<uintptr_t>(buffer) + ourPageSize - 1) / ourPageSize * ourPageSize;
+        const uintptr_t end = (reinterpret_cast<uintptr_t>(buffer) + size) / ourPageSize * ourPageSize;
+        const size_t numPages = end > begin ? (end - begin) / ourPageSize : 0;
+        if (numPages == 0 || numPages > MAX_WATCHED_PAGES)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < numPages; ++i)
+        {
+            ourWritten[i] = 0;
+        }
+        ourNumPages = numPages;
+        ourBegin = reinterpret_cast<uint8_t *>(begin);
+
+        if (mprotect(ourBegin, numPages * ourPageSize, PROT_READ) != 0)
+        {
+            ourBegin = nullptr;
+            return;
+        }
+        myWatched = true;
+#endif
+    }
+
+    void MemoryWatch::release()
+    {
+#ifndef _WIN32
+        if (ourBegin && myEnabled)
+        {
+            mprotect(ourBegin, ourNumPages * ourPageSize, PROT_READ | PROT_WRITE);
+            ourBegin = nullptr;
+        }
+#endif
+    }
+
+    bool MemoryWatch::isWritten(size_t offset, size_t size) const
+    {
+        if (!myWatched)
+        {
+            return true;
+        }
+
+#ifndef _WIN32
+        // NB. ourBegin is cleared by release(), so recompute the watched pages
+        const uintptr_t begin = (reinterpret_cast<uintptr_t>(myBuffer) + ourPageSize - 1) / ourPageSize * ourPageSize;
+        const uintptr_t first = reinterpret_cast<uintptr_t>(myBuffer) + offset;
+        const uintptr_t last = first + size;
+        if (first < begin || last > begin + ourNumPages * ourPageSize)
+        {
+            return true;
+        }
+
+        for (size_t page = (first - begin) / ourPageSize; page * ourPageSize < last - begin; ++page)
+        {
+            if (ourWritten[page])
+            {
+                return true;
+            }
+        }
+        return false;
+#else
+        return true;
+#endif
+    }
+
+} // namespace ra2
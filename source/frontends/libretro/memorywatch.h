@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ra2
+{
+
+    // Detects the frontend's writes to a buffer between 2 frames (cheats, memory editors...)
+    // by write-protecting its host pages: the first write to a page faults, marks the page as written
+    // and removes the protection, so that the write can complete.
+    // Where this is not possible (host pages straddling the buffer, unsupported platform),
+    // the memory is reported as written.
+    // Only 1 instance can watch at a time, as the fault handler is process-wide.
+    class MemoryWatch
+    {
+    public:
+        MemoryWatch();
+        ~MemoryWatch();
+
+        // write-protect [buffer, buffer + size) and forget the previous writes
+        void protect(uint8_t *buffer, size_t size);
+
+        // remove the write-protection, but remember the writes
+        void release();
+
+        // has [offset, offset + size) of the buffer been written to between protect() and release()?
+        bool isWritten(size_t offset, size_t size) const;
+
+    private:
+        bool myEnabled;
+        bool myWatched;
+        uint8_t *myBuffer;
+    };
+
+} // namespace ra2
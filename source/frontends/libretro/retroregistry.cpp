@@ -273,6 +273,19 @@ namespace
             REG_CONFIG,
             REGVALUE_VIDEO_REFRESH_RATE, // reset required
         },
+        {
+            {
+                "fast_disk",
+                "Fast DOS 3.3/ProDOS Disk Reads",
+                CATEGORY_SYSTEM,
+                {
+                    {"Disabled", 0},
+                    {"Enabled", 1},
+                },
+            },
+            REG_CONFIG,
+            REGVALUE_FAST_DISK, // reset required
+        },
         {
             {
                 "playlist_start",
@@ -13,6 +13,7 @@ namespace na2
     }
 
     const int ASCIIArt::PPQ = 8 * (2 * 7) / 4;
+    const int ASCIIArt::BLOCKS_BITS = 4 * 5;
 
     ASCIIArt::ASCIIArt()
         : myRows(0)
@@ -30,6 +31,8 @@ namespace na2
 
         myBlocks.resize(128);
 
+        myCharacterIndex.assign(1 << BLOCKS_BITS, 0);
+
         init(1, 1); // normal size
     }
 
@@ -165,12 +168,10 @@ namespace na2
 
     const ASCIIArt::Character &ASCIIArt::getCharacter(const Blocks &values)
     {
-        const int zip = values.value;
-
-        const std::unordered_map<int, Character>::const_iterator it = myAsciiPixels.find(zip);
-        if (it == myAsciiPixels.end())
+        uint32_t &index = myCharacterIndex[values.value];
+        if (index == 0)
         {
-            Character &best = myAsciiPixels[zip];
+            Character best;
             best.error = DBL_MAX;
 
             for (const Unicode &glyph : myGlyphs)
@@ -188,12 +189,11 @@ namespace na2
                 }
             }
 
-            return best;
-        }
-        else
-        {
-            return it->second;
+            myCharacters.push_back(best);
+            index = myCharacters.size();
         }
+
+        return myCharacters[index - 1];
     }
 
     void ASCIIArt::fit(const Blocks &art, const Unicode &glyph, double &foreground, double &background, double &error)
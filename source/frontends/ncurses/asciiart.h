@@ -1,7 +1,8 @@
 #pragma once
 
-#include <unordered_map>
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 #include <initializer_list>
 
 namespace na2
@@ -78,7 +79,12 @@ namespace na2
     private:
         static const int PPQ; // Pixels per Quadrant
 
-        std::unordered_map<int, Character> myAsciiPixels;
+        static const int BLOCKS_BITS; // 4 quadrants x 5 bits
+
+        // best glyph for each Blocks value, filled lazily
+        // myCharacterIndex[value] is 1 + index into myCharacters, 0 if not computed yet
+        std::vector<uint32_t> myCharacterIndex;
+        std::vector<Character> myCharacters;
 
         struct Unicode
         {
@@ -18,6 +18,12 @@
 namespace na2
 {
 
+    namespace
+    {
+        // never a valid key, as the group colour bit is not part of it
+        const uint64_t INVALID_CELL = ~uint64_t(0);
+    } // namespace
+
     struct NCurses
     {
         NCurses()
@@ -62,6 +68,7 @@ namespace na2
         myTextFlashCounter = 0;
         myTextFlashState = 0;
         myAsciiArt = std::make_shared<ASCIIArt>();
+        myHiResCells.assign(24 * 40, INVALID_CELL);
     }
 
     void NFrame::Destroy()
@@ -84,11 +91,18 @@ namespace na2
     void NFrame::ChangeColumns(const int x)
     {
         myAsciiArt->changeColumns(x);
+        InvalidateCells();
     }
 
     void NFrame::ChangeRows(const int x)
     {
         myAsciiArt->changeRows(x);
+        InvalidateCells();
+    }
+
+    void NFrame::InvalidateCells()
+    {
+        std::fill(myHiResCells.begin(), myHiResCells.end(), INVALID_CELL);
     }
 
     void NFrame::ReInit()
@@ -100,6 +114,7 @@ namespace na2
     {
         InitialiseNCurses();
         myNCurses->allclear();
+        InvalidateCells();
 
         myRows = rows;
         myColumns = columns;
@@ -177,6 +192,10 @@ namespace na2
             int xpixel = 0;
             while (x < 40)
             {
+                if (update != &NFrame::UpdateHiResCell)
+                {
+                    myHiResCells[y * 40 + x] = INVALID_CELL;
+                }
                 (this->*update)(video, x, y, xpixel, ypixel, offset + x);
                 ++x;
                 xpixel += 14;
@@ -195,6 +214,10 @@ namespace na2
             int xpixel = 0;
             while (x < 40)
             {
+                if (update != &NFrame::UpdateHiResCell)
+                {
+                    myHiResCells[y * 40 + x] = INVALID_CELL;
+                }
                 (this->*update)(video, x, y, xpixel, ypixel, offset + x);
                 ++x;
                 xpixel += 14;
@@ -363,6 +386,19 @@ namespace na2
     {
         const BYTE *base = myHiresBank0 + offset;
 
+        // the 8 lines of the cell (group colour bit is ignored)
+        uint64_t key = 0;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            key = (key << 8) | (base[0x0400 * i] & 0x7f);
+        }
+
+        uint64_t &cell = myHiResCells[y * 40 + x];
+        if (cell == key)
+        {
+            return true; // still on screen
+        }
+
         const ASCIIArt::array_char_t &chs = myAsciiArt->getCharacters(base);
 
         const int rows = chs.size();
@@ -370,6 +406,7 @@ namespace na2
 
         Init(24 * rows, 40 * cols);
         WINDOW *win = myFrame.get();
+        cell = key;
 
         const GraphicsColors &colors = *myNCurses->colors;
 
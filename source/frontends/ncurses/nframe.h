@@ -5,6 +5,8 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+#include <cstdint>
 
 namespace na2
 {
@@ -56,7 +58,11 @@ namespace na2
         LPBYTE myHiresBank1;
         LPBYTE myHiresBank0;
 
+        // hires bytes each cell was last drawn from, to only redraw the cells that changed
+        std::vector<uint64_t> myHiResCells;
+
         void VideoUpdateFlash();
+        void InvalidateCells();
 
         chtype MapCharacter(Video &video, BYTE ch);
 
@@ -375,6 +375,13 @@ namespace sa2
                         cardManager.GetDisk2CardMgr().SetEnhanceDisk(enhancedSpeed);
                         REGSAVE(REGVALUE_ENHANCE_DISK_SPEED, (uint32_t)enhancedSpeed);
                     }
+                    ImGui::SameLine();
+                    bool fastDisk = cardManager.GetDisk2CardMgr().GetFastDisk();
+                    if (ImGui::Checkbox("Fast DOS 3.3/ProDOS reads", &fastDisk))
+                    {
+                        cardManager.GetDisk2CardMgr().SetFastDisk(fastDisk);
+                        REGSAVE(REGVALUE_FAST_DISK, (uint32_t)fastDisk);
+                    }
 
                     ImGui::Separator();
 
@@ -594,7 +601,7 @@ namespace sa2
 
                     ImGui::Separator();
 
-                    if (ImGui::BeginTable("Devices", 7, ImGuiTableFlags_RowBg))
+                    if (ImGui::BeginTable("Devices", 8, ImGuiTableFlags_RowBg))
                     {
                         myAudioInfo = getAudioInfo();
                         ImGui::TableSetupColumn("Voice");
@@ -603,6 +610,7 @@ namespace sa2
                         ImGui::TableSetupColumn("Sample rate");
                         ImGui::TableSetupColumn("Volume");
                         ImGui::TableSetupColumn("Buffer (ms)");
+                        ImGui::TableSetupColumn("Min (ms)");
                         ImGui::TableSetupColumn("Underruns");
                         ImGui::TableHeadersRow();
 
@@ -628,6 +636,8 @@ namespace sa2
                             float size = device.size * 1000;
                             ImGui::SliderFloat("##Buffer", &buffer, 0, size, "%4.0f");
                             ImGui::TableNextColumn();
+                            ImGui::Text("%4.0f", device.minBuffer * 1000);
+                            ImGui::TableNextColumn();
                             ImGui::Text("%zu", device.numberOfUnderruns);
                             ImGui::PopID();
                         }
@@ -710,6 +720,12 @@ namespace sa2
                         ImGui::LabelText("Frequency", "%d Hz", info.frequency);
                         ImGui::LabelText("Auto Play", "%s", "ON");
 
+                        bool turbo = tape.getTurbo();
+                        if (ImGui::Checkbox("Turbo (full speed while loading)", &turbo))
+                        {
+                            tape.setTurbo(turbo);
+                        }
+
                         ImGui::Separator();
 
                         if (ImGui::Button("Rewind"))
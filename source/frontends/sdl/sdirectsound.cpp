@@ -164,6 +164,8 @@ namespace
         std::cerr << ", buffer: " << std::setw(6) << bytesInBuffer;
         const double time = double(bytesInBuffer) / myBytesPerSecond * 1000;
         std::cerr << ", " << std::setw(8) << time << " ms";
+        const double minTime = double(GetMinBytesInBuffer()) / myBytesPerSecond * 1000;
+        std::cerr << ", min: " << std::setw(8) << minTime << " ms";
         std::cerr << ", underruns: " << std::setw(10) << GetBufferUnderruns() << std::endl;
     }
 
@@ -186,6 +188,7 @@ namespace
             const float coeff = 1.0 / myBytesPerSecond;
             info.buffer = bytesInBuffer * coeff;
             info.size = myBufferSize * coeff;
+            info.minBuffer = GetMinBytesInBuffer() * coeff;
         }
 
         return info;
@@ -25,6 +25,7 @@ namespace sa2
         // float to work with ImGui.
         float buffer = 0.0;
         float size = 0.0;
+        float minBuffer = 0.0; // lowest level seen by the audio callback
         float volume = 0.0;
 
         size_t numberOfUnderruns = 0;
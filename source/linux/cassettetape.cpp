@@ -94,6 +94,8 @@ BYTE CassetteTape::getValue(const ULONG nExecutedCycles)
         myBaseCycles = g_nCumulativeCycles;
     }
 
+    myLastReadCycles = g_nCumulativeCycles;
+
     size_t pos;
     const tape_data_t val = getCurrentWave(pos);
     const BYTE highBit = getBitValue(val);
@@ -101,6 +103,20 @@ BYTE CassetteTape::getValue(const ULONG nExecutedCycles)
     return highBit;
 }
 
+bool CassetteTape::isConditionForFullSpeed() const
+{
+    if (!myTurbo || !myIsPlaying || myData.empty())
+    {
+        return false;
+    }
+
+    // TAPEIN read in the last 0.1s, and the tape has not reached the end
+    // (the loader polls it continuously, so once it stops we drop back to normal speed almost at once)
+    const int64_t sinceLastRead = g_nCumulativeCycles - myLastReadCycles;
+    const int64_t endOfTape = myBaseCycles + static_cast<int64_t>(double(myData.size()) / myFrequency * g_fCurrentCLK6502);
+    return sinceLastRead < g_fCurrentCLK6502 / 10 && int64_t(g_nCumulativeCycles) < endOfTape;
+}
+
 void CassetteTape::getTapeInfo(TapeInfo &info) const
 {
     info.filename = myFilename;
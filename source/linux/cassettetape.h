@@ -24,6 +24,11 @@ public:
     void eject();
     void rewind();
 
+    // turbo: run at full speed while the tape is being read (it is still read sample by sample, so timing is unchanged)
+    bool isConditionForFullSpeed() const;
+    bool getTurbo() const { return myTurbo; }
+    void setTurbo(const bool turbo) { myTurbo = turbo; }
+
     static CassetteTape &instance();
 
 private:
@@ -33,8 +38,10 @@ private:
     std::vector<tape_data_t> myData;
 
     int64_t myBaseCycles;
+    int64_t myLastReadCycles = 0;
     int myFrequency;
     bool myIsPlaying = false;
+    bool myTurbo = true;
     BYTE myLastBit = 1;     // negative wave
     std::string myFilename; // just for info
 
@@ -2,6 +2,10 @@
 
 #include "YamlHelper.h"
 
+// Only the configuration & snapshot side of Joystick.cpp: none of these take any input.
+// The I/O handlers (JoyReadButton, JoyReadPosition, JoyResetPosition) are in linux/paddle.cpp,
+// which is where InputRecorder::filterButton() & filterAxis() record and replay the buttons & paddles.
+
 void JoyportControl(const UINT uControl)
 {
 }
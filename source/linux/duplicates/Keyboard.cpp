@@ -4,6 +4,9 @@
 #include "Core.h"
 #include "YamlHelper.h"
 
+#include "linux/keyboardbuffer.h"
+#include "linux/inputrecorder.h"
+
 namespace
 {
     std::queue<BYTE> keys;
@@ -19,11 +22,19 @@ namespace
     }
 } // namespace
 
-void addKeyToBuffer(BYTE key)
+void pushKeyToBuffer(BYTE key)
 {
     keys.push(key);
 }
 
+void addKeyToBuffer(BYTE key)
+{
+    if (InputRecorder::instance().filterKey(key))
+    {
+        pushKeyToBuffer(key);
+    }
+}
+
 void addTextToBuffer(const char *text)
 {
     while (*text)
@@ -108,7 +119,7 @@ void KeybLoadSnapshot(YamlLoadHelper &yamlLoadHelper, UINT version)
         keywaiting = yamlLoadHelper.LoadBool(SS_YAML_KEY_KEYWAITING);
 
     keys = std::queue<BYTE>();
-    addKeyToBuffer(keycode);
+    pushKeyToBuffer(keycode);
 
     yamlLoadHelper.PopMap();
 }
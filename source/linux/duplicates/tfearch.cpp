@@ -129,6 +129,14 @@ int tfe_arch_receive(
     return -1;
 }
 
+int tfe_arch_receive_frames(
+    pcap_t *TfePcapFP, const int maxframes, /* Maximum number of frames */
+    tfe_arch_frame_handler_t handler,       /* Called for every frame */
+    void *param)
+{
+    return -1;
+}
+
 const char *tfe_arch_lib_version()
 {
     return 0;
@@ -0,0 +1,388 @@
+#include "StdAfx.h"
+
+#include "linux/inputrecorder.h"
+#include "linux/keyboardbuffer.h"
+
+#include "Core.h"
+#include "CPU.h"
+#include "Log.h"
+
+#include <climits>
+#include <iterator>
+#include <stdexcept>
+
+// File format:
+//  "AWIR" <version:u8>
+//  then per event: <type:u8> <cycles since previous event:varuint> <payload>
+//   Key:    <key:u8>
+//   Button: <button:u8> <pressed:u8>
+//   Axis:   <axis:u8> <position:s16 LE> (-1 = nothing connected)
+//   Clock:  8 x <SYSTEMTIME field:u16 LE>
+
+namespace
+{
+    const char ourMagic[4] = {'A', 'W', 'I', 'R'};
+    const uint8_t ourVersion = 1;
+    const size_t ourClockFields = sizeof(SYSTEMTIME) / sizeof(WORD);
+
+    class Reader
+    {
+    public:
+        Reader(const std::vector<uint8_t> &data) : myData(data), myPosition(0)
+        {
+        }
+
+        bool eof() const
+        {
+            return myPosition >= myData.size();
+        }
+
+        uint8_t u8()
+        {
+            if (eof())
+            {
+                throw std::runtime_error("InputRecorder: truncated file");
+            }
+            return myData[myPosition++];
+        }
+
+        uint16_t u16()
+        {
+            const uint16_t lo = u8();
+            return lo | (u8() << 8);
+        }
+
+        uint64_t varUint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                const uint8_t b = u8();
+                value |= uint64_t(b & 0x7f) << shift;
+                if (!(b & 0x80))
+                {
+                    break;
+                }
+            }
+            return value;
+        }
+
+    private:
+        const std::vector<uint8_t> &myData;
+        size_t myPosition;
+    };
+
+} // namespace
+
+InputRecorder &InputRecorder::instance()
+{
+    static InputRecorder recorder;
+    return recorder;
+}
+
+void InputRecorder::startRecording(const std::string &filename)
+{
+    stop();
+
+    myOutput.open(filename, std::ios::binary | std::ios::trunc);
+    if (!myOutput)
+    {
+        throw std::runtime_error("InputRecorder: cannot create " + filename);
+    }
+
+    myOutput.write(ourMagic, sizeof(ourMagic));
+    myOutput.put(ourVersion);
+
+    std::fill(std::begin(myButtons), std::end(myButtons), INT_MIN);
+    std::fill(std::begin(myAxes), std::end(myAxes), INT_MIN);
+    myLastEventCycle = g_nCumulativeCycles;
+    myMode = Mode::Record;
+    SetLocalTimeFilter(localTimeFilter);
+
+    LogFileOutput("InputRecorder: recording to %s\n", filename.c_str());
+}
+
+void InputRecorder::startReplay(const std::string &filename)
+{
+    stop();
+
+    std::ifstream input(filename, std::ios::binary);
+    if (!input)
+    {
+        throw std::runtime_error("InputRecorder: cannot open " + filename);
+    }
+
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    readEvents(data);
+
+    std::fill(std::begin(myButtons), std::end(myButtons), 0);
+    std::fill(std::begin(myAxes), std::end(myAxes), -1);
+    myMode = Mode::Replay;
+    SetLocalTimeFilter(localTimeFilter);
+
+    // events recorded at the very start are due now
+    replayUntil(g_nCumulativeCycles);
+    scheduleNextKey();
+
+    LogFileOutput(
+        "InputRecorder: replaying %zu events, %zu clock reads from %s\n", myEvents.size(), myClockReads.size(),
+        filename.c_str());
+}
+
+void InputRecorder::stop()
+{
+    if (mySyncEvent.m_active)
+    {
+        g_SynchronousEventMgr.Remove(mySyncEvent.m_id);
+    }
+
+    if (myOutput.is_open())
+    {
+        myOutput.close();
+    }
+
+    myEvents.clear();
+    myNextEvent = 0;
+    myClockReads.clear();
+    myNextClockRead = 0;
+
+    SetLocalTimeFilter(nullptr);
+    myMode = Mode::Off;
+}
+
+void InputRecorder::readEvents(const std::vector<uint8_t> &data)
+{
+    Reader reader(data);
+
+    for (const char c : ourMagic)
+    {
+        if (reader.u8() != uint8_t(c))
+        {
+            throw std::runtime_error("InputRecorder: not an input recording");
+        }
+    }
+
+    if (reader.u8() != ourVersion)
+    {
+        throw std::runtime_error("InputRecorder: unsupported version");
+    }
+
+    uint64_t cycle = g_nCumulativeCycles;
+    while (!reader.eof())
+    {
+        Event event;
+        event.type = EventType(reader.u8());
+        cycle += reader.varUint();
+        event.cycle = cycle;
+
+        switch (event.type)
+        {
+        case Key:
+            event.index = 0;
+            event.value = reader.u8();
+            break;
+        case Button:
+            event.index = reader.u8();
+            event.value = reader.u8();
+            break;
+        case Axis:
+            event.index = reader.u8();
+            event.value = int16_t(reader.u16());
+            break;
+        case Clock:
+        {
+            std::vector<WORD> fields(ourClockFields);
+            for (WORD &field : fields)
+            {
+                field = reader.u16();
+            }
+            myClockReads.push_back(fields);
+            continue; // replayed in order, not by cycle
+        }
+        default:
+            throw std::runtime_error("InputRecorder: unknown event type");
+        }
+
+        if ((event.type == Button && event.index >= ourNumberOfButtons) ||
+            (event.type == Axis && event.index >= ourNumberOfAxes))
+        {
+            throw std::runtime_error("InputRecorder: bad event index");
+        }
+
+        myEvents.push_back(event);
+    }
+}
+
+void InputRecorder::writeVarUint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        myOutput.put(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    myOutput.put(char(value));
+}
+
+void InputRecorder::writeEvent(const EventType type, const uint8_t index, const int16_t value)
+{
+    // NB. g_nCumulativeCycles is only up to date between CPU batches, or after CpuCalcCycles()
+    const uint64_t cycle = std::max<uint64_t>(g_nCumulativeCycles, myLastEventCycle);
+
+    myOutput.put(char(type));
+    writeVarUint(cycle - myLastEventCycle);
+    myLastEventCycle = cycle;
+
+    switch (type)
+    {
+    case Key:
+        myOutput.put(char(value));
+        break;
+    case Button:
+        myOutput.put(char(index));
+        myOutput.put(char(value));
+        break;
+    case Axis:
+        myOutput.put(char(index));
+        myOutput.put(char(value & 0xff));
+        myOutput.put(char((value >> 8) & 0xff));
+        break;
+    default:
+        break;
+    }
+}
+
+void InputRecorder::replayUntil(const uint64_t cycle)
+{
+    while (myNextEvent < myEvents.size() && myEvents[myNextEvent].cycle <= cycle)
+    {
+        const Event &event = myEvents[myNextEvent];
+        switch (event.type)
+        {
+        case Key:
+            pushKeyToBuffer(BYTE(event.value));
+            break;
+        case Button:
+            myButtons[event.index] = event.value;
+            break;
+        case Axis:
+            myAxes[event.index] = event.value;
+            break;
+        default:
+            break;
+        }
+        ++myNextEvent;
+    }
+}
+
+void InputRecorder::scheduleNextKey()
+{
+    for (size_t i = myNextEvent; i < myEvents.size(); ++i)
+    {
+        if (myEvents[i].type == Key)
+        {
+            // long gaps are covered by several shorter waits
+            const uint64_t delta = myEvents[i].cycle - g_nCumulativeCycles;
+            mySyncEvent.m_cyclesRemaining = int(std::min<uint64_t>(delta, INT_MAX));
+            mySyncEvent.m_canAssertIRQ = false; // must not disturb the guest's IRQ timing
+            g_SynchronousEventMgr.Insert(&mySyncEvent);
+            return;
+        }
+    }
+}
+
+int InputRecorder::syncEventCallback(int id, int cycles, ULONG uExecutedCycles)
+{
+    InputRecorder &recorder = instance();
+
+    CpuCalcCycles(uExecutedCycles);
+    recorder.replayUntil(g_nCumulativeCycles);
+
+    for (size_t i = recorder.myNextEvent; i < recorder.myEvents.size(); ++i)
+    {
+        if (recorder.myEvents[i].type == Key)
+        {
+            const uint64_t delta = recorder.myEvents[i].cycle - g_nCumulativeCycles;
+            return int(std::min<uint64_t>(delta, INT_MAX));
+        }
+    }
+
+    return 0; // no more keys
+}
+
+bool InputRecorder::filterKey(const BYTE key)
+{
+    switch (myMode)
+    {
+    case Mode::Record:
+        writeEvent(Key, 0, key);
+        return true;
+    case Mode::Replay:
+        return false;
+    default:
+        return true;
+    }
+}
+
+int InputRecorder::filterPolled(
+    const EventType type, const int index, const int value, const ULONG uExecutedCycles, int *last)
+{
+    switch (myMode)
+    {
+    case Mode::Record:
+        CpuCalcCycles(uExecutedCycles);
+        if (value != last[index])
+        {
+            last[index] = value;
+            writeEvent(type, index, value);
+        }
+        return value;
+    case Mode::Replay:
+        CpuCalcCycles(uExecutedCycles);
+        replayUntil(g_nCumulativeCycles);
+        return last[index];
+    default:
+        return value;
+    }
+}
+
+int InputRecorder::filterButton(const int button, const int pressed, const ULONG uExecutedCycles)
+{
+    if (button < 0 || button >= ourNumberOfButtons)
+    {
+        return pressed;
+    }
+    return filterPolled(Button, button, pressed, uExecutedCycles, myButtons);
+}
+
+int InputRecorder::filterAxis(const int axis, const int position, const ULONG uExecutedCycles)
+{
+    return filterPolled(Axis, axis, position, uExecutedCycles, myAxes);
+}
+
+void InputRecorder::localTimeFilter(SYSTEMTIME *t)
+{
+    InputRecorder &recorder = instance();
+    WORD *fields = reinterpret_cast<WORD *>(t);
+
+    switch (recorder.myMode)
+    {
+    case Mode::Record:
+        recorder.writeEvent(Clock, 0, 0);
+        for (size_t i = 0; i < ourClockFields; ++i)
+        {
+            recorder.myOutput.put(char(fields[i] & 0xff));
+            recorder.myOutput.put(char((fields[i] >> 8) & 0xff));
+        }
+        break;
+    case Mode::Replay:
+        // the guest reads the clock in the same order, so no need to match the cycle
+        if (recorder.myNextClockRead < recorder.myClockReads.size())
+        {
+            const std::vector<WORD> &recorded = recorder.myClockReads[recorder.myNextClockRead++];
+            std::copy(recorded.begin(), recorded.end(), fields);
+        }
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "SynchronousEventManager.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+struct _SYSTEMTIME;
+
+// Records every external input (keys, paddles, push buttons, host clock) with the cycle it was seen at,
+// so that a session can be replayed bit-exactly (e.g. headless, at full speed).
+//
+// Keys are added between CPU batches (so at an instruction boundary) and are replayed via a SyncEvent at the same cycle.
+// Paddles and buttons are polled by the guest, so they are logged (on change) and replayed at the polling cycle.
+// The host clock (NoSlotClock) is replayed in the order it was read.
+//
+// The replay must start from the same machine state as the recording (e.g. same snapshot or deterministic memclear).
+// Mouse Card input is not recorded, so recording/replay is refused when one is installed.
+class InputRecorder
+{
+public:
+    enum class Mode
+    {
+        Off,
+        Record,
+        Replay,
+    };
+
+    void startRecording(const std::string &filename);
+    void startReplay(const std::string &filename);
+    void stop();
+
+    Mode getMode() const
+    {
+        return myMode;
+    }
+
+    // Pre: called by addKeyToBuffer()
+    // Returns false if the live key must be ignored (replay)
+    bool filterKey(const BYTE key);
+
+    // Pre: the guest polls the device at uExecutedCycles
+    // Returns the value the guest must see
+    int filterButton(const int button, const int pressed, const ULONG uExecutedCycles);
+    int filterAxis(const int axis, const int position, const ULONG uExecutedCycles);
+
+    static InputRecorder &instance();
+
+private:
+    enum EventType : uint8_t
+    {
+        Key = 0,
+        Button = 1,
+        Axis = 2,
+        Clock = 3,
+    };
+
+    struct Event
+    {
+        uint64_t cycle; // absolute
+        EventType type;
+        uint8_t index;
+        int16_t value;
+    };
+
+    static constexpr int ourNumberOfButtons = 3;
+    static constexpr int ourNumberOfAxes = 2;
+
+    void writeEvent(const EventType type, const uint8_t index, const int16_t value);
+    void writeVarUint(uint64_t value);
+    void readEvents(const std::vector<uint8_t> &data);
+
+    void replayUntil(const uint64_t cycle);
+    void scheduleNextKey();
+    int filterPolled(const EventType type, const int index, const int value, const ULONG uExecutedCycles, int *last);
+
+    static int syncEventCallback(int id, int cycles, ULONG uExecutedCycles);
+    static void localTimeFilter(_SYSTEMTIME *t);
+
+    Mode myMode = Mode::Off;
+    SyncEvent mySyncEvent{SYNC_EVENT_ID_INPUT_RECORDER, 0, syncEventCallback};
+
+    // record
+    std::ofstream myOutput;
+    uint64_t myLastEventCycle = 0;
+
+    // replay
+    std::vector<Event> myEvents;
+    size_t myNextEvent = 0;
+    std::vector<std::vector<WORD>> myClockReads;
+    size_t myNextClockRead = 0;
+
+    int myButtons[ourNumberOfButtons];
+    int myAxes[ourNumberOfAxes];
+};
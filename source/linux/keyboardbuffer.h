@@ -1,3 +1,5 @@
 // these are defined in source/linux/duplicates/Keyboard.cpp
 void addKeyToBuffer(BYTE key);
+// bypasses input recording / replay
+void pushKeyToBuffer(BYTE key);
 void addTextToBuffer(const char *text);
@@ -5,6 +5,11 @@
 #include <cstring>
 #include <sstream>
 
+namespace
+{
+    LocalTimeFilter localTimeFilter = nullptr;
+}
+
 errno_t ctime_s(char *buf, size_t size, const time_t *time)
 {
     const char *t = asctime(localtime(time));
@@ -46,6 +51,16 @@ void GetLocalTime(SYSTEMTIME *t)
     t->wDay = local->tm_mday;
     t->wMonth = local->tm_mon + 1;
     t->wYear = local->tm_year;
+
+    if (localTimeFilter)
+    {
+        localTimeFilter(t);
+    }
+}
+
+void SetLocalTimeFilter(LocalTimeFilter filter)
+{
+    localTimeFilter = filter;
 }
 
 int GetDateFormat(
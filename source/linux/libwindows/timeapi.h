@@ -27,3 +27,7 @@ int GetTimeFormat(LCID Locale, DWORD dwFlags, CONST SYSTEMTIME *lpTime, LPCSTR l
 DWORD timeGetTime();
 DWORD GetTickCount();
 void GetLocalTime(SYSTEMTIME *t);
+
+// called by GetLocalTime() after the host time is read (e.g. to record or replay it)
+typedef void (*LocalTimeFilter)(SYSTEMTIME *t);
+void SetLocalTimeFilter(LocalTimeFilter filter);
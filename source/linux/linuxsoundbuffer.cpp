@@ -1,10 +1,14 @@
 #include <StdAfx.h>
 
 #include "linux/linuxsoundbuffer.h"
+#include "PerfCounters.h"
 
 LinuxSoundBuffer::LinuxSoundBuffer(DWORD dwBufferSize, DWORD nSampleRate, int nChannels, LPCSTR pszVoiceName)
     : mySoundBuffer(dwBufferSize)
+    , myPlayPosition(0)
+    , myWritePosition(0)
     , myNumberOfUnderruns(0)
+    , myMinBytesInBuffer(dwBufferSize)
     , myBufferSize(dwBufferSize)
     , mySampleRate(nSampleRate)
     , myChannels(nChannels)
@@ -15,8 +19,9 @@ LinuxSoundBuffer::LinuxSoundBuffer(DWORD dwBufferSize, DWORD nSampleRate, int nC
 HRESULT LinuxSoundBuffer::Unlock(LPVOID lpvAudioPtr1, DWORD dwAudioBytes1, LPVOID lpvAudioPtr2, DWORD dwAudioBytes2)
 {
     const size_t totalWrittenBytes = dwAudioBytes1 + dwAudioBytes2;
-    this->myWritePosition = (this->myWritePosition + totalWrittenBytes) % this->mySoundBuffer.size();
-    myMutex.unlock();
+    const size_t writePosition = myWritePosition.load(std::memory_order_relaxed);
+    // release: the data written via Lock() is visible to Read() before the new cursor
+    myWritePosition.store((writePosition + totalWrittenBytes) % this->mySoundBuffer.size(), std::memory_order_release);
     return DS_OK;
 }
 
@@ -63,7 +68,6 @@ HRESULT LinuxSoundBuffer::Lock(
     DWORD dwWriteCursor, DWORD dwWriteBytes, LPVOID *lplpvAudioPtr1, DWORD *lpdwAudioBytes1, LPVOID *lplpvAudioPtr2,
     DWORD *lpdwAudioBytes2, DWORD dwFlags)
 {
-    myMutex.lock();
     // No attempt is made at restricting write buffer not to overtake play cursor
     if (dwFlags & DSBLOCK_ENTIREBUFFER)
     {
@@ -103,20 +107,27 @@ HRESULT LinuxSoundBuffer::Lock(
 DWORD LinuxSoundBuffer::Read(
     DWORD dwReadBytes, LPVOID *lplpvAudioPtr1, DWORD *lpdwAudioBytes1, LPVOID *lplpvAudioPtr2, DWORD *lpdwAudioBytes2)
 {
-    const std::lock_guard<std::mutex> guard(myMutex);
-
     // Read up to dwReadBytes, never going past the write cursor
     // Positions are updated immediately
-    const DWORD available = (this->myWritePosition - this->myPlayPosition) % this->myBufferSize;
+    const size_t playPosition = myPlayPosition.load(std::memory_order_relaxed);
+    const size_t writePosition = myWritePosition.load(std::memory_order_acquire);
+
+    const DWORD available = GetBytesInBuffer(playPosition, writePosition);
     if (available < dwReadBytes)
     {
         dwReadBytes = available;
         ++myNumberOfUnderruns;
+        PerfCounters_Add(PERF_AUDIO_UNDERRUNS, 1);
+    }
+
+    if (available < myMinBytesInBuffer.load(std::memory_order_relaxed))
+    {
+        myMinBytesInBuffer.store(available, std::memory_order_relaxed);
     }
 
-    const DWORD availableInFirstPart = this->mySoundBuffer.size() - this->myPlayPosition;
+    const DWORD availableInFirstPart = this->mySoundBuffer.size() - playPosition;
 
-    *lplpvAudioPtr1 = this->mySoundBuffer.data() + this->myPlayPosition;
+    *lplpvAudioPtr1 = this->mySoundBuffer.data() + playPosition;
     *lpdwAudioBytes1 = std::min(availableInFirstPart, dwReadBytes);
 
     if (lplpvAudioPtr2 && lpdwAudioBytes2)
@@ -132,21 +143,27 @@ DWORD LinuxSoundBuffer::Read(
             *lpdwAudioBytes2 = 0;
         }
     }
-    this->myPlayPosition = (this->myPlayPosition + dwReadBytes) % this->mySoundBuffer.size();
+    // NB: the caller consumes the data before the next call, so the producer can only overwrite it after that
+    myPlayPosition.store((playPosition + dwReadBytes) % this->mySoundBuffer.size(), std::memory_order_release);
     return dwReadBytes;
 }
 
+DWORD LinuxSoundBuffer::GetBytesInBuffer(const size_t playPosition, const size_t writePosition) const
+{
+    return (writePosition + this->myBufferSize - playPosition) % this->myBufferSize;
+}
+
 DWORD LinuxSoundBuffer::GetBytesInBuffer() const
 {
-    const std::lock_guard<std::mutex> guard(myMutex);
-    const DWORD available = (this->myWritePosition - this->myPlayPosition) % this->myBufferSize;
-    return available;
+    const size_t playPosition = myPlayPosition.load(std::memory_order_acquire);
+    const size_t writePosition = myWritePosition.load(std::memory_order_acquire);
+    return GetBytesInBuffer(playPosition, writePosition);
 }
 
 HRESULT LinuxSoundBuffer::GetCurrentPosition(LPDWORD lpdwCurrentPlayCursor, LPDWORD lpdwCurrentWriteCursor)
 {
-    *lpdwCurrentPlayCursor = this->myPlayPosition;
-    *lpdwCurrentWriteCursor = this->myWritePosition;
+    *lpdwCurrentPlayCursor = myPlayPosition.load(std::memory_order_acquire);
+    *lpdwCurrentWriteCursor = myWritePosition.load(std::memory_order_relaxed);
     return DS_OK;
 }
 
@@ -167,9 +184,15 @@ size_t LinuxSoundBuffer::GetBufferUnderruns() const
     return myNumberOfUnderruns;
 }
 
+DWORD LinuxSoundBuffer::GetMinBytesInBuffer() const
+{
+    return myMinBytesInBuffer;
+}
+
 void LinuxSoundBuffer::ResetUnderruns()
 {
     myNumberOfUnderruns = 0;
+    myMinBytesInBuffer = myBufferSize;
 }
 
 bool DSAvailable()
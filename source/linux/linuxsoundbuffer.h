@@ -3,7 +3,6 @@
 #include "SoundBuffer.h"
 
 #include <vector>
-#include <mutex>
 #include <atomic>
 #include <string>
 
@@ -12,14 +11,18 @@ class LinuxSoundBuffer : public SoundBuffer
 private:
     std::vector<uint8_t> mySoundBuffer;
 
-    size_t myPlayPosition = 0;
-    size_t myWritePosition = 0;
+    // single producer (emulator: Lock/Unlock) / single consumer (audio callback: Read) ring buffer
+    // each cursor is only written by its owner, so neither side ever blocks
+    std::atomic_size_t myPlayPosition;
+    std::atomic_size_t myWritePosition;
     WORD myStatus = 0;
     LONG myVolume = 0;
 
     // updated by the callback
     std::atomic_size_t myNumberOfUnderruns;
-    mutable std::mutex myMutex;
+    std::atomic_size_t myMinBytesInBuffer; // lowest level seen by the callback (i.e. worst latency margin)
+
+    DWORD GetBytesInBuffer(const size_t playPosition, const size_t writePosition) const;
 
 protected:
     LinuxSoundBuffer(DWORD dwBufferSize, DWORD nSampleRate, int nChannels, LPCSTR pszVoiceName);
@@ -52,6 +55,7 @@ public:
         DWORD *lpdwAudioBytes2);
     DWORD GetBytesInBuffer() const;
     size_t GetBufferUnderruns() const;
+    DWORD GetMinBytesInBuffer() const; // since last ResetUnderruns()
     void ResetUnderruns();
     double GetLogarithmicVolume() const; // in [0, 1]
 };
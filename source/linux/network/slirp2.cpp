@@ -155,39 +155,23 @@ void SlirpBackend::transmit(const int txlength, uint8_t *txframe)
 
 int SlirpBackend::receive(const int size, uint8_t *rxframe)
 {
-    if (!myQueue.empty())
-    {
-        const std::vector<uint8_t> &packet = myQueue.front();
-        int received = std::min(static_cast<int>(packet.size()), size);
-        memcpy(rxframe, packet.data(), received);
-        if (received & 1)
-        {
-            rxframe[received] = 0;
-            ++received;
-        }
-        myQueue.pop();
-        return received;
-    }
-    else
-    {
-        return -1;
-    }
+    return myQueue.pop(size, rxframe);
 }
 
 void SlirpBackend::sendToGuest(const uint8_t *pkt, int pkt_len)
 {
-    if (myQueue.size() < ourQueueSize)
-    {
-        myQueue.emplace(pkt, pkt + pkt_len);
-    }
-    else
-    {
-        // drop it
-    }
+    // dropped if the queue is full
+    myQueue.push(pkt, pkt_len);
 }
 
 void SlirpBackend::update(const ULONG /* nExecutedCycles */)
 {
+    // a single pass delivers everything pending (via sendToGuest)
+    if (!myPollTimer.isDue())
+    {
+        return;
+    }
+
     uint32_t timeout = 0;
     myFDs.clear();
     slirp_pollfds_fill(mySlirp.get(), &timeout, net_slirp_add_poll, this);
@@ -15,7 +15,6 @@
 
 #include <memory>
 #include <vector>
-#include <queue>
 
 #include <poll.h>
 
@@ -44,13 +43,12 @@ public:
     std::string getNeighborInfo() const;
 
 private:
-    static constexpr size_t ourQueueSize = 10;
-
     const std::string myEmptyInterface;
     std::shared_ptr<Slirp> mySlirp;
     std::vector<pollfd> myFDs;
 
-    std::queue<std::vector<uint8_t>> myQueue;
+    FrameQueue myQueue;
+    HostPollTimer myPollTimer;
 };
 
 #endif
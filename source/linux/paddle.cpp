@@ -1,6 +1,7 @@
 #include "StdAfx.h"
 
 #include "linux/paddle.h"
+#include "linux/inputrecorder.h"
 
 #include "Memory.h"
 #include "CPU.h"
@@ -115,6 +116,11 @@ BYTE __stdcall JoyReadButton(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG uExe
         }
     }
 
+    if (addr >= Paddle::ourOpenApple && addr <= Paddle::ourThirdApple)
+    {
+        pressed = InputRecorder::instance().filterButton(addr - Paddle::ourOpenApple, pressed, uExecutedCycles);
+    }
+
     return MemReadFloatingBus(pressed, uExecutedCycles);
 }
 
@@ -139,19 +145,24 @@ BYTE __stdcall JoyReadPosition(WORD pc, WORD address, BYTE bWrite, BYTE d, ULONG
         // if active, this has the highest priority
         setPdlPos(copyProtection);
     }
-    else if (Paddle::instance)
+    else
     {
         const int nJoyNum = (address & 2) ? 1 : 0; // $C064..$C067
         if (nJoyNum == 0)
         {
             int axis = address & 1;
-            int pos = Paddle::instance->getAxisValue(axis);
-            // This is from KEGS. It helps games like Championship Lode Runner, Boulderdash & Learning with
-            // Leeper(GH#1128)
-            if (pos >= 255)
-                pos = 287;
+            // -1 if nothing is connected
+            int pos = Paddle::instance ? Paddle::instance->getAxisValue(axis) : -1;
+            pos = InputRecorder::instance().filterAxis(axis, pos, uExecutedCycles);
+            if (pos >= 0)
+            {
+                // This is from KEGS. It helps games like Championship Lode Runner, Boulderdash & Learning with
+                // Leeper(GH#1128)
+                if (pos >= 255)
+                    pos = 287;
 
-            setPdlPos(pos);
+                setPdlPos(pos);
+            }
         }
     }
 
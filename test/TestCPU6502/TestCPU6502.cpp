@@ -30,8 +30,11 @@ bool GetIsMemCacheValid(void)
 	return g_isMemCacheValid;
 }
 
+static UINT g_IO_F8xxAccesses = 0;
+
 BYTE __stdcall IO_F8xx(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nCycles)
 {
+	g_IO_F8xxAccesses++;
 	return 0;
 }
 
@@ -152,6 +155,43 @@ void NTSC_VideoUpdateCycles( long cycles6502 )
 #undef Cpu65C02
 #undef Fetch
 
+//-------
+
+// 6502 & no debugger & specialised at compile-time for the $F8xx & VidHD checks (see CPU.cpp)
+#define CPU_TEMPLATE_PARAMS template <bool kIoF8xx, bool kVidHD>
+#define READ(addr) _READ_SPECIALISED(addr)
+#define WRITE(value) _WRITE_SPECIALISED(value)
+
+#define Cpu6502 Cpu6502_specialised
+#include "../../source/CPU/cpu6502.h"  // MOS 6502
+#undef Cpu6502
+#undef CPU_TEMPLATE_PARAMS
+
+#undef HEATMAP_X
+
+//-------------------------------------
+
+#define HEATMAP_X(address) Heatmap_X(address)
+#include "../../source/CPU/cpu_heatmap.inl"
+
+// 6502 & debugger
+#define READ(addr) Heatmap_ReadByte_With_IO_F8xx(addr, uExecutedCycles)
+#define WRITE(value) Heatmap_WriteByte_With_IO_F8xx(addr, value, uExecutedCycles);
+
+#define Cpu6502 Cpu6502_debug
+#include "../../source/CPU/cpu6502.h"  // MOS 6502
+#undef Cpu6502
+
+//-------
+
+// 65C02 & debugger
+#define READ(addr) Heatmap_ReadByte(addr, uExecutedCycles)
+#define WRITE(value) Heatmap_WriteByte(addr, value, uExecutedCycles);
+
+#define Cpu65C02 Cpu65C02_debug
+#include "../../source/CPU/cpu65C02.h" // WDC 65C02
+#undef Cpu65C02
+
 #undef HEATMAP_X
 
 //-------------------------------------
@@ -187,20 +227,43 @@ void reset(void)
 
 //-------------------------------------
 
+// The CPU cores that CPU.cpp's InternalCpuExecute() can select (when the mem cache is valid)
+enum TestCore_e
+{
+	CORE_GENERIC,				// Cpu6502 (with IO_F8xx) / Cpu65C02
+	CORE_SPECIALISED,			// Cpu6502<false,false>: //e without VidHD
+	CORE_SPECIALISED_IO_F8xx,	// Cpu6502<true,false>:  II/II+ with a NSC
+	CORE_SPECIALISED_VIDHD,		// Cpu6502<true,true>:   VidHD
+	CORE_DEBUG,					// Cpu6502_debug / Cpu65C02_debug (heatmap)
+	NUM_TEST_CORES
+};
+
+static TestCore_e g_testCore = CORE_GENERIC;
+
 uint32_t TestCpu6502(uint32_t uTotalCycles)
 {
 	if (!GetIsMemCacheValid())
 		return Cpu6502_altRW(uTotalCycles, true);
-	else
-		return Cpu6502(uTotalCycles, true);
+
+	switch (g_testCore)
+	{
+	case CORE_SPECIALISED:			return Cpu6502_specialised<false, false>(uTotalCycles, true);
+	case CORE_SPECIALISED_IO_F8xx:	return Cpu6502_specialised<true, false>(uTotalCycles, true);
+	case CORE_SPECIALISED_VIDHD:	return Cpu6502_specialised<true, true>(uTotalCycles, true);
+	case CORE_DEBUG:				return Cpu6502_debug(uTotalCycles, true);
+	default:						return Cpu6502(uTotalCycles, true);
+	}
 }
 
 uint32_t TestCpu65C02(uint32_t uTotalCycles)
 {
 	if (!GetIsMemCacheValid())
 		return Cpu65C02_altRW(uTotalCycles, true);
-	else
-		return Cpu65C02(uTotalCycles, true);
+
+	if (g_testCore == CORE_DEBUG)
+		return Cpu65C02_debug(uTotalCycles, true);
+
+	return Cpu65C02(uTotalCycles, true);
 }
 
 //-------------------------------------
@@ -1421,6 +1484,60 @@ int SyncEvents_test(void)
 
 //-------------------------------------
 
+// Check that each Cpu6502<kIoF8xx,kVidHD> specialisation only routes the accesses it should
+int SpecialisedCore_test(void)
+{
+	if (!GetIsMemCacheValid())
+		return 0;	// altRW cores aren't specialised
+
+	// NB. the generic & debug cores always check both
+	const bool kIoF8xx = g_testCore != CORE_SPECIALISED;
+	const bool kVidHD = g_testCore != CORE_SPECIALISED && g_testCore != CORE_SPECIALISED_IO_F8xx;
+
+	// STA $F900 ; LDA $F900
+	reset();
+	regs.a = 0x11;
+	mem[0xF900] = 0x5A;
+	mem[regs.pc+0] = 0x8D;
+	mem[regs.pc+1] = 0x00;
+	mem[regs.pc+2] = 0xF9;
+	mem[regs.pc+3] = 0xAD;
+	mem[regs.pc+4] = 0x00;
+	mem[regs.pc+5] = 0xF9;
+
+	g_IO_F8xxAccesses = 0;
+	if (TestCpu6502(0) != 4) return 1;
+	if (g_IO_F8xxAccesses != (kIoF8xx ? 1 : 0)) return 1;
+	if (mem[0xF900] != (kIoF8xx ? 0x5A : 0x11)) return 1;
+
+	if (TestCpu6502(0) != 4) return 1;
+	if (g_IO_F8xxAccesses != (kIoF8xx ? 2 : 0)) return 1;
+	if (regs.a != (kIoF8xx ? 0x00 : 0x11)) return 1;	// IO_F8xx() stub returns 0
+
+	// STA $2000 (dual-write to VidHD's shadow memory)
+	BYTE* vidHD = (BYTE*) calloc(64, 1024);
+	memVidHD = vidHD;
+
+	reset();
+	regs.a = 0x22;
+	mem[regs.pc+0] = 0x8D;
+	mem[regs.pc+1] = 0x00;
+	mem[regs.pc+2] = 0x20;
+
+	const uint32_t cycles = TestCpu6502(0);
+	memVidHD = NULL;
+
+	const BYTE shadow = vidHD[0x2000];
+	free(vidHD);
+	if (cycles != 4) return 1;
+	if (mem[0x2000] != 0x22) return 1;
+	if (shadow != (kVidHD ? 0x22 : 0x00)) return 1;
+
+	return 0;
+}
+
+//-------------------------------------
+
 int DoTest(void)
 {
 	int res = 1;
@@ -1451,6 +1568,9 @@ int DoTest(void)
 	res = SyncEvents_test();
 	if (res) return res;
 
+	res = SpecialisedCore_test();
+	if (res) return res;
+
 	return res;
 }
 
@@ -1460,13 +1580,18 @@ int main(int argc, char* argv[])
 {
 	int res = 1;
 
-	g_isMemCacheValid = true;
-	res = DoTest();
-	if (res) return res;
+	for (UINT core = 0; core < NUM_TEST_CORES; core++)
+	{
+		g_testCore = (TestCore_e) core;
 
-	g_isMemCacheValid = false;
-	res = DoTest();
-	if (res) return res;
+		g_isMemCacheValid = true;
+		res = DoTest();
+		if (res) return res;
+
+		g_isMemCacheValid = false;
+		res = DoTest();
+		if (res) return res;
+	}
 
 	return 0;
 }
@@ -2,9 +2,15 @@
 
 #include "../../source/Windows/AppleWin.h"
 #include "../../source/CPU.h"
+#include "../../source/MemoryDefs.h"
 
 #include "../../source/Debugger/Debugger_Types.h"
 #include "../../source/Debugger/Debugger_Assembler.h"	// Pull in default args for _6502_GetTargets()
+#include "../../source/Debugger/Debugger_Console.h"
+#include "../../source/Debugger/Debugger_Help.h"
+#include "../../source/Debugger/Debugger_Symbols.h"
+#include "../../source/Debugger/Debugger_StepHistory.h"
+#include "../../source/Debugger/Util_MemoryTextFile.h"
 
 // From FrameBase
 class FrameBase
@@ -37,14 +43,46 @@ eCpuType GetMainCpu(void)
 }
 
 // From Memory.cpp
+LPBYTE         memwrite[0x100];
 LPBYTE         mem          = NULL;	// TODO: Init
 LPBYTE         memdirty     = NULL;	// TODO: Init
 
+uint8_t ReadByteFromMemory(uint16_t addr)
+{
+	return mem[addr];
+}
+
+uint16_t ReadWordFromMemory(uint16_t addr)
+{
+	return ReadByteFromMemory(addr) | (ReadByteFromMemory(addr + 1) << 8);
+}
+
+void WriteByteToMemory(uint16_t addr, uint8_t data)
+{
+	mem[addr] = data;
+}
+
+// From Core.cpp
+std::string g_sProgramDir;
+std::string g_sBuiltinSymbolsDir;
+
 //-------------------------------------
 
+// From Debug.cpp
+	int g_iCommand;
+	Command_t g_aParameters[1];
+
+Update_t DebuggerProcessCommand ( const bool bEchoConsoleInput )
+{
+	return 0;
+}
+
 // From Debugger_Console.cpp
 		char      g_aConsolePrompt[] = ">!"; // input, assembler // NUM_PROMPTS
 		char      g_sConsolePrompt[] = ">"; // No, NOT Integer Basic!  The nostalgic '*' "Monitor" doesn't look as good, IMHO. :-(
+		ConsoleOutputLevel_e g_eConsoleOutputLevel = ConsoleOutputLevel_e::CONSOLE_OUTPUT_LEVEL_NONE;
+		int       g_nConsoleInputChars = 0;
+		char *    g_pConsoleInput      = 0;
 
 Update_t ConsoleUpdate ()
 {
@@ -55,6 +93,21 @@ void ConsoleBufferPush ( const char * pText )
 {
 }
 
+void ConsolePrint ( const char * pText )
+{
+}
+
+Update_t ConsoleDisplayError ( const char * pTextError )
+{
+	return 0;
+}
+
+// From Debugger_Disassembler.cpp
+std::string FormatAddress ( WORD nAddress, int nBytes )
+{
+	return std::string();
+}
+
 // From Debugger_DisassemblerData.cpp
 DisasmData_t* Disassembly_IsDataAddress ( WORD nAddress )
 {
@@ -71,17 +124,44 @@ bool ArgsGetValue ( Arg_t *pArg, WORD * pAddressValue_, const int nBase )
 	return false;
 }
 
+int _Arg_Shift ( int iSrc, int iEnd, int iDst )
+{
+	return 0;
+}
+
+Update_t Help_Arg_1 ( int iCommandHelp )
+{
+	return 0;
+}
+
+// From Debugger_Help.cpp
+int FindParam ( LPCTSTR pLookupName, Match_e eMatch, int & iParam_, int iParamBegin, int iParamEnd, const bool bCaseSensitive )
+{
+	return 0;
+}
+
 // From Debugger_Symbols.cpp
-bool FindAddressFromSymbol ( const char* pSymbol, WORD * pAddress_, int * iTable_ )
+extern int g_bDisplaySymbolTables;
+
+// From Util_MemoryTextFile.cpp
+bool MemoryTextFile_t::Read ( const std::string & pFileName )
 {
 	return false;
 }
 
+void MemoryTextFile_t::GetLine ( const int iLine, char *pLine, const int n )
+{
+}
+
+void MemoryTextFile_t::GetLinePointers ()
+{
+}
+
 //-------------------------------------
 
 void init(void)
 {
-	mem = (LPBYTE)VirtualAlloc(NULL,128*1024,MEM_COMMIT,PAGE_READWRITE);	// alloc >64K to test wrap-around at 64K boundary
+	mem = (LPBYTE)calloc(128, 1024);	// alloc >64K to test wrap-around at 64K boundary
 }
 
 void reset(void)
@@ -380,8 +460,8 @@ int GH445_test_sub(bool bIs65C02)
 	//
 	// BRK
 
-	mem[_6502_BRK_VECTOR+0] = 0x40;		// BRK vector: $FA40
-	mem[_6502_BRK_VECTOR+1] = 0xFA;
+	mem[_6502_INTERRUPT_VECTOR+0] = 0x40;		// BRK vector: $FA40
+	mem[_6502_INTERRUPT_VECTOR+1] = 0xFA;
 
 	regs.pc = 0x300;
 	res = GH445_test_brk();
@@ -640,8 +720,8 @@ int GH451_test_sub(bool bIs65C02)
 	//
 	// BRK
 
-	mem[_6502_BRK_VECTOR+0] = 0x40;		// BRK vector: $FA40
-	mem[_6502_BRK_VECTOR+1] = 0xFA;
+	mem[_6502_INTERRUPT_VECTOR+0] = 0x40;		// BRK vector: $FA40
+	mem[_6502_INTERRUPT_VECTOR+1] = 0xFA;
 
 	res = GH451_test_brk();
 	if (res) return res;
@@ -707,6 +787,228 @@ int GH451_test(void)
 	return res;
 }
 
+//-------------------------------------
+// Symbol lookups (indexed)
+
+int Symbols_test_lookup(const char* pName, WORD nAddressExpected, int iTableExpected)
+{
+	WORD nAddress = 0;
+	int iTable = NUM_SYMBOL_TABLES;
+	if (!FindAddressFromSymbol(pName, &nAddress, &iTable)) return 1;
+	if (nAddress != nAddressExpected || iTable != iTableExpected) return 1;
+	return 0;
+}
+
+int Symbols_test(void)
+{
+	int res = 1;
+	SymbolsClear();
+
+	SymbolTableInsert(SYMBOLS_USER_1, 0x300, "START");
+	res = Symbols_test_lookup("start", 0x300, SYMBOLS_USER_1);	// case-insensitive
+	if (res) return res;
+
+	// Rename (duplicate address): the old name must go, in place
+	SymbolTableInsert(SYMBOLS_USER_1, 0x300, "BEGIN");
+	if (FindAddressFromSymbol("START")) return 1;
+	res = Symbols_test_lookup("BEGIN", 0x300, SYMBOLS_USER_1);
+	if (res) return res;
+	if (!FindSymbolFromAddress(0x300) || *FindSymbolFromAddress(0x300) != "BEGIN") return 1;
+
+	// Same name: highest table wins, then lowest address
+	SymbolTableInsert(SYMBOLS_MAIN, 0x400, "BEGIN");
+	res = Symbols_test_lookup("BEGIN", 0x300, SYMBOLS_USER_1);
+	if (res) return res;
+	SymbolTableInsert(SYMBOLS_USER_1, 0x200, "BEGIN");
+	res = Symbols_test_lookup("BEGIN", 0x200, SYMBOLS_USER_1);
+	if (res) return res;
+
+	SymbolTableErase(SYMBOLS_USER_1, 0x200);
+	SymbolTableErase(SYMBOLS_USER_1, 0x300);
+	res = Symbols_test_lookup("BEGIN", 0x400, SYMBOLS_MAIN);
+	if (res) return res;
+
+	// Same address: user table wins, and the other table is found again after removal
+	int iTable = NUM_SYMBOL_TABLES;
+	SymbolTableInsert(SYMBOLS_MAIN, 0x500, "ROMSYM");
+	SymbolTableInsert(SYMBOLS_USER_1, 0x500, "USERSYM");
+	std::string const* pSymbol = FindSymbolFromAddress(0x500, &iTable);
+	if (!pSymbol || *pSymbol != "USERSYM" || iTable != SYMBOLS_USER_1) return 1;
+	SymbolTableErase(SYMBOLS_USER_1, 0x500);
+	pSymbol = FindSymbolFromAddress(0x500, &iTable);
+	if (!pSymbol || *pSymbol != "ROMSYM" || iTable != SYMBOLS_MAIN) return 1;
+
+	// Nearest symbol at or below (profiler attribution)
+	WORD nSymbolAddress = 0;
+	pSymbol = FindSymbolAtOrBelowAddress(0x520, nSymbolAddress);
+	if (!pSymbol || *pSymbol != "ROMSYM" || nSymbolAddress != 0x500) return 1;
+	SymbolTableErase(SYMBOLS_MAIN, 0x500);
+	pSymbol = FindSymbolAtOrBelowAddress(0x520, nSymbolAddress);
+	if (!pSymbol || *pSymbol != "BEGIN" || nSymbolAddress != 0x400) return 1;
+	if (FindSymbolAtOrBelowAddress(0x3FF, nSymbolAddress)) return 1;
+
+	// Inactive table: not found until enabled
+	const int bDisplaySymbolTables = g_bDisplaySymbolTables;
+	g_bDisplaySymbolTables &= ~(1 << SYMBOLS_USER_2);
+	SymbolTableInsert(SYMBOLS_USER_2, 0x600, "HIDDEN");
+	if (FindAddressFromSymbol("HIDDEN") || FindSymbolFromAddress(0x600)) return 1;
+	g_bDisplaySymbolTables |= (1 << SYMBOLS_USER_2);
+	res = Symbols_test_lookup("HIDDEN", 0x600, SYMBOLS_USER_2);
+	if (res) return res;
+	g_bDisplaySymbolTables = bDisplaySymbolTables;
+
+	// Many renames of the same address (eg. a symbol file with duplicate addresses)
+	char szName[16];
+	for (int i = 0; i < 10000; i++)
+	{
+		sprintf(szName, "DUP%d", i);
+		SymbolTableInsert(SYMBOLS_USER_1, 0x700, szName);
+	}
+	if (FindAddressFromSymbol("DUP9998")) return 1;
+	res = Symbols_test_lookup("DUP9999", 0x700, SYMBOLS_USER_1);
+	if (res) return res;
+
+	SymbolsClear();
+	if (FindAddressFromSymbol("BEGIN") || FindSymbolFromAddress(0x400)) return 1;
+
+	return 0;
+}
+
+//-------------------------------------
+// Step history (TB/GB)
+
+void StepHistory_init(void)
+{
+	// RAM is writable, I/O & ROM are not (same as memwrite)
+	for (UINT page = 0; page < 0x100; page++)
+		memwrite[page] = (page < 0xC0) ? mem + (page << 8) : NULL;
+
+	StepHistoryClear();
+	reset();
+	regs.sp = 0x1FF;
+}
+
+int StepHistory_test_undo(void)
+{
+	StepHistory_init();
+
+	mem[0x2000] = 0x55;
+	mem[0x01FF] = 0xEE;
+
+	// 300: STA $2000 (A=$11)
+	mem[0x300] = 0x8D; mem[0x301] = 0x00; mem[0x302] = 0x20;
+	regs.a = 0x11;
+	if (StepHistoryRecord() != NO_6502_TARGET) return 1;
+	mem[0x2000] = regs.a;
+	regs.pc = 0x303;
+
+	// 303: PHA
+	mem[0x303] = 0x48;
+	StepHistoryRecord();
+	mem[0x01FF] = regs.a;
+	regs.sp = 0x1FE;
+	regs.pc = 0x304;
+
+	if (StepHistoryGetCount() != 2) return 1;
+
+	if (!StepHistoryUndo()) return 1;
+	if (regs.pc != 0x303 || regs.sp != 0x1FF || mem[0x01FF] != 0xEE) return 1;
+
+	if (!StepHistoryUndo()) return 1;
+	if (regs.pc != 0x300 || mem[0x2000] != 0x55) return 1;
+
+	if (StepHistoryUndo()) return 1;	// no more history
+	return 0;
+}
+
+int StepHistory_test_barrier(void)
+{
+	StepHistory_init();
+	LPBYTE aOldMemWrite[0x100];
+
+	// Interrupt: history is cleared
+	mem[0x300] = 0xEA;	// NOP
+	StepHistoryRecord();
+	StepHistoryCheckBarrier(true, NO_6502_TARGET, memwrite);
+	if (StepHistoryGetCount() != 0) return 1;
+
+	// Soft-switch that doesn't change paging: history is kept
+	mem[0x300] = 0xAD; mem[0x301] = 0x10; mem[0x302] = 0xC0;	// LDA $C010
+	int nIOAddress = StepHistoryRecord();
+	if (nIOAddress != 0xC010) return 1;
+	memcpy(aOldMemWrite, memwrite, sizeof(aOldMemWrite));
+	StepHistoryCheckBarrier(false, nIOAddress, aOldMemWrite);
+	if (StepHistoryGetCount() != 1) return 1;
+
+	// Soft-switch that changes paging: history is cleared
+	memwrite[0x20] = NULL;
+	StepHistoryCheckBarrier(false, nIOAddress, aOldMemWrite);
+	if (StepHistoryGetCount() != 0) return 1;
+	memwrite[0x20] = mem + 0x2000;
+
+	// Slot I/O (may DMA): history is cleared
+	mem[0x300] = 0xAD; mem[0x301] = 0xE8; mem[0x302] = 0xC0;	// LDA $C0E8
+	nIOAddress = StepHistoryRecord();
+	if (nIOAddress != 0xC0E8) return 1;
+	memcpy(aOldMemWrite, memwrite, sizeof(aOldMemWrite));
+	StepHistoryCheckBarrier(false, nIOAddress, aOldMemWrite);
+	if (StepHistoryGetCount() != 0) return 1;
+
+	// Ring buffer: only the most recent steps are kept
+	mem[0x300] = 0xEA;	// NOP
+	const int kMaxStepHistory = 0x4000;
+	for (int i = 0; i < kMaxStepHistory + 10; i++)
+		StepHistoryRecord();
+	if (StepHistoryGetCount() != kMaxStepHistory) return 1;
+
+	return 0;
+}
+
+int StepHistory_test(void)
+{
+	int res = 1;
+
+	res = StepHistory_test_undo();
+	if (res) return res;
+
+	res = StepHistory_test_barrier();
+	if (res) return res;
+
+	reset();
+	return 0;
+}
+
+//-------------------------------------
+// Profiler call stack
+
+int CallStack_test(void)
+{
+	reset();
+
+	// 300: JSR $0400
+	mem[0x300] = OPCODE_JSR; mem[0x301] = 0x00; mem[0x302] = 0x04;
+	// 410: JSR $0500
+	mem[0x410] = OPCODE_JSR; mem[0x411] = 0x00; mem[0x412] = 0x05;
+
+	// Stack: RTS addresses (PC+2) with a PHA'd byte on top
+	mem[0x1FF] = 0x03; mem[0x1FE] = 0x02;	// $0302 -> JSR at $0300
+	mem[0x1FD] = 0x04; mem[0x1FC] = 0x12;	// $0412 -> JSR at $0410
+	mem[0x1FB] = 0x99;						// not a return address
+	regs.sp = 0x1FA;
+
+	WORD aCallees[4];
+	int nDepth = _6502_GetCallStack(aCallees, 4);
+	if (nDepth != 2 || aCallees[0] != 0x0500 || aCallees[1] != 0x0400) return 1;
+
+	nDepth = _6502_GetCallStack(aCallees, 1);	// truncated to innermost
+	if (nDepth != 1 || aCallees[0] != 0x0500) return 1;
+
+	regs.sp = 0x1FF;	// empty stack
+	if (_6502_GetCallStack(aCallees, 4) != 0) return 1;
+
+	return 0;
+}
+
 //-------------------------------------
 
 int main(int argc, char* argv[])
@@ -721,5 +1023,14 @@ int main(int argc, char* argv[])
 	res = GH451_test();
 	if (res) return res;
 
+	res = Symbols_test();
+	if (res) return res;
+
+	res = StepHistory_test();
+	if (res) return res;
+
+	res = CallStack_test();
+	if (res) return res;
+
 	return 0;
 }
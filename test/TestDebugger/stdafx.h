@@ -5,6 +5,8 @@
 
 #pragma once
 
+#ifdef _WIN32
+
 #include <stdio.h>
 
 #include <windows.h>
@@ -20,6 +22,15 @@ typedef UINT64 uint64_t;
 
 #include <ddraw.h>
 
+#else
+
+#include <cstring>
+#include <cstdlib>
+#include "windows.h"
+#include <string>
+
+#endif
+
 #include <algorithm>
 #include <map>
 #include <vector>
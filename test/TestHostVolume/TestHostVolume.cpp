@@ -0,0 +1,255 @@
+#include "StdAfx.h"
+
+#include "ProDOS_HostVolume.h"
+#include "ProDOS_FileSystem.h"
+
+#include <filesystem>
+
+// Stubs
+void LogOutput(const char* format, ...)
+{
+}
+
+void LogFileOutput(const char* format, ...)
+{
+}
+
+//-------------------------------------
+
+static const std::string g_dir = "TestHostVol";
+static const UINT kBlockSize = 512;
+static const UINT kRootBlock = 2;
+static const UINT kEntryLen = 0x27;
+
+static std::string HostPath(const std::string& name)
+{
+	return g_dir + "/" + name;
+}
+
+static void WriteFile(const std::string& name, const std::string& data)
+{
+	FILE* hFile = fopen(HostPath(name).c_str(), "wb");
+	fwrite(data.data(), 1, data.size(), hFile);
+	fclose(hFile);
+}
+
+// Returns "<missing>" if the file doesn't exist
+static std::string ReadFile(const std::string& name)
+{
+	FILE* hFile = fopen(HostPath(name).c_str(), "rb");
+	if (!hFile)
+		return "<missing>";
+
+	std::string data;
+	char buffer[256];
+	size_t size;
+	while ((size = fread(buffer, 1, sizeof(buffer), hFile)) != 0)
+		data.append(buffer, size);
+
+	fclose(hFile);
+	return data;
+}
+
+static std::string MakeData(const UINT size)
+{
+	std::string data;
+	for (UINT i = 0; i < size; i++)
+		data += (char)(i * 7);
+	return data;
+}
+
+// HELLO (typed), README.TXT (sapling), SUB/A, and 1BAD (not a valid ProDOS name)
+static void MakeHostDir(void)
+{
+	std::filesystem::remove_all(g_dir);
+	std::filesystem::create_directories(HostPath("SUB"));
+
+	WriteFile("HELLO#062000", "ABC");
+	WriteFile("readme.txt", MakeData(600));
+	WriteFile("SUB/A", "sub");
+	WriteFile("1BAD", "bad");
+}
+
+// Returns the entry's byte offset in the directory's key block (or 0 if not found)
+static UINT FindEntry(ProDOS_HostVolume& volume, const UINT dirBlock, const char* name, ProDOS_FileHeader_t& file, BYTE* pBlock)
+{
+	volume.ReadBlock(dirBlock, pBlock);
+
+	for (UINT i = 1; i < kBlockSize / kEntryLen; i++)
+	{
+		ProDOS_GetFileHeader(pBlock, 4 + i * kEntryLen, &file);
+		if (file.kind != PRODOS_KIND_DEL && strcmp(file.name, name) == 0)
+			return 4 + i * kEntryLen;
+	}
+
+	return 0;
+}
+
+//-------------------------------------
+
+int DirParsing_test(void)
+{
+	MakeHostDir();
+
+	ProDOS_HostVolume volume(g_dir, NULL, false);
+	if (!volume.Open())
+		return 1;
+
+	BYTE block[kBlockSize];
+	volume.ReadBlock(kRootBlock, block);
+
+	// Volume header: name & file count (1BAD is skipped)
+	if ((block[4] >> 4) != PRODOS_KIND_ROOT || (block[4] & 0xF) != 11 || memcmp(&block[5], "TESTHOSTVOL", 11) != 0)
+		return 1;
+	if (ProDOS_Get16(block, 4 + 0x21) != 3)
+		return 1;
+
+	ProDOS_FileHeader_t file;
+	if (FindEntry(volume, kRootBlock, "1BAD", file, block))
+		return 1;
+
+	// Seedling, with its ProDOS type from the host name
+	if (!FindEntry(volume, kRootBlock, "HELLO", file, block))
+		return 1;
+	if (file.kind != PRODOS_KIND_SEED || file.type != 0x06 || file.aux != 0x2000 || file.size != 3)
+		return 1;
+	volume.ReadBlock(file.inode, block);
+	if (memcmp(block, "ABC", 3) != 0)
+		return 1;
+
+	// Sapling: index block -> 2 data blocks
+	if (!FindEntry(volume, kRootBlock, "README.TXT", file, block))
+		return 1;
+	if (file.kind != PRODOS_KIND_SAPL || file.type != 0x06 || file.size != 600 || file.blocks != 3)
+		return 1;
+	volume.ReadBlock(file.inode, block);
+	const UINT dataBlock1 = ProDOS_GetIndexBlock(block, 0, 1);
+	volume.ReadBlock(dataBlock1, block);
+	if (memcmp(block, MakeData(600).data() + kBlockSize, 600 - kBlockSize) != 0)
+		return 1;
+
+	// Sub-directory
+	if (!FindEntry(volume, kRootBlock, "SUB", file, block))
+		return 1;
+	if (file.kind != PRODOS_KIND_DIR)
+		return 1;
+	const UINT subBlock = file.inode;
+	volume.ReadBlock(subBlock, block);
+	if ((block[4] >> 4) != PRODOS_KIND_SUB || ProDOS_Get16(block, 4 + 0x21) != 1)
+		return 1;
+	if (!FindEntry(volume, subBlock, "A", file, block) || file.size != 3)
+		return 1;
+
+	// Read-only by default
+	if (volume.WriteBlock(subBlock, block))
+		return 1;
+	if (volume.IsSyncPending())
+		return 1;
+
+	return 0;
+}
+
+int WriteBack_test(void)
+{
+	MakeHostDir();
+
+	ProDOS_HostVolume volume(g_dir, NULL, true);
+	if (!volume.Open())
+		return 1;
+
+	BYTE block[kBlockSize];
+	ProDOS_FileHeader_t file;
+
+	// Data: only written back on Flush()
+	if (!FindEntry(volume, kRootBlock, "HELLO", file, block))
+		return 1;
+	memset(block, 0, sizeof(block));
+	memcpy(block, "XYZ", 3);
+	if (!volume.WriteBlock(file.inode, block))
+		return 1;
+	if (!volume.IsSyncPending() || ReadFile("HELLO#062000") != "ABC")
+		return 1;
+	if (!volume.Flush() || ReadFile("HELLO#062000") != "XYZ")
+		return 1;
+
+	// Rename
+	UINT offset = FindEntry(volume, kRootBlock, "README.TXT", file, block);
+	if (!offset)
+		return 1;
+	file.len = 5;
+	memset(file.name, 0, sizeof(file.name));
+	memcpy(file.name, "NOTES", 5);
+	memset(&block[offset], 0, kEntryLen);
+	ProDOS_PutFileHeader(block, offset, &file);
+	volume.WriteBlock(kRootBlock, block);
+	if (!volume.Flush())
+		return 1;
+	if (ReadFile("NOTES") != MakeData(600) || ReadFile("readme.txt") != "<missing>")
+		return 1;
+
+	// Delete: the host file is kept
+	if (!FindEntry(volume, kRootBlock, "SUB", file, block))
+		return 1;
+	const UINT subBlock = file.inode;
+	offset = FindEntry(volume, subBlock, "A", file, block);
+	if (!offset)
+		return 1;
+	block[offset] &= 0x0F;	// storage type = deleted
+	volume.WriteBlock(subBlock, block);
+	if (!volume.Flush() || ReadFile("SUB/A") != "sub")
+		return 1;
+
+	// Create: a new file, and one whose host name is already taken by a host file the volume doesn't know about
+	WriteFile("CLASH#040000", "host");
+
+	const UINT kFreeBlock = 0xF000;
+	memset(block, 0, sizeof(block));
+	memcpy(block, "new data", 8);
+	volume.WriteBlock(kFreeBlock, block);
+	volume.WriteBlock(kFreeBlock + 1, block);
+
+	volume.ReadBlock(kRootBlock, block);
+	const char* names[] = { "NEW", "CLASH" };
+	for (UINT i = 0; i < 2; i++)
+	{
+		memset(&file, 0, sizeof(file));
+		file.kind = PRODOS_KIND_SEED;
+		file.len = (BYTE)strlen(names[i]);
+		strcpy(file.name, names[i]);
+		file.type = 0x04;
+		file.inode = kFreeBlock + i;
+		file.blocks = 1;
+		file.size = 8;
+		ProDOS_PutFileHeader(block, 4 + (4 + i) * kEntryLen, &file);
+	}
+	volume.WriteBlock(kRootBlock, block);
+	if (!volume.Flush())
+		return 1;
+	if (ReadFile("NEW#040000") != "new data" || ReadFile("CLASH#040000") != "host")
+		return 1;
+
+	// No temp files left behind
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(g_dir))
+	{
+		if (entry.path().extension() == ".awtmp")
+			return 1;
+	}
+
+	return 0;
+}
+
+//-------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	res = DirParsing_test();
+	if (res) return res;
+
+	res = WriteBack_test();
+	if (res) return res;
+
+	std::filesystem::remove_all(g_dir);
+	return 0;
+}
@@ -0,0 +1,180 @@
+#include "StdAfx.h"
+
+#include "linux/inputrecorder.h"
+#include "linux/keyboardbuffer.h"
+
+#include "CPU.h"
+#include "Log.h"
+
+// From CPU.cpp
+SynchronousEventManager g_SynchronousEventMgr;
+unsigned __int64 g_nCumulativeCycles = 0;
+static ULONG g_nCyclesExecuted = 0;
+
+void CpuCalcCycles(ULONG nExecutedCycles)
+{
+	g_nCumulativeCycles += nExecutedCycles - g_nCyclesExecuted;
+	g_nCyclesExecuted = nExecutedCycles;
+}
+
+void SetIrqOnLastOpcodeCycle(void)
+{
+}
+
+// From Log.cpp
+void LogFileOutput(const char* format, ...)
+{
+}
+
+//-------------------------------------
+
+// Everything the guest sees: keys arriving in the keyboard buffer, and the values of polled devices
+struct GuestAccess
+{
+	enum Type_e {KEY, AXIS, BUTTON, CLOCK};
+
+	Type_e type;
+	unsigned __int64 cycle;
+	int value;
+
+	bool operator==(const GuestAccess& other) const
+	{
+		return type == other.type && cycle == other.cycle && value == other.value;
+	}
+};
+
+static std::vector<GuestAccess> g_guestAccesses;
+
+// From Keyboard.cpp
+void pushKeyToBuffer(BYTE key)
+{
+	GuestAccess access = {GuestAccess::KEY, g_nCumulativeCycles, key};
+	g_guestAccesses.push_back(access);
+}
+
+//-------------------------------------
+
+static const char* g_pathname = "TestInputRecorder.awir";
+static const unsigned __int64 kStartCycle = 123456;
+static const unsigned __int64 kEndCycle = kStartCycle + 2000000;
+
+static UINT NextRandom(UINT& seed)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 16;
+}
+
+// Run a fake CPU from kStartCycle to kEndCycle:
+// . the opcode boundaries & the cycles at which the guest polls the devices only depend on the absolute cycle (ie. deterministic emulation)
+// . the live input (keys, paddles, buttons) and the CPU batch sizes depend on /seed/
+static void RunSession(UINT seed)
+{
+	InputRecorder& recorder = InputRecorder::instance();
+
+	while (g_nCumulativeCycles < kEndCycle)
+	{
+		// Frontend: live key press between batches
+		if (NextRandom(seed) % 4 == 0)
+		{
+			const BYTE key = 'A' + NextRandom(seed) % 26;
+			if (recorder.filterKey(key))
+				pushKeyToBuffer(key);
+		}
+
+		const int livePaddle = NextRandom(seed) % 256;
+		const int liveButton = NextRandom(seed) % 2;
+
+		// CPU batch
+		const ULONG batchCycles = (ULONG)std::min<unsigned __int64>(1000 + NextRandom(seed) % 20000, kEndCycle - g_nCumulativeCycles);
+		const unsigned __int64 batchStart = g_nCumulativeCycles;
+		g_nCyclesExecuted = 0;
+
+		ULONG uExecutedCycles = 0;
+		while (uExecutedCycles < batchCycles)
+		{
+			// opcode: the guest may poll a device, then the sync events are updated at the end of the opcode
+			const unsigned __int64 now = batchStart + uExecutedCycles;
+			if (now % 97 < 7)
+			{
+				GuestAccess axis = {GuestAccess::AXIS, now, recorder.filterAxis(0, livePaddle, uExecutedCycles)};
+				g_guestAccesses.push_back(axis);
+				GuestAccess button = {GuestAccess::BUTTON, now, recorder.filterButton(0, liveButton, uExecutedCycles)};
+				g_guestAccesses.push_back(button);
+			}
+
+			if (now % 50021 < 7)
+			{
+				SYSTEMTIME t;
+				GetLocalTime(&t);
+				GuestAccess clock = {GuestAccess::CLOCK, now, t.wSecond * 1000 + t.wMilliseconds};
+				g_guestAccesses.push_back(clock);
+			}
+
+			uExecutedCycles += 2 + (ULONG)(now % 5);
+
+			if (uExecutedCycles >= g_SynchronousEventMgr.GetNextEventCycles())
+				g_SynchronousEventMgr.Update(0, uExecutedCycles);
+		}
+
+		g_SynchronousEventMgr.EndExecute(uExecutedCycles);
+		g_nCumulativeCycles += uExecutedCycles - g_nCyclesExecuted;
+	}
+}
+
+static void ResetMachine(void)
+{
+	g_SynchronousEventMgr.Reset();
+	g_nCumulativeCycles = kStartCycle;
+	g_guestAccesses.clear();
+}
+
+//-------------------------------------
+
+// Record a session, then replay it with different live input and different CPU batch sizes: the guest must see exactly the same
+int RecordReplay_test(void)
+{
+	InputRecorder& recorder = InputRecorder::instance();
+
+	ResetMachine();
+	recorder.startRecording(g_pathname);
+	RunSession(1);
+	recorder.stop();
+	const std::vector<GuestAccess> recorded = g_guestAccesses;
+
+	UINT keys = 0;
+	for (size_t i = 0; i < recorded.size(); i++)
+		if (recorded[i].type == GuestAccess::KEY)
+			keys++;
+	if (keys == 0)
+		return 1;
+
+	ResetMachine();
+	recorder.startReplay(g_pathname);
+	RunSession(2);
+	recorder.stop();
+	const std::vector<GuestAccess>& replayed = g_guestAccesses;
+
+	if (replayed.size() != recorded.size())
+		return 1;
+
+	for (size_t i = 0; i < recorded.size(); i++)
+	{
+		if (!(replayed[i] == recorded[i]))
+			return 1;
+	}
+
+	return 0;
+}
+
+//-------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	res = RecordReplay_test();
+	if (res) return res;
+
+	remove(g_pathname);
+	return 0;
+}
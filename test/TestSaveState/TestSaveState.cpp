@@ -0,0 +1,174 @@
+#include "StdAfx.h"
+
+#include "YamlHelper.h"
+
+// Stubs
+void LogOutput(const char* format, ...)
+{
+}
+
+void LogFileOutput(const char* format, ...)
+{
+}
+
+//-------------------------------------
+
+static const char* g_pathname = "TestSaveState.aws.yaml";
+static const UINT kMemSize = 64*1024;
+
+static BYTE g_memCompressible[kMemSize];
+static BYTE g_memHexOnly[256];
+
+static void InitMemory(void)
+{
+	// Mix of runs (compress well) and pseudo-random data (doesn't)
+	UINT seed = 0x12345678;
+	for (UINT i = 0; i < kMemSize; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		g_memCompressible[i] = (i < 0x4000) ? (BYTE)(seed >> 16) : (i < 0x8000) ? 0xA0 : (BYTE)i;
+	}
+
+	for (UINT i = 0; i < sizeof(g_memHexOnly); i++)
+		g_memHexOnly[i] = (BYTE)(i ^ 0x5A);
+}
+
+static void SaveTestState(const bool compressMemory)
+{
+	YamlSaveHelper yamlSaveHelper(g_pathname);
+	yamlSaveHelper.SetCompressMemory(compressMemory);
+	yamlSaveHelper.FileHdr(2);
+
+	yamlSaveHelper.UnitHdr("Test", 1);
+	YamlSaveHelper::Label unit(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
+	{
+		YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", "Compressible");
+		yamlSaveHelper.SaveMemory(g_memCompressible, kMemSize, 0, true);
+	}
+	{
+		YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", "Hex Only");
+		yamlSaveHelper.SaveMemory(g_memHexOnly, sizeof(g_memHexOnly));
+	}
+}
+
+// Returns 0 on success
+static int LoadTestState(BYTE* pMemCompressible, BYTE* pMemHexOnly, const bool allowCompressed)
+{
+	YamlHelper yamlHelper;
+	if (!yamlHelper.InitParser(g_pathname))
+		return 1;
+
+	if (yamlHelper.ParseFileHdr(SS_YAML_VALUE_AWSS) != 2)
+		return 1;
+
+	std::string scalar;
+	if (!yamlHelper.GetScalar(scalar) || scalar != SS_YAML_KEY_UNIT)
+		return 1;
+
+	yamlHelper.GetMapStartEvent();
+	YamlLoadHelper yamlLoadHelper(yamlHelper);
+
+	if (yamlLoadHelper.LoadString(SS_YAML_KEY_TYPE) != "Test")
+		return 1;
+	if (!yamlLoadHelper.GetSubMap(SS_YAML_KEY_STATE))
+		return 1;
+
+	if (!yamlLoadHelper.GetSubMap("Compressible"))
+		return 1;
+	yamlLoadHelper.LoadMemory(pMemCompressible, kMemSize, 0, allowCompressed);
+	yamlLoadHelper.PopMap();
+
+	if (!yamlLoadHelper.GetSubMap("Hex Only"))
+		return 1;
+	yamlLoadHelper.LoadMemory(pMemHexOnly, sizeof(g_memHexOnly));
+	yamlLoadHelper.PopMap();
+
+	yamlLoadHelper.PopMap();
+	return 0;
+}
+
+static bool IsFileCompressed(void)
+{
+	FILE* hFile = fopen(g_pathname, "r");
+	if (!hFile)
+		return false;
+
+	bool res = false;
+	char line[256];
+	while (fgets(line, sizeof(line), hFile))
+	{
+		const char* p = line;
+		while (*p == ' ') p++;
+		if (p[0] == SS_YAML_MEMORY_COMPRESSED_PREFIX)
+			res = true;
+	}
+
+	fclose(hFile);
+	return res;
+}
+
+//-------------------------------------
+
+// Save & load, both as hex and compressed: memory must round-trip exactly, and only a unit that allows it is compressed
+int RoundTrip_test(void)
+{
+	for (int compress = 0; compress <= 1; compress++)
+	{
+		SaveTestState(compress != 0);
+		if (IsFileCompressed() != (compress != 0))
+			return 1;
+
+		static BYTE memCompressible[kMemSize];
+		static BYTE memHexOnly[sizeof(g_memHexOnly)];
+		memset(memCompressible, 0, sizeof(memCompressible));
+		memset(memHexOnly, 0, sizeof(memHexOnly));
+
+		if (LoadTestState(memCompressible, memHexOnly, true))
+			return 1;
+
+		if (memcmp(memCompressible, g_memCompressible, kMemSize) != 0)
+			return 1;
+		if (memcmp(memHexOnly, g_memHexOnly, sizeof(g_memHexOnly)) != 0)
+			return 1;
+	}
+
+	return 0;
+}
+
+// A compressed block in a unit (version) that doesn't support it must be rejected
+int CompressedNotAllowed_test(void)
+{
+	SaveTestState(true);
+
+	static BYTE memCompressible[kMemSize];
+	static BYTE memHexOnly[sizeof(g_memHexOnly)];
+
+	try
+	{
+		LoadTestState(memCompressible, memHexOnly, false);
+	}
+	catch (const std::exception&)
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+//-------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	InitMemory();
+
+	res = RoundTrip_test();
+	if (res) return res;
+
+	res = CompressedNotAllowed_test();
+	if (res) return res;
+
+	remove(g_pathname);
+	return 0;
+}